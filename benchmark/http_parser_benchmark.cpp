@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include "HttpParser.hpp"
+#include "HttpRequestParser.hpp"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// 典型的浏览器请求，带十几个请求头
+std::string makeRequest() {
+    return "GET /static/app.js?v=42 HTTP/1.1\r\n"
+           "Host: www.example.com\r\n"
+           "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+           "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+           "Accept-Language: en-US,en;q=0.9\r\n"
+           "Accept-Encoding: gzip, deflate, br\r\n"
+           "Referer: https://www.example.com/index.html\r\n"
+           "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark; lang=en\r\n"
+           "Cache-Control: no-cache\r\n"
+           "Pragma: no-cache\r\n"
+           "Sec-Fetch-Dest: script\r\n"
+           "Sec-Fetch-Mode: no-cors\r\n"
+           "Sec-Fetch-Site: same-origin\r\n"
+           "Connection: keep-alive\r\n"
+           "\r\n";
+}
+
+} // namespace
+
+// 原有解析器：逐行复制出HttpRequest对象
+static void BM_HttpParserLegacy(benchmark::State& state) {
+    std::string request = makeRequest();
+    for (auto _ : state) {
+        webserver::HttpRequest parsed = webserver::HttpParser::parseRequestToObject(request);
+        benchmark::DoNotOptimize(parsed);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(request.size()));
+}
+BENCHMARK(BM_HttpParserLegacy);
+
+// 增量解析器：一次扫描，请求行和请求头只记录视图
+static void BM_HttpRequestParser(benchmark::State& state) {
+    std::string request = makeRequest();
+    webserver::HttpRequestParser parser;
+    for (auto _ : state) {
+        parser.reset();
+        auto status = parser.parse(request);
+        benchmark::DoNotOptimize(status);
+        benchmark::DoNotOptimize(parser.request().headers.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(request.size()));
+}
+BENCHMARK(BM_HttpRequestParser);
+
+// 请求被拆成state.range(0)字节的小段陆续到达
+static void BM_HttpRequestParserSplit(benchmark::State& state) {
+    std::string request = makeRequest();
+    size_t step = static_cast<size_t>(state.range(0));
+    webserver::HttpRequestParser parser;
+    for (auto _ : state) {
+        parser.reset();
+        auto status = webserver::HttpRequestParser::Status::INCOMPLETE;
+        for (size_t end = step; status == webserver::HttpRequestParser::Status::INCOMPLETE; end += step) {
+            status = parser.parse(std::string_view(request).substr(0, std::min(end, request.size())));
+        }
+        benchmark::DoNotOptimize(status);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(request.size()));
+}
+BENCHMARK(BM_HttpRequestParserSplit)
+    ->Arg(16)
+    ->Arg(128);
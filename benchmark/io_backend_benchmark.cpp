@@ -0,0 +1,364 @@
+#include <benchmark/benchmark.h>
+#include "WebServer.hpp"
+#include "Config.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// 获取一个当前空闲的端口
+int findFreePort() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+int connectTo(int port) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+
+int connectUnix(const std::string& path) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+
+// 读取一个完整的响应（依据Content-Length），失败返回false
+bool readResponse(int fd, std::string& pending) {
+    char buffer[4096];
+    while (true) {
+        size_t headerEnd = pending.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            size_t bodyLength = 0;
+            size_t pos = pending.find("Content-Length: ");
+            if (pos != std::string::npos && pos < headerEnd) {
+                bodyLength = std::stoul(pending.substr(pos + 16));
+            }
+            size_t total = headerEnd + 4 + bodyLength;
+            if (pending.size() >= total) {
+                pending.erase(0, total);
+                return true;
+            }
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return false;
+        }
+        pending.append(buffer, static_cast<size_t>(n));
+    }
+}
+
+} // namespace
+
+// 比较epoll与io_uring后端：单个保活连接上逐个发送请求，统计p99延迟和每个请求的系统调用数
+static void BM_IoBackendKeepAliveRequest(benchmark::State& state) {
+    webserver::Logger::getInstance().setConsoleOutput(false);
+
+    int port = findFreePort();
+    webserver::Config config;
+    config.set<int>("port", port);
+    config.set<int>("server.reactor_count", 1);
+    config.set<int>("server.max_requests_per_connection", 1 << 30);
+    config.set<std::string>("server.io_backend", state.range(0) == 0 ? "epoll" : "io_uring");
+
+    webserver::WebServer server(config);
+    if (state.range(0) == 1 && !server.isIoUringEnabled()) {
+        state.SkipWithError("io_uring is not available on this kernel");
+        return;
+    }
+    std::thread serverThread([&server]() { server.start(); });
+
+    int fd = connectTo(port);
+    if (fd == -1) {
+        state.SkipWithError("failed to connect to server");
+        server.stop();
+        serverThread.join();
+        return;
+    }
+
+    const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    std::string pending;
+    std::vector<double> latencies;
+    webserver::WebServer::IoStats before = server.getIoStats();
+
+    for (auto _ : state) {
+        auto begin = std::chrono::steady_clock::now();
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()) ||
+            !readResponse(fd, pending)) {
+            state.SkipWithError("request failed");
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - begin).count());
+    }
+
+    webserver::WebServer::IoStats after = server.getIoStats();
+    close(fd);
+    server.stop();
+    serverThread.join();
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+        uint64_t requests = after.requests - before.requests;
+        if (requests > 0) {
+            state.counters["syscalls_per_request"] =
+                static_cast<double>(after.syscalls - before.syscalls) / static_cast<double>(requests);
+        }
+    }
+}
+BENCHMARK(BM_IoBackendKeepAliveRequest)
+    ->Arg(0)    // epoll
+    ->Arg(1)    // io_uring
+    ->UseRealTime();
+
+// 比较本机代理常用的两种传输：TCP回环与Unix域套接字，单个保活连接上逐个发送请求
+static void BM_TransportKeepAliveRequest(benchmark::State& state) {
+    webserver::Logger::getInstance().setConsoleOutput(false);
+
+    int port = findFreePort();
+    std::string socketPath = "/tmp/webserver_benchmark_" + std::to_string(getpid()) + ".sock";
+    webserver::Config config;
+    config.set<int>("port", port);
+    config.set<int>("server.reactor_count", 1);
+    config.set<int>("server.max_requests_per_connection", 1 << 30);
+    config.set<nlohmann::json>("server.listeners", nlohmann::json::array({
+        {{"type", "tcp"}, {"address", "127.0.0.1"}, {"port", port}},
+        {{"type", "unix"}, {"path", socketPath}},
+    }));
+
+    webserver::WebServer server(config);
+    std::thread serverThread([&server]() { server.start(); });
+
+    int fd = state.range(0) == 0 ? connectTo(port) : connectUnix(socketPath);
+    if (fd == -1) {
+        state.SkipWithError("failed to connect to server");
+        server.stop();
+        serverThread.join();
+        return;
+    }
+
+    const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    std::string pending;
+    std::vector<double> latencies;
+    for (auto _ : state) {
+        auto begin = std::chrono::steady_clock::now();
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()) ||
+            !readResponse(fd, pending)) {
+            state.SkipWithError("request failed");
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - begin).count());
+    }
+
+    close(fd);
+    server.stop();
+    serverThread.join();
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_us"] = latencies[latencies.size() / 2];
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+    }
+}
+BENCHMARK(BM_TransportKeepAliveRequest)
+    ->Arg(0)    // TCP回环
+    ->Arg(1)    // Unix域套接字
+    ->UseRealTime();
+
+// 比较发送策略：保活连接上逐个获取一个静态文件（响应头sendmsg + sendfile，末尾是不满一个报文的尾部），
+// 开启Nagle时尾部要等前面报文的ACK，客户端延迟ACK会使请求出现数十毫秒的停顿
+static void BM_SendPolicyKeepAliveRequest(benchmark::State& state) {
+    webserver::Logger::getInstance().setConsoleOutput(false);
+
+    char rootTemplate[] = "/tmp/webserver_benchmark_XXXXXX";
+    if (mkdtemp(rootTemplate) == nullptr) {
+        state.SkipWithError("failed to create static root");
+        return;
+    }
+    std::string root = rootTemplate;
+    {
+        std::ofstream file(root + "/file.bin", std::ios::binary);
+        file << std::string(64 * 1024 + 100, 'x');
+    }
+
+    int port = findFreePort();
+    webserver::Config config;
+    config.set<int>("port", port);
+    config.set<int>("server.reactor_count", 1);
+    config.set<int>("server.max_requests_per_connection", 1 << 30);
+    config.set<std::string>("server.static_root", root);
+    config.set<bool>("server.tcp_nodelay", state.range(0) >= 1);
+    config.set<bool>("server.tcp_cork", state.range(0) >= 2);
+
+    webserver::WebServer server(config);
+    std::thread serverThread([&server]() { server.start(); });
+
+    int fd = connectTo(port);
+    if (fd == -1) {
+        state.SkipWithError("failed to connect to server");
+        server.stop();
+        serverThread.join();
+        std::filesystem::remove_all(root);
+        return;
+    }
+
+    const std::string request = "GET /static/file.bin HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    std::string pending;
+    std::vector<double> latencies;
+    for (auto _ : state) {
+        auto begin = std::chrono::steady_clock::now();
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()) ||
+            !readResponse(fd, pending)) {
+            state.SkipWithError("request failed");
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - begin).count());
+    }
+
+    close(fd);
+    server.stop();
+    serverThread.join();
+    std::filesystem::remove_all(root);
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_us"] = latencies[latencies.size() / 2];
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+    }
+}
+BENCHMARK(BM_SendPolicyKeepAliveRequest)
+    ->Arg(0)    // 默认套接字选项（Nagle开启）
+    ->Arg(1)    // TCP_NODELAY
+    ->Arg(2)    // TCP_NODELAY + TCP_CORK
+    ->UseRealTime();
+
+// 混合客户端：批量客户端不断一次发出256个流水线请求，交互客户端在同一Reactor上逐个发送请求，
+// 比较每轮处理预算对交互请求尾延迟的影响（0表示不限制）
+static void BM_MixedClientFairness(benchmark::State& state) {
+    webserver::Logger::getInstance().setConsoleOutput(false);
+
+    int port = findFreePort();
+    webserver::Config config;
+    config.set<int>("port", port);
+    config.set<int>("server.reactor_count", 1);
+    config.set<int>("server.max_requests_per_connection", 1 << 30);
+    config.set<int>("server.fairness_max_requests", static_cast<int>(state.range(0)));
+
+    webserver::WebServer server(config);
+    // 每个请求约几十微秒的处理时间，批量请求的排队时间才可观
+    server.addRoute("/work", [](const std::map<std::string, std::string>&, const std::string&) {
+        uint64_t value = 0;
+        for (int i = 0; i < 20000; ++i) {
+            value = value * 31 + static_cast<uint64_t>(i);
+        }
+        benchmark::DoNotOptimize(value);
+        return std::string("done");
+    });
+    std::thread serverThread([&server]() { server.start(); });
+
+    int batchFd = connectTo(port);
+    int fd = connectTo(port);
+    if (batchFd == -1 || fd == -1) {
+        state.SkipWithError("failed to connect to server");
+        server.stop();
+        serverThread.join();
+        return;
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread batchClient([batchFd, &stop]() {
+        std::string batch;
+        for (int i = 0; i < 256; ++i) {
+            batch += "GET /work HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        }
+        std::string pending;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (send(batchFd, batch.data(), batch.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(batch.size())) {
+                return;
+            }
+            for (int i = 0; i < 256; ++i) {
+                if (!readResponse(batchFd, pending)) {
+                    return;
+                }
+            }
+        }
+    });
+
+    const std::string request = "GET /work HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    std::string pending;
+    std::vector<double> latencies;
+    for (auto _ : state) {
+        auto begin = std::chrono::steady_clock::now();
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()) ||
+            !readResponse(fd, pending)) {
+            state.SkipWithError("request failed");
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - begin).count());
+    }
+
+    webserver::WebServer::IoStats stats = server.getIoStats();
+    stop = true;
+    shutdown(batchFd, SHUT_RDWR);
+    batchClient.join();
+    close(batchFd);
+    close(fd);
+    server.stop();
+    serverThread.join();
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_us"] = latencies[latencies.size() / 2];
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+        state.counters["yields"] = static_cast<double>(stats.fairnessYields);
+    }
+}
+BENCHMARK(BM_MixedClientFairness)
+    ->Arg(0)    // 不限制
+    ->Arg(16)   // 每轮最多16个请求
+    ->UseRealTime();
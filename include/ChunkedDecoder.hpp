@@ -0,0 +1,143 @@
+#ifndef WEBSERVER_CHUNKED_DECODER_HPP
+#define WEBSERVER_CHUNKED_DECODER_HPP
+
+#include <cstddef>
+#include <string_view>
+#include "http/HttpHeaders.hpp"
+
+namespace webserver {
+
+/**
+ * @class ChunkedDecoder
+ * @brief 流式的分块传输编码（Transfer-Encoding: chunked）解码器
+ *
+ * 输入可以在任意位置被切开：不完整的块大小行或尾部字段行不会被消费，调用者在下一批数据到达后
+ * 从未消费的位置重新传入即可，已经检查过的字节不会被重复扫描。块数据一到达就以指向输入的视图交出，
+ * 解码过程本身不复制、不分配内存（尾部字段除外）。
+ */
+class ChunkedDecoder {
+public:
+    /**
+     * @enum Status
+     * @brief decode()的结果
+     */
+    enum class Status {
+        NEED_MORE,    ///< 输入已用完，等待更多数据
+        DATA,         ///< 交出了一段解码后的数据
+        DONE,         ///< 最后一个块和尾部字段都已读完
+        ERROR         ///< 编码非法或超出限制，通过error()获取原因
+    };
+
+    /**
+     * @enum Error
+     * @brief 解码错误
+     */
+    enum class Error {
+        NONE,
+        BAD_CHUNK,             ///< 块大小行或块结尾格式错误
+        BAD_TRAILER,           ///< 尾部字段格式错误
+        BODY_TOO_LARGE,        ///< 解码后的数据超过大小上限
+        TRAILER_TOO_LARGE      ///< 尾部字段总大小或数量超过上限
+    };
+
+    /**
+     * @struct Limits
+     * @brief 解码限制
+     */
+    struct Limits {
+        size_t maxBodySize = 8 * 1024 * 1024;     // 解码后数据的字节数上限
+        size_t maxTrailerBytes = 65536;           // 尾部字段的总字节数上限
+        size_t maxTrailers = 100;                 // 尾部字段数量上限
+    };
+
+    /**
+     * @brief 使用默认限制构造
+     */
+    ChunkedDecoder();
+
+    /**
+     * @brief 构造函数
+     * @param limits 解码限制
+     */
+    explicit ChunkedDecoder(const Limits& limits);
+
+    /**
+     * @brief 从data开头继续解码，每次最多交出一段数据
+     *
+     * 返回DATA后应该从data + consumed继续调用；返回NEED_MORE时，未消费的字节必须在下次调用时
+     * 作为新数据的开头重新传入。
+     *
+     * @param data 尚未消费的编码数据
+     * @param consumed 输出本次消费的字节数
+     * @param chunk 返回DATA时输出解码后的数据，指向data
+     * @return 解码状态
+     */
+    Status decode(std::string_view data, size_t& consumed, std::string_view& chunk);
+
+    /**
+     * @brief 获取解码错误
+     */
+    Error error() const { return error_; }
+
+    /**
+     * @brief 是否已经读完最后一个块和尾部字段
+     */
+    bool done() const { return state_ == State::DONE; }
+
+    /**
+     * @brief 获取目前为止解码出的字节数
+     */
+    size_t decodedSize() const { return decoded_; }
+
+    /**
+     * @brief 获取尾部字段，DONE之后完整
+     */
+    const HttpHeaders& trailers() const { return trailers_; }
+
+    /**
+     * @brief 修改解码后数据的字节数上限
+     */
+    void setMaxBodySize(size_t size) { limits_.maxBodySize = size; }
+
+    /**
+     * @brief 丢弃状态，准备解码下一个请求体
+     */
+    void reset();
+
+private:
+    enum class State {
+        SIZE,
+        DATA,
+        DATA_END,
+        TRAILERS,
+        DONE,
+        ERROR
+    };
+
+    /**
+     * @brief 从start开始查找下一行
+     * @param data 输入数据
+     * @param start 行的开始位置
+     * @param lineEnd 输出行内容的结束位置（不含CRLF）
+     * @param next 输出下一行的开始位置
+     * @return 找到完整的一行返回true
+     */
+    bool nextLine(std::string_view data, size_t start, size_t& lineEnd, size_t& next);
+
+    bool parseSize(std::string_view line);
+    bool parseTrailer(std::string_view line);
+    Status fail(Error error);
+
+    Limits limits_;
+    State state_ = State::SIZE;
+    Error error_ = Error::NONE;
+    size_t chunkRemaining_ = 0;                   // 当前块中尚未交出的字节数
+    size_t decoded_ = 0;                          // 已交出的字节数
+    size_t trailerBytes_ = 0;                     // 已读取的尾部字段字节数
+    size_t scanned_ = 0;                          // 未消费的行中已确认不含换行的字节数
+    HttpHeaders trailers_;
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_CHUNKED_DECODER_HPP
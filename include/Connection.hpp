@@ -0,0 +1,123 @@
+#ifndef WEBSERVER_CONNECTION_HPP
+#define WEBSERVER_CONNECTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <openssl/ssl.h>
+#include "HttpRequestParser.hpp"
+#include "IpAddress.hpp"
+#include "OutputQueue.hpp"
+#include "Router.hpp"
+#include "SpooledBody.hpp"
+#include "TimingWheel.hpp"
+
+
+namespace webserver {
+
+struct Reactor;
+
+// 一次sendmsg最多聚集的内存段数，足够容纳一批流水线请求的响应头和内容
+constexpr size_t kMaxSendSegments = 64;
+
+/**
+ * @enum ConnectionState
+ * @brief 单个客户端连接在事件循环中的状态
+ */
+enum class ConnectionState {
+    HANDSHAKE,   ///< 正在进行TLS握手
+    READING,     ///< 等待或读取请求（读取 -> 解析 -> 路由）
+    PROCESSING,  ///< 请求已交给工作线程处理，等待结果
+    WRITING,     ///< 响应发送完后需关闭，或输出积压超过高水位，暂停处理请求直到发送完或回落到低水位
+    CLOSED       ///< 连接已关闭
+};
+
+/**
+ * @enum TimerPhase
+ * @brief 连接超时定时器所处的阶段，每个阶段有各自的时限
+ */
+enum class TimerPhase {
+    NONE,        ///< 尚未设置定时器，或刚处理完一个请求
+    HANDSHAKE,   ///< TLS握手，从连接建立起计算总时限
+    IDLE,        ///< 新连接等待第一个请求
+    KEEP_ALIVE,  ///< 保活连接等待下一个请求
+    HEADERS,     ///< 读取请求行和请求头，从第一个字节起计算总时限
+    BODY,        ///< 读取请求体，总时限随已收到的字节数按最低速率延长
+    PROCESSING,  ///< 等待工作线程处理
+    DRAIN        ///< 发送响应，总时限随已发送的字节数按最低速率延长
+};
+
+/**
+ * @struct ZeroCopySend
+ * @brief 一次MSG_ZEROCOPY发送引用的缓冲区，收到内核的完成通知前不能释放
+ */
+struct ZeroCopySend {
+    uint32_t id = 0;                                  // 内核为该套接字的零拷贝发送依次分配的序号
+    std::vector<std::shared_ptr<const void>> owners;  // 发送涉及的内存段的所有者
+};
+
+/**
+ * @struct RingSend
+ * @brief io_uring后端一次sendmsg请求的参数，内核完成前必须保持有效
+ *
+ * 只在请求进行期间由连接从所属Reactor借用，epoll连接和空闲连接不为它占用内存。
+ */
+struct RingSend {
+    struct iovec iov[kMaxSendSegments];           // 正在由内核发送的内存段，发送完成前不能修改
+    struct msghdr message{};                      // 引用iov的sendmsg参数
+};
+
+/**
+ * @struct Connection
+ * @brief 由所属Reactor独占的连接上下文，只在该Reactor的事件循环线程中访问
+ */
+struct Connection {
+    int fd = -1;                                  // 客户端套接字
+    Reactor* reactor = nullptr;                   // 拥有该连接的Reactor
+    uint64_t id = 0;                              // 连接序号，用于校验异步回调是否仍指向同一连接
+    IpAddress clientAddress;                      // 客户端地址
+    SSL* ssl = nullptr;                           // TLS会话（未启用HTTPS时为空）
+    ConnectionState state = ConnectionState::READING;
+
+    std::string inputBuffer;                      // 已读取但尚未处理的数据，从当前请求的第一个字节开始
+    HttpRequestParser parser;                     // 当前请求的解析状态，跨多次读取保留
+    std::shared_ptr<SpooledBody> spooledBody;     // 上传路由的请求体，请求完成后交给处理函数
+    std::unique_ptr<BodyConsumer> bodyConsumer;   // 流式路由接收请求体的对象
+    OutputQueue output;                           // 待发送的响应（响应头、内容和文件段）
+
+    int requestCount = 0;                         // 已处理的请求数
+    bool keepAlive = false;                       // 当前请求是否要求保持连接
+    bool closeAfterWrite = false;                 // 响应发送完毕后关闭连接
+    bool peerClosed = false;                      // 对端已关闭写方向
+    bool readPaused = false;                      // 输出积压超过高水位，暂停读取直到回落到低水位
+    bool batchingOutput = false;                  // 正在处理一批流水线请求，响应留到批次结束后一起发送
+    bool yielded = false;                         // 本轮处理预算已用完，剩余请求等待排队的续处理
+    bool tcp = false;                             // TCP连接（Unix域套接字不支持TCP_CORK）
+    bool corked = false;                          // 当前flush设置了TCP_CORK，结束时解除
+    bool zeroCopyEnabled = false;                 // 已设置SO_ZEROCOPY
+    bool zeroCopyDisabled = false;                // 内核不支持或已回退为复制，之后不再使用零拷贝
+    uint32_t zeroCopyNext = 0;                    // 下一次零拷贝发送的序号
+    std::vector<ZeroCopySend> zeroCopyPending;    // 尚未收到完成通知的零拷贝发送，按序号排列
+    size_t parkedBytes = 0;                       // 空闲保活期间计入Reactor统计的内存，0表示连接不在空闲状态
+
+    TimerNode timer;                              // 当前阶段的超时定时器，挂在所属Reactor的时间轮上
+    TimerPhase timerPhase = TimerPhase::NONE;     // 定时器当前所处的阶段
+    uint64_t phaseStartTick = 0;                  // 进入当前阶段时的tick
+    uint64_t phaseBytes = 0;                      // 当前阶段收到或发出的字节数，用于最低速率检查
+
+    // 以下字段只在io_uring后端中使用
+    int ringSlot = -1;                            // 固定文件表中的下标，-1表示连接使用epoll后端
+    int pendingOps = 0;                           // 尚未完成的io_uring请求数，为0后才能释放连接
+    bool recvArmed = false;                       // 多发recv是否仍在进行
+    bool sendInFlight = false;                    // 是否有sendmsg请求尚未完成
+    std::unique_ptr<RingSend> ringSend;           // 进行中的sendmsg参数，完成后归还Reactor
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_CONNECTION_HPP
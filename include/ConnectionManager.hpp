@@ -1,36 +1,47 @@
 #ifndef WEBSERVER_CONNECTION_MANAGER_HPP
 #define WEBSERVER_CONNECTION_MANAGER_HPP
 
-#include <map>
+#include <array>
 #include <mutex>
-#include <functional>
-#include <thread>
 #include <chrono>
 #include <atomic>
-#include <condition_variable>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "Config.hpp"
+#include "IpAddress.hpp"
+#include "IpFilter.hpp"
 
 namespace webserver {
 
-/**
- * @struct ConnectionInfo
- * @brief 存储连接的详细信息
- */
-struct ConnectionInfo {
-    std::thread thread;                           // 处理连接的线程
-    std::chrono::steady_clock::time_point lastActivity; // 最后活动时间
-    int requestCount;                             // 请求计数
-    bool keepAlive;                               // 是否保持连接
-    std::string clientIP;                         // 客户端IP地址
-};
-
 /**
  * @class ConnectionManager
  * @brief 管理服务器的客户端连接
+ *
+ * 只负责连接数限制和统计；连接超时由各Reactor的时间轮处理。
+ * 连接表按fd分成kShardCount个分片，每个分片以fd为下标保存结构数组，
+ * 每个请求的记账只锁住连接所在的分片；统计信息由各分片的计数器汇总。
+ *
+ * 登记连接时按二进制地址检查访问控制列表、单个地址的连接数和所在网段
+ * （IPv4默认/24，IPv6默认/64）的连接数。地址计数表按网段分片，
+ * 同一网段的地址计数和网段计数落在同一分片，一次加锁即可完成检查。
  */
 class ConnectionManager {
 public:
-    using ConnectionHandler = std::function<void()>;
+    /**
+     * @struct KeepAliveLimits
+     * @brief 当前生效的保活参数
+     *
+     * 连接占用率（已登记连接数占总连接数上限的比例）超过压力阈值后，保活超时和每个连接的
+     * 最大请求数从配置值线性收缩，满载时降到下限；占用率回落后自动恢复。
+     */
+    struct KeepAliveLimits {
+        int timeoutSeconds = 0;         // 保活连接等待下一个请求的秒数
+        int maxRequests = 0;            // 每个连接最多处理的请求数
+        unsigned occupancyPercent = 0;  // 当前连接占用率（百分比）
+        bool adaptive = false;          // 是否启用自适应（压力阈值低于100%）
+        bool underPressure = false;     // 占用率已超过压力阈值，参数正在收缩
+    };
 
     /**
      * @brief 构造函数
@@ -44,17 +55,31 @@ public:
     ~ConnectionManager();
 
     /**
-     * @brief 添加新的连接
+     * @brief 登记新的连接
+     *
+     * 连接本身由事件循环驱动，这里只负责连接数限制和统计。
+     * 超出限制时套接字会被直接关闭。
+     *
+     * @param socket 客户端套接字描述符
+     * @param clientAddress 客户端地址
+     * @return 登记成功返回true，被拒绝或超出限制返回false
+     */
+    bool addConnection(int socket, const IpAddress& clientAddress);
+
+    /**
+     * @brief 登记新的连接
      * @param socket 客户端套接字描述符
-     * @param handler 处理连接的函数
+     * @param clientIP 文本形式的客户端IP地址
+     * @return 登记成功返回true，地址无效、被拒绝或超出限制返回false
      */
-    void addConnection(int socket, const std::string& clientIP, ConnectionHandler handler);
+    bool addConnection(int socket, const std::string& clientIP);
 
     /**
      * @brief 关闭指定连接
      * @param socket 要关闭的套接字描述符
+     * @param closeSocket 是否同时关闭套接字；为false时由调用者自行关闭（如通过io_uring异步关闭）
      */
-    void closeConnection(int socket);
+    void closeConnection(int socket, bool closeSocket = true);
 
     /**
      * @brief 停止所有连接
@@ -92,6 +117,12 @@ public:
      */
     uint64_t getTotalRequestCount() const;
     
+    /**
+     * @brief 按当前的连接占用率计算保活参数
+     * @return 当前生效的保活超时和最大请求数
+     */
+    KeepAliveLimits keepAliveLimits() const;
+
     /**
      * @brief 获取连接统计信息
      * @return 包含统计信息的JSON字符串
@@ -99,29 +130,90 @@ public:
     std::string getConnectionStats() const;
 
 private:
-    std::atomic<uint64_t> totalRequests_{0};      // 总请求计数
+    static constexpr size_t kShardBits = 6;
+    static constexpr size_t kShardCount = size_t(1) << kShardBits;
+
     /**
-     * @brief 清理过期连接的线程函数
+     * @struct Shard
+     * @brief 连接表的一个分片，fd为 i * kShardCount + 分片编号 的连接保存在下标i处
+     *
+     * 每个请求都会访问的字段按结构数组存放，clientAddress只在登记和关闭时使用。
+     * 按缓存行对齐，避免相邻分片的计数器互相干扰。
      */
-    void cleanupTask();
-    
-    std::map<int, ConnectionInfo> connections_;   // 连接映射表
-    std::map<std::string, int> ipConnections_;    // IP地址连接数映射表
-    mutable std::mutex connectionsMutex_;         // 保护连接映射表的互斥锁
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;                 // 保护本分片的数组
+        std::vector<int64_t> lastActivity;        // 最后活动时间（steady_clock纳秒）
+        std::vector<int> requestCount;            // 请求计数
+        std::vector<uint8_t> keepAlive;           // 是否保持连接
+        std::vector<uint8_t> inUse;               // 该下标是否有连接
+        std::vector<IpAddress> clientAddress;     // 客户端地址
+        std::atomic<size_t> connectionCount{0};   // 本分片的连接数
+        std::atomic<uint64_t> requestTotal{0};    // 本分片处理的请求数
+    };
+
+    /**
+     * @struct AddressShard
+     * @brief 地址计数表的一个分片，保存属于本分片网段的地址计数和网段计数
+     */
+    struct alignas(64) AddressShard {
+        mutable std::mutex mutex;                 // 保护本分片的计数表
+        std::unordered_map<IpAddress, int, IpAddressHash> addresses;  // 单个地址的连接数
+        std::unordered_map<IpAddress, int, IpAddressHash> prefixes;   // 网段的连接数
+    };
+
+    /**
+     * @brief 获取地址所在的网段
+     */
+    IpAddress prefixOf(const IpAddress& address) const {
+        return address.masked(address.isV4() ? ipv4PrefixLength_ : ipv6PrefixLength_);
+    }
+
+    /**
+     * @brief 获取网段所在的地址计数分片
+     */
+    AddressShard& addressShardFor(const IpAddress& prefix) {
+        return addressShards_[IpAddressHash()(prefix) & (kShardCount - 1)];
+    }
+
+    /**
+     * @brief 注销一个地址的连接计数
+     */
+    void releaseAddress(const IpAddress& address);
+
+    /**
+     * @brief 获取fd所在的分片
+     */
+    Shard& shardFor(int socket) { return shards_[static_cast<size_t>(socket) & (kShardCount - 1)]; }
+
+    /**
+     * @brief 获取fd在分片中的下标
+     */
+    static size_t indexFor(int socket) { return static_cast<size_t>(socket) >> kShardBits; }
+
+    /**
+     * @brief 获取当前时间（steady_clock纳秒）
+     */
+    static int64_t nowNanos();
+
+    std::array<Shard, kShardCount> shards_;       // 连接表分片
+    std::array<AddressShard, kShardCount> addressShards_;  // 地址计数表分片
+    std::atomic<size_t> reservedConnections_;     // 已登记的连接总数，用于总连接数限制
+    IpFilter ipFilter_;                           // 访问控制列表
     const Config& config_;                        // 服务器配置
     std::atomic<bool> running_;                   // 连接管理器运行状态
     
     // 配置项
     int maxConnectionsPerClient_;                 // 每个客户端的最大连接数
     int maxConnectionsPerIP_;                     // 每个IP地址的最大连接数
-    int connectionTimeout_;                       // 连接超时时间（秒）
-    int keepAliveTimeout_;                        // 保活连接超时时间（秒）
     int maxRequestsPerConnection_;                // 每个连接的最大请求数
-    int connectionCleanupInterval_;               // 连接清理间隔（秒）
-    
-    // 清理线程
-    std::thread cleanupThread_;                   // 清理过期连接的线程
-    std::condition_variable cleanupCV_;           // 用于通知清理线程的条件变量
+    int keepAliveTimeout_;                        // 保活超时的秒数
+    int keepAliveMinTimeout_;                     // 连接满载时保活超时收缩到的秒数
+    int keepAliveMinRequests_;                    // 连接满载时每个连接最大请求数收缩到的值
+    int keepAlivePressurePercent_;                // 占用率超过该百分比后开始收缩，100表示不启用
+    int maxConnectionsPerV4Prefix_;               // 每个IPv4网段的最大连接数，0表示不限制
+    int maxConnectionsPerV6Prefix_;               // 每个IPv6网段的最大连接数，0表示不限制
+    unsigned ipv4PrefixLength_;                   // IPv4网段长度（以128位地址计）
+    unsigned ipv6PrefixLength_;                   // IPv6网段长度
 };
 
 } // namespace webserver
@@ -0,0 +1,167 @@
+#ifndef WEBSERVER_CONTENT_CACHE_HPP
+#define WEBSERVER_CONTENT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace webserver {
+
+/**
+ * @struct CachedResponse
+ * @brief 预先序列化好的静态文件响应
+ *
+ * 响应头按是否保持连接各生成一份，命中时连接直接把响应头和文件内容两个缓冲区
+ * 一次聚集写出，不再做任何格式化。
+ */
+struct CachedResponse {
+    std::string path;                             // 文件系统路径
+    std::string headers[2];                       // 完整的响应头（含结尾空行），下标为是否保持连接
+    std::string body;                             // 文件内容
+    std::string contentType;                      // Content-Type
+    std::string lastModified;                     // Last-Modified
+    std::string etag;                             // ETag
+    time_t mtime = 0;                             // 修改时间
+
+    /**
+     * @brief 缓存项占用的字节数
+     */
+    size_t cost() const { return headers[0].size() + headers[1].size() + body.size(); }
+};
+
+/**
+ * @class ContentCache
+ * @brief 按总字节数限制容量的LRU小文件内容缓存，由inotify失效
+ *
+ * 缓存文件所在目录都注册了inotify监视，文件被修改、替换或删除时，
+ * 所属线程调用processEvents()后对应缓存项立即失效。线程安全。
+ */
+class ContentCache {
+public:
+    /**
+     * @struct Stats
+     * @brief 缓存统计
+     */
+    struct Stats {
+        uint64_t hits = 0;           // 直接由内存响应的请求
+        uint64_t misses = 0;         // 未命中的查找
+        uint64_t evictions = 0;      // 因容量上限淘汰的项
+        uint64_t invalidations = 0;  // 因文件变化失效的项
+    };
+
+    /**
+     * @brief 构造函数，inotify初始化失败时缓存被禁用
+     * @param capacityBytes 缓存总字节数上限，0表示不缓存
+     * @param maxFileSize 可缓存的最大文件大小
+     */
+    ContentCache(size_t capacityBytes, size_t maxFileSize);
+
+    /**
+     * @brief 析构函数，关闭inotify描述符
+     */
+    ~ContentCache();
+
+    ContentCache(const ContentCache&) = delete;
+    ContentCache& operator=(const ContentCache&) = delete;
+
+    /**
+     * @brief 缓存是否可用
+     */
+    bool enabled() const { return capacityBytes_ > 0 && notifyFd_ != -1; }
+
+    /**
+     * @brief 可缓存的最大文件大小
+     */
+    size_t maxFileSize() const { return maxFileSize_; }
+
+    /**
+     * @brief 获取inotify描述符（非阻塞），可读时调用processEvents()
+     * @return 描述符，缓存被禁用时返回-1
+     */
+    int notifyFd() const { return notifyFd_; }
+
+    /**
+     * @brief 查找缓存的响应
+     * @param path 文件系统路径
+     * @return 缓存的响应，未命中返回nullptr
+     */
+    std::shared_ptr<const CachedResponse> find(const std::string& path);
+
+    /**
+     * @brief 监视文件所在目录，必须在校验和读取文件之前调用
+     *
+     * 之后发生的修改都会产生事件；读取期间处理过事件时，insert会丢弃读到的内容。
+     *
+     * @param path 文件系统路径
+     * @param generation 输出的事件代数，原样传给insert
+     * @return 监视成功返回true
+     */
+    bool watch(const std::string& path, uint64_t& generation);
+
+    /**
+     * @brief 插入缓存项，必要时淘汰最久未使用的项
+     * @param response 响应，路径取自response->path
+     * @param generation watch返回的事件代数
+     */
+    void insert(std::shared_ptr<const CachedResponse> response, uint64_t generation);
+
+    /**
+     * @brief 读取并处理所有待处理的inotify事件
+     * @param onChange 对每个发生变化的文件路径调用（可为空），用于同步失效其他缓存
+     */
+    void processEvents(const std::function<void(const std::string&)>& onChange = nullptr);
+
+    /**
+     * @brief 获取缓存项数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 获取缓存占用的字节数
+     */
+    size_t bytes() const;
+
+    /**
+     * @brief 获取缓存统计
+     */
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const CachedResponse> response;
+        std::list<std::string>::iterator lruPosition;   // 在LRU链表中的位置
+    };
+
+    /**
+     * @brief 删除一个缓存项，调用者需持有锁
+     */
+    void eraseLocked(std::unordered_map<std::string, Entry>::iterator it);
+
+    /**
+     * @brief 删除目录下的所有缓存项并忘记该目录的监视，调用者需持有锁
+     */
+    void dropDirectoryLocked(int watch);
+
+    size_t capacityBytes_;
+    size_t maxFileSize_;
+    int notifyFd_;                                // inotify描述符
+
+    mutable std::mutex mutex_;                    // 保护以下成员
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;                  // 表头为最近使用的路径
+    size_t bytes_ = 0;                            // 所有缓存项的cost之和
+    uint64_t generation_ = 0;                     // 每处理一批inotify事件加一
+    std::unordered_map<int, std::string> watchedDirectories_;    // 监视描述符 -> 目录
+    std::unordered_map<std::string, int> directoryWatches_;      // 目录 -> 监视描述符
+    Stats stats_;
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_CONTENT_CACHE_HPP
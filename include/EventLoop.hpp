@@ -0,0 +1,128 @@
+#ifndef WEBSERVER_EVENT_LOOP_HPP
+#define WEBSERVER_EVENT_LOOP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+
+namespace webserver {
+
+/**
+ * @class EventLoop
+ * @brief 基于epoll的事件循环，负责分发监听套接字和客户端套接字上的I/O事件
+ *
+ * 除quit()和queueInLoop()外，其余方法都只能在事件循环线程中调用。
+ */
+class EventLoop {
+public:
+    using EventCallback = std::function<void(uint32_t events)>;
+    using Functor = std::function<void()>;
+
+    /**
+     * @brief 构造函数，创建epoll实例和唤醒用的eventfd
+     * @throws std::runtime_error 如果创建失败
+     */
+    EventLoop();
+
+    /**
+     * @brief 析构函数
+     */
+    ~EventLoop();
+
+    // 禁止拷贝
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief 运行事件循环，直到调用quit()
+     */
+    void loop();
+
+    /**
+     * @brief 退出事件循环（线程安全，可在信号处理函数中调用）
+     */
+    void quit();
+
+    /**
+     * @brief 注册文件描述符
+     * @param fd 文件描述符
+     * @param events 关注的epoll事件（如EPOLLIN | EPOLLET）
+     * @param callback 事件就绪时的回调
+     * @return 注册成功返回true，否则返回false
+     */
+    bool addFd(int fd, uint32_t events, EventCallback callback);
+
+    /**
+     * @brief 修改文件描述符关注的事件
+     * @param fd 文件描述符
+     * @param events 新的epoll事件集合
+     * @return 修改成功返回true，否则返回false
+     */
+    bool modifyFd(int fd, uint32_t events);
+
+    /**
+     * @brief 注销文件描述符（不会关闭它）
+     * @param fd 文件描述符
+     */
+    void removeFd(int fd);
+
+    /**
+     * @brief 将任务投递到事件循环线程中执行（线程安全）
+     * @param functor 要执行的任务
+     */
+    void queueInLoop(Functor functor);
+
+    /**
+     * @brief 判断当前线程是否为事件循环线程
+     * @return 是则返回true
+     */
+    bool isInLoopThread() const;
+
+    /**
+     * @brief 设置每轮事件处理结束后执行的回调，用于批量提交本轮产生的异步I/O
+     * @param callback 回调函数
+     */
+    void setPostIterationCallback(Functor callback);
+
+    /**
+     * @brief 获取epoll_wait的调用次数（线程安全）
+     * @return 调用次数
+     */
+    uint64_t pollCount() const { return pollCount_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief 通过eventfd唤醒阻塞在epoll_wait中的循环
+     */
+    void wakeup();
+
+    /**
+     * @brief 读取并清空eventfd计数
+     */
+    void handleWakeup();
+
+    /**
+     * @brief 执行其他线程投递过来的任务
+     */
+    void doPendingFunctors();
+
+    int epollFd_;                                 // epoll实例
+    int wakeupFd_;                                // 用于跨线程唤醒的eventfd
+    std::atomic<bool> quit_;                      // 退出标志
+    std::thread::id threadId_;                    // 事件循环所在线程
+    std::vector<epoll_event> events_;             // epoll_wait的输出缓冲
+    std::vector<EventCallback> callbacks_;        // 以fd为下标的回调表
+    Functor postIterationCallback_;               // 每轮事件处理结束后执行的回调
+    std::atomic<uint64_t> pollCount_;             // epoll_wait调用次数
+
+    std::mutex pendingMutex_;                     // 保护待执行任务队列
+    std::vector<Functor> pendingFunctors_;        // 其他线程投递的任务
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_EVENT_LOOP_HPP
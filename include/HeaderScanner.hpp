@@ -0,0 +1,66 @@
+#ifndef WEBSERVER_HEADER_SCANNER_HPP
+#define WEBSERVER_HEADER_SCANNER_HPP
+
+#include <cstddef>
+
+namespace webserver {
+
+/**
+ * @class HeaderScanner
+ * @brief 请求行和请求头的字符扫描
+ *
+ * 每个函数返回第一个不属于对应字符集的字节的下标，全部合法时返回size。
+ * 启动时按CPU支持情况选择AVX2、SSE4.2或逐字节的实现，三者结果完全一致。
+ * 扫描不会读取[data, data + size)之外的字节。
+ */
+class HeaderScanner {
+public:
+    /**
+     * @enum Level
+     * @brief 扫描实现使用的指令集
+     */
+    enum class Level {
+        SCALAR,   ///< 逐字节查表
+        SSE42,    ///< SSE4.2 pcmpestri，每次16字节
+        AVX2      ///< AVX2，每次32字节
+    };
+
+    /**
+     * @brief 当前CPU支持的最高级别
+     */
+    static Level supportedLevel();
+
+    /**
+     * @brief 当前使用的级别
+     */
+    static Level level();
+
+    /**
+     * @brief 指定使用的级别，超出CPU支持时降到supportedLevel()，用于测试和基准对比
+     * @param level 期望的级别
+     * @return 实际使用的级别
+     */
+    static Level setLevel(Level level);
+
+    /**
+     * @brief 查找token（方法、请求头名称）的结束位置
+     * @return 第一个非tchar字节的下标
+     */
+    static size_t findTokenEnd(const char* data, size_t size);
+
+    /**
+     * @brief 查找请求目标的结束位置
+     * @return 第一个空白、控制字符或DEL的下标
+     */
+    static size_t findTargetEnd(const char* data, size_t size);
+
+    /**
+     * @brief 查找请求头值的结束位置
+     * @return 第一个除HTAB以外的控制字符或DEL（包括CR、LF）的下标
+     */
+    static size_t findFieldValueEnd(const char* data, size_t size);
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_HEADER_SCANNER_HPP
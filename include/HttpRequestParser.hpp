@@ -0,0 +1,290 @@
+#ifndef WEBSERVER_HTTP_REQUEST_PARSER_HPP
+#define WEBSERVER_HTTP_REQUEST_PARSER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ChunkedDecoder.hpp"
+#include "HttpStatus.hpp"
+#include "http/HttpHeaders.hpp"
+#include "http/HttpMethod.hpp"
+
+namespace webserver {
+
+/**
+ * @struct HeaderView
+ * @brief 指向输入缓冲区的请求头
+ */
+struct HeaderView {
+    std::string_view name;
+    std::string_view value;                       // 已去掉首尾空白
+    HttpHeader id = HttpHeader::UNKNOWN;          // 常用头部的枚举值
+};
+
+/**
+ * @struct RequestView
+ * @brief 解析完成的请求，所有字段都指向输入缓冲区（分块编码的请求体除外）
+ *
+ * 视图在输入缓冲区被修改或解析器被reset()之前有效。
+ */
+struct RequestView {
+    std::string_view method;
+    HttpMethod methodId = HttpMethod::UNKNOWN;
+    std::string_view target;                      // 请求目标，含查询字符串
+    std::string_view path;                        // 请求目标中'?'之前的部分
+    std::string_view query;                       // 请求目标中'?'之后的部分
+    int versionMinor = 1;                         // HTTP/1.x中的x
+    std::vector<HeaderView> headers;              // 按出现顺序排列
+    std::string_view body;                        // 请求体，分块编码时指向解析器内的解码结果；设置了BodyHandler时为空
+    std::vector<HeaderView> trailers;             // 分块编码的尾部字段，指向解析器内部
+    size_t length = 0;                            // 整个请求在输入缓冲区中占用的字节数
+
+    /**
+     * @brief 不区分大小写地查找请求头
+     * @param name 头部名称
+     * @return 第一个同名头部，不存在返回nullptr
+     */
+    const HeaderView* findHeader(std::string_view name) const;
+
+    /**
+     * @brief 按枚举查找常用头部，不比较字符串
+     * @param id 头部枚举值
+     * @return 第一个匹配的头部，不存在返回nullptr
+     */
+    const HeaderView* findHeader(HttpHeader id) const;
+
+    /**
+     * @brief 按HTTP/1.x的持久连接规则判断客户端是否希望保持连接
+     *
+     * HTTP/1.1除非Connection头含有close选项，否则保持连接；HTTP/1.0只有含keep-alive选项时才保持。
+     */
+    bool keepAlive() const;
+};
+
+/**
+ * @class HttpRequestParser
+ * @brief 可恢复的HTTP/1.x请求解析器
+ *
+ * 每次数据到达后用连接的输入缓冲区（从当前请求的第一个字节开始）调用parse()，
+ * 解析器记住上次停下的位置和状态，只扫描新到达的字节，请求跨多次读取也不会被截断。
+ * 解析过程不复制请求行和请求头，也不抛出异常，错误通过返回值和error()报告。
+ * 一个解析器对应一个连接，不是线程安全的。
+ */
+class HttpRequestParser {
+public:
+    /**
+     * @enum Status
+     * @brief parse()的结果
+     */
+    enum class Status {
+        INCOMPLETE,        ///< 请求尚未收全，等待更多数据
+        HEADERS_COMPLETE,  ///< 请求头已收全，请求体尚未开始处理（只在Limits::pauseAfterHeaders时返回）
+        COMPLETE,          ///< 请求已收全，可通过request()获取
+        ERROR              ///< 请求非法或超出限制，通过error()获取原因
+    };
+
+    /**
+     * @enum Error
+     * @brief 解析错误
+     */
+    enum class Error {
+        NONE,
+        BAD_REQUEST_LINE,      ///< 请求行格式错误
+        BAD_METHOD,            ///< 不支持的方法
+        BAD_VERSION,           ///< 不支持的协议版本
+        BAD_HEADER,            ///< 请求头格式错误
+        MISSING_HOST,          ///< HTTP/1.1请求缺少Host头
+        BAD_CONTENT_LENGTH,    ///< Content-Length非法、重复且不一致，或与Transfer-Encoding同时出现
+        BAD_TRANSFER_ENCODING, ///< 不支持的传输编码
+        BAD_CHUNK,             ///< 分块编码格式错误
+        URI_TOO_LONG,          ///< 请求行超过请求头大小上限
+        HEADER_TOO_LARGE,      ///< 请求头总大小或数量超过上限
+        BODY_TOO_LARGE,        ///< 请求体超过大小上限
+        BODY_HANDLER_FAILED    ///< BodyHandler拒绝了请求体数据
+    };
+
+    /**
+     * @brief 请求体数据的接收者
+     *
+     * 参数是刚到达的一段请求体（已去掉分块编码），只在回调期间有效；返回false时中止解析。
+     */
+    using BodyHandler = std::function<bool(std::string_view data)>;
+
+    /**
+     * @struct Limits
+     * @brief 解析限制
+     */
+    struct Limits {
+        size_t maxHeaderBytes = 65536;            // 请求行和所有请求头的总字节数上限
+        size_t maxRequestLineBytes = 8192;        // 请求行（不含CRLF）的字节数上限
+        size_t maxHeaders = 100;                  // 请求头数量上限
+        size_t maxBodySize = 8 * 1024 * 1024;     // 请求体（解码后）字节数上限
+        bool pauseAfterHeaders = false;           // 请求头收全后先返回HEADERS_COMPLETE，由调用者决定如何接收请求体
+    };
+
+    /**
+     * @brief 使用默认限制构造
+     */
+    HttpRequestParser();
+
+    /**
+     * @brief 构造函数
+     * @param limits 解析限制
+     */
+    explicit HttpRequestParser(const Limits& limits);
+
+    /**
+     * @brief 继续解析请求
+     *
+     * data必须以当前请求的第一个字节开头，并包含上次调用时传入的全部数据。
+     *
+     * @param data 已接收的数据
+     * @return 解析状态；返回COMPLETE或ERROR后，需调用reset()才能解析下一个请求
+     */
+    Status parse(std::string_view data);
+
+    /**
+     * @brief 获取解析完成的请求，只在parse()返回COMPLETE后有效
+     *
+     * 返回HEADERS_COMPLETE后请求行和请求头已经可用，请求体为空。
+     */
+    const RequestView& request() const { return request_; }
+
+    /**
+     * @brief 获取解析错误
+     */
+    Error error() const { return error_; }
+
+    /**
+     * @brief 获取与解析错误对应的响应状态码
+     */
+    HttpStatus errorStatus() const;
+
+    /**
+     * @brief 设置请求体的接收者，请求体数据随到随交给handler，不再缓存在解析器中
+     *
+     * 可以在请求头解析完之后再设置，此前已经解码但尚未交出的数据会先交给handler。
+     * reset()会清除handler。
+     *
+     * @param handler 请求体数据的接收者
+     * @return handler拒绝已缓存的数据时返回false
+     */
+    bool setBodyHandler(BodyHandler handler);
+
+    /**
+     * @brief 是否设置了BodyHandler
+     */
+    bool hasBodyHandler() const { return static_cast<bool>(bodyHandler_); }
+
+    /**
+     * @brief 修改当前请求的请求体大小上限，在请求体开始处理之前调用；reset()后恢复为Limits中的值
+     * @param size 请求体（解码后）字节数上限
+     */
+    void setMaxBodySize(size_t size);
+
+    /**
+     * @brief 从输入缓冲区中删除已经交给BodyHandler的请求体字节
+     *
+     * 请求行和请求头保留在原位置，之后的数据前移；删除后继续用同一个缓冲区调用parse()，
+     * 请求体再大，缓冲区中也只保留尚未交出的部分。
+     *
+     * @param buffer 传给parse()的输入缓冲区
+     * @return 删除的字节数
+     */
+    size_t discardDeliveredBody(std::string& buffer);
+
+    /**
+     * @brief 请求是否使用分块编码，请求头解析完之后有效
+     */
+    bool chunked() const { return chunked_; }
+
+    /**
+     * @brief 非分块请求的请求体长度，请求头解析完之后有效
+     */
+    size_t contentLength() const { return contentLength_; }
+
+    /**
+     * @brief 请求头是否已经解析完（正在等待请求体）
+     */
+    bool headersComplete() const { return state_ > State::HEADERS; }
+
+    /**
+     * @brief 丢弃当前请求的状态，准备解析下一个请求
+     */
+    void reset();
+
+    /**
+     * @brief 释放为之前的请求保留的容量（请求头数组和分块请求体），只在两个请求之间调用
+     */
+    void releaseMemory();
+
+    /**
+     * @brief 获取解析器在堆上占用的字节数
+     */
+    size_t memoryUsage() const;
+
+private:
+    enum class State {
+        REQUEST_LINE,
+        HEADERS,
+        BODY,
+        CHUNKED,
+        COMPLETE,
+        ERROR
+    };
+
+    // 请求头在输入缓冲区中的位置，数据可能因缓冲区增长而移动，解析完成前只记录偏移
+    struct HeaderOffsets {
+        size_t nameBegin;
+        size_t nameLength;
+        size_t valueBegin;
+        size_t valueLength;
+        HttpHeader id;
+    };
+
+    /**
+     * @brief 从position_开始查找下一行
+     * @param data 输入数据
+     * @param lineEnd 输出行内容的结束位置（不含CRLF）
+     * @param next 输出下一行的开始位置
+     * @return 找到完整的一行返回true
+     */
+    bool nextLine(std::string_view data, size_t& lineEnd, size_t& next);
+
+    bool parseRequestLine(std::string_view data, size_t lineEnd);
+    bool parseHeaderLine(std::string_view data, size_t lineEnd);
+    bool finishHeaders(std::string_view data);
+    Status parseBody(std::string_view data);
+    Status parseChunked(std::string_view data);
+    bool deliverBody(std::string_view chunk);
+    Status fail(Error error);
+    void buildRequest(std::string_view data);
+
+    Limits limits_;
+    State state_ = State::REQUEST_LINE;
+    Error error_ = Error::NONE;
+    size_t position_ = 0;                         // 下一个待解析的字节
+    size_t scanned_ = 0;                          // 当前行中已确认不含换行的位置
+    size_t requestLineBegin_ = 0;                 // 跳过前导空行后请求行的开始位置
+    size_t methodLength_ = 0;
+    HttpMethod methodId_ = HttpMethod::UNKNOWN;
+    size_t targetBegin_ = 0;
+    size_t targetLength_ = 0;
+    int versionMinor_ = 1;
+    std::vector<HeaderOffsets> headers_;
+    size_t bodyBegin_ = 0;
+    size_t contentLength_ = 0;                    // 非分块请求的请求体长度
+    size_t bodyDiscarded_ = 0;                    // 已从输入缓冲区删除的请求体字节数
+    size_t maxBodySize_ = 0;                      // 当前请求的请求体大小上限
+    bool chunked_ = false;
+    ChunkedDecoder decoder_;
+    std::string chunkedBody_;                     // 分块编码解码后的请求体，reset()时保留容量
+    BodyHandler bodyHandler_;
+    RequestView request_;
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_HTTP_REQUEST_PARSER_HPP
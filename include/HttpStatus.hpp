@@ -48,6 +48,7 @@ enum class HttpStatus {
     EXPECTATION_FAILED = 417,
     UPGRADE_REQUIRED = 426,
     TOO_MANY_REQUESTS = 429,
+    REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
 
     // 5xx: 服务器错误状态码
     INTERNAL_SERVER_ERROR = 500,
@@ -0,0 +1,186 @@
+#ifndef WEBSERVER_IO_URING_HPP
+#define WEBSERVER_IO_URING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <linux/io_uring.h>
+
+namespace webserver {
+
+/**
+ * @class IoUring
+ * @brief io_uring实例的轻量封装，直接使用io_uring_setup/io_uring_enter/io_uring_register系统调用
+ *
+ * 除提交/完成队列外，还管理一个提供缓冲区环（provided buffer ring），
+ * 供多发（multishot）recv在数据到达时才从中取缓冲区，空闲连接因此不占用读缓冲。
+ * 实例不是线程安全的，只能由创建它的Reactor线程使用。
+ */
+class IoUring {
+public:
+    /**
+     * @brief 创建io_uring实例
+     * @param entries 提交队列长度
+     * @throws std::runtime_error 如果内核不支持或创建失败
+     */
+    explicit IoUring(unsigned entries);
+
+    /**
+     * @brief 析构函数，关闭io_uring实例并释放映射的内存
+     */
+    ~IoUring();
+
+    // 禁止拷贝
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * @brief 获取一个空闲的提交队列项（已清零）
+     *
+     * 队列已满时会先提交已有的项再重试。
+     *
+     * @return 提交队列项，仍无法获取时返回nullptr
+     */
+    io_uring_sqe* getSqe();
+
+    /**
+     * @brief 将已准备好的提交队列项提交给内核
+     * @return 内核接收的数量，失败返回负的errno
+     */
+    int submit();
+
+    /**
+     * @brief 提交已准备好的项并阻塞等待至少一个完成项
+     * @return 成功返回非负值，失败返回负的errno
+     */
+    int submitAndWait();
+
+    /**
+     * @brief 遍历并消费所有已完成的队列项
+     * @param callback 对每个完成项调用的函数，签名为void(const io_uring_cqe&)
+     * @return 处理的完成项数量
+     */
+    template<typename Callback>
+    unsigned forEachCompletion(Callback&& callback) {
+        unsigned count = 0;
+        while (true) {
+            unsigned head = *cqHead_;
+            unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                // 完成队列溢出时内核把完成项暂存在溢出链表中，需要主动取回
+                if (__atomic_load_n(sqFlags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) {
+                    flushOverflow();
+                    if (*cqHead_ != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+                        continue;
+                    }
+                }
+                break;
+            }
+            for (; head != tail; ++head, ++count) {
+                callback(cqes_[head & cqMask_]);
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        }
+        return count;
+    }
+
+    /**
+     * @brief 注册eventfd，完成项到达时内核会向其写入，便于接入epoll事件循环
+     * @param eventFd eventfd描述符
+     * @return 注册成功返回true
+     */
+    bool registerEventFd(int eventFd);
+
+    /**
+     * @brief 注册稀疏的固定文件表
+     * @param count 表的大小
+     * @return 注册成功返回true
+     */
+    bool registerFiles(unsigned count);
+
+    /**
+     * @brief 更新固定文件表中的一项
+     * @param slot 表中的下标
+     * @param fd 文件描述符，-1表示清空该项
+     * @return 更新成功返回true
+     */
+    bool updateFile(unsigned slot, int fd);
+
+    /**
+     * @brief 注册提供缓冲区环
+     * @param groupId 缓冲区组编号，recv通过它选择缓冲区
+     * @param count 缓冲区数量（必须是2的幂）
+     * @param bufferSize 每个缓冲区的大小
+     * @return 注册成功返回true
+     */
+    bool registerBufferRing(uint16_t groupId, unsigned count, size_t bufferSize);
+
+    /**
+     * @brief 获取提供缓冲区的地址
+     * @param bufferId 完成项中返回的缓冲区编号
+     * @return 缓冲区起始地址
+     */
+    char* buffer(uint16_t bufferId) { return bufferMemory_.data() + bufferId * bufferSize_; }
+
+    /**
+     * @brief 将用完的缓冲区归还给内核
+     * @param bufferId 缓冲区编号
+     */
+    void recycleBuffer(uint16_t bufferId);
+
+    /**
+     * @brief 获取固定文件表的大小
+     * @return 固定文件表大小，未注册时为0
+     */
+    unsigned fileCount() const { return fileCount_; }
+
+    /**
+     * @brief 获取io_uring_enter/io_uring_register的调用次数
+     * @return 系统调用次数
+     */
+    uint64_t syscallCount() const { return syscalls_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief 让内核把溢出的完成项移回完成队列
+     */
+    void flushOverflow();
+
+    int ringFd_;                                  // io_uring实例
+    io_uring_params params_;                      // 创建参数及内核返回的偏移量
+
+    void* sqRingPtr_;                             // 提交队列环的映射
+    size_t sqRingSize_;
+    void* cqRingPtr_;                             // 完成队列环的映射（单次映射时与sqRingPtr_相同）
+    size_t cqRingSize_;
+    io_uring_sqe* sqes_;                          // 提交队列项数组
+    size_t sqesSize_;
+
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqFlags_;
+    unsigned sqMask_;
+    unsigned sqEntries_;
+    unsigned sqeTail_;                            // 本地已分配的提交队列项尾指针
+
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned cqMask_;
+    io_uring_cqe* cqes_;
+
+    io_uring_buf* bufferRing_;                    // 提供缓冲区环
+    uint16_t* bufferRingTail_;                    // 环的尾指针，与第一项的resv字段重叠
+    size_t bufferRingSize_;
+    unsigned bufferMask_;
+    uint16_t bufferTail_;                         // 本地缓冲区环尾指针
+    size_t bufferSize_;
+    std::vector<char> bufferMemory_;              // 所有提供缓冲区的内存
+
+    unsigned fileCount_;                          // 固定文件表大小
+    std::atomic<uint64_t> syscalls_;              // 系统调用计数（供统计读取）
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_IO_URING_HPP
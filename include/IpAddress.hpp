@@ -0,0 +1,104 @@
+#ifndef WEBSERVER_IP_ADDRESS_HPP
+#define WEBSERVER_IP_ADDRESS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+
+namespace webserver {
+
+/**
+ * @struct IpAddress
+ * @brief 二进制形式的IP地址，IPv4以IPv4映射的IPv6地址（::ffff:a.b.c.d）保存
+ *
+ * accept得到的地址直接转换为该结构，限流和访问控制都按二进制比较，
+ * 只有在需要输出日志时才格式化为字符串。
+ */
+struct IpAddress {
+    std::array<uint8_t, 16> bytes{};              // 网络字节序的128位地址
+
+    /**
+     * @brief 是否为IPv4地址（IPv4映射的IPv6地址）
+     */
+    bool isV4() const;
+
+    /**
+     * @brief 是否为全零地址（Unix域套接字等没有IP地址的连接）
+     */
+    bool isUnspecified() const;
+
+    /**
+     * @brief 从套接字地址转换（支持AF_INET和AF_INET6，其他地址族返回全零地址）
+     * @param addr 套接字地址
+     * @return 转换后的地址
+     */
+    static IpAddress fromSockaddr(const struct sockaddr* addr);
+
+    /**
+     * @brief 从IPv4主机字节序整数构造
+     * @param address IPv4地址
+     * @return 转换后的地址
+     */
+    static IpAddress fromV4(uint32_t address);
+
+    /**
+     * @brief 解析文本形式的IPv4或IPv6地址
+     * @param text 地址文本
+     * @param address 解析结果
+     * @return 解析成功返回true
+     */
+    static bool parse(const std::string& text, IpAddress& address);
+
+    /**
+     * @brief 解析CIDR（如10.0.0.0/8、2001:db8::/32），省略前缀长度时表示单个地址
+     * @param text CIDR文本
+     * @param address 解析出的网络地址（主机位已清零）
+     * @param prefixLength 以128位地址计的前缀长度（IPv4前缀会加上96）
+     * @return 解析成功返回true
+     */
+    static bool parseCidr(const std::string& text, IpAddress& address, unsigned& prefixLength);
+
+    /**
+     * @brief 只保留前prefixLength位，其余位清零
+     * @param prefixLength 以128位地址计的前缀长度
+     * @return 网络地址
+     */
+    IpAddress masked(unsigned prefixLength) const;
+
+    /**
+     * @brief 取第index位（从最高位开始计）
+     */
+    unsigned bit(unsigned index) const {
+        return (bytes[index / 8] >> (7 - index % 8)) & 1u;
+    }
+
+    /**
+     * @brief 格式化为文本形式（IPv4地址按点分十进制输出）
+     */
+    std::string toString() const;
+
+    bool operator==(const IpAddress& other) const { return bytes == other.bytes; }
+    bool operator!=(const IpAddress& other) const { return bytes != other.bytes; }
+};
+
+/**
+ * @struct IpAddressHash
+ * @brief IpAddress的哈希函数
+ */
+struct IpAddressHash {
+    size_t operator()(const IpAddress& address) const {
+        uint64_t high;
+        uint64_t low;
+        std::memcpy(&high, address.bytes.data(), sizeof(high));
+        std::memcpy(&low, address.bytes.data() + sizeof(high), sizeof(low));
+        uint64_t hash = (high ^ (low * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+        return static_cast<size_t>(hash ^ (hash >> 31));
+    }
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_IP_ADDRESS_HPP
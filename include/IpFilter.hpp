@@ -0,0 +1,108 @@
+#ifndef WEBSERVER_IP_FILTER_HPP
+#define WEBSERVER_IP_FILTER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "IpAddress.hpp"
+
+namespace webserver {
+
+/**
+ * @class IpFilter
+ * @brief 基于最长前缀匹配的IP访问控制列表
+ *
+ * 规则保存在按位展开的二叉前缀树中，节点连续存放在一个数组里。
+ * 每次load都会构建一棵新的不可变前缀树并原子地发布，查询不加锁；
+ * 旧的前缀树保留到过滤器析构时才释放，正在查询的线程不会访问到已释放的内存。
+ */
+class IpFilter {
+public:
+    /**
+     * @brief 构造函数，初始状态允许所有地址
+     */
+    IpFilter();
+
+    /**
+     * @brief 析构函数
+     */
+    ~IpFilter();
+
+    IpFilter(const IpFilter&) = delete;
+    IpFilter& operator=(const IpFilter&) = delete;
+
+    /**
+     * @brief 加载访问控制规则
+     *
+     * 匹配前缀最长的规则生效，同一前缀同时出现在两个列表中时以拒绝为准。
+     * 允许列表非空时，未匹配任何规则的地址被拒绝；否则未匹配的地址被允许。
+     * 解析失败时保留原有规则。
+     *
+     * @param allowList 逗号分隔的允许CIDR列表
+     * @param denyList 逗号分隔的拒绝CIDR列表
+     * @return 全部规则解析成功返回true
+     */
+    bool load(const std::string& allowList, const std::string& denyList);
+
+    /**
+     * @brief 检查地址是否允许连接（无锁）
+     * @param address 客户端地址
+     * @return 允许返回true
+     */
+    bool isAllowed(const IpAddress& address) const;
+
+    /**
+     * @brief 获取当前生效的规则数量
+     */
+    size_t ruleCount() const;
+
+private:
+    enum Action : uint8_t {
+        NONE = 0,
+        ALLOW,
+        DENY
+    };
+
+    /**
+     * @struct Node
+     * @brief 前缀树节点，子节点下标为0表示不存在（根节点不会作为子节点）
+     */
+    struct Node {
+        uint32_t child[2] = {0, 0};
+        Action action = NONE;
+    };
+
+    /**
+     * @struct Snapshot
+     * @brief 一次load构建出的不可变前缀树
+     */
+    struct Snapshot {
+        std::vector<Node> nodes{Node()};          // nodes[0]为根节点
+        uint32_t v4Root = 0;                      // ::ffff:0:0/96 对应的节点，0表示不存在
+        Action v4Inherited = NONE;                // 根到v4Root路径上最长前缀的动作
+        bool defaultAllow = true;                 // 未匹配任何规则时是否允许
+        size_t rules = 0;                         // 规则数量
+    };
+
+    /**
+     * @brief 解析逗号分隔的CIDR列表并插入前缀树
+     */
+    static bool insertRules(Snapshot& snapshot, const std::string& list, Action action);
+
+    /**
+     * @brief 从指定节点开始沿地址的第depth位起匹配，返回最长前缀的动作
+     */
+    static Action match(const Snapshot& snapshot, uint32_t node, unsigned depth,
+                        const IpAddress& address, Action matched);
+
+    std::atomic<const Snapshot*> current_;        // 当前生效的前缀树
+    std::vector<std::unique_ptr<const Snapshot>> snapshots_;  // 所有发布过的前缀树
+    std::mutex writeMutex_;                       // 串行化load
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_IP_FILTER_HPP
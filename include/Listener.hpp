@@ -0,0 +1,67 @@
+#ifndef WEBSERVER_LISTENER_HPP
+#define WEBSERVER_LISTENER_HPP
+
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include "Config.hpp"
+
+namespace webserver {
+
+/**
+ * @struct ListenerSpec
+ * @brief 一个监听地址的配置
+ *
+ * 在配置的 server.listeners 数组中每项一个对象：
+ *   {"type": "tcp", "address": "::", "port": 8080, "ipv6_only": false}
+ *   {"type": "unix", "path": "/run/webserver.sock"}
+ *   {"type": "unix", "path": "webserver", "abstract": true}
+ * address为"::"且ipv6_only为false时同时接受IPv4和IPv6连接。
+ */
+struct ListenerSpec {
+    enum class Type {
+        TCP,
+        UNIX
+    };
+
+    Type type = Type::TCP;
+    std::string address = "0.0.0.0";             // TCP：绑定地址
+    int port = 0;                                 // TCP：端口
+    bool ipv6Only = false;                        // TCP：IPv6地址上是否只接受IPv6连接
+    std::string path;                             // UNIX：套接字路径或抽象命名空间中的名字
+    bool abstractNamespace = false;               // UNIX：是否使用抽象命名空间（不在文件系统中创建文件）
+
+    /**
+     * @brief 从配置读取所有监听地址
+     *
+     * 未配置 server.listeners 时返回一个监听 0.0.0.0:defaultPort 的TCP监听地址。
+     *
+     * @param config 服务器配置
+     * @param defaultPort 未指定端口时使用的端口
+     * @return 监听地址列表
+     * @throws std::runtime_error 配置无效时抛出
+     */
+    static std::vector<ListenerSpec> fromConfig(const Config& config, int defaultPort);
+
+    /**
+     * @brief 构造bind使用的套接字地址
+     * @param addr 输出的套接字地址
+     * @param length 输出的地址长度
+     * @return 地址有效返回true
+     */
+    bool toSockaddr(struct sockaddr_storage& addr, socklen_t& length) const;
+
+    /**
+     * @brief 获取地址族（AF_INET、AF_INET6或AF_UNIX）
+     */
+    int family() const;
+
+    /**
+     * @brief 格式化为便于日志输出的文本（如 tcp://[::]:8080、unix:@webserver）
+     */
+    std::string toString() const;
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_LISTENER_HPP
@@ -0,0 +1,122 @@
+#ifndef WEBSERVER_OPEN_FILE_CACHE_HPP
+#define WEBSERVER_OPEN_FILE_CACHE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sys/types.h>
+
+namespace webserver {
+
+/**
+ * @struct OpenFile
+ * @brief 已打开的静态文件及其元数据
+ *
+ * 由缓存和正在发送它的连接共同持有，最后一个持有者释放时关闭描述符，
+ * 因此缓存淘汰或重新打开文件不会影响正在进行的发送。
+ */
+struct OpenFile {
+    int fd = -1;                                  // 只读描述符
+    std::string path;                             // 文件系统路径
+    off_t size = 0;                               // 文件大小
+    time_t mtime = 0;                             // 修改时间
+    ino_t inode = 0;                              // inode编号，用于识别文件被替换
+    dev_t device = 0;                             // 所在设备
+    std::string lastModified;                     // 预先格式化的Last-Modified
+    std::string etag;                             // 由修改时间和大小生成的ETag
+
+    OpenFile() = default;
+    ~OpenFile();
+
+    /**
+     * @brief 路径当前是否仍指向这个文件且内容未变（重新stat一次）
+     * @return 文件被修改、替换或删除时返回false
+     */
+    bool isCurrent() const;
+
+    OpenFile(const OpenFile&) = delete;
+    OpenFile& operator=(const OpenFile&) = delete;
+};
+
+/**
+ * @class OpenFileCache
+ * @brief 有容量上限的LRU打开文件缓存（描述符和stat结果）
+ *
+ * 命中时直接复用描述符，省去open和fstat；距上次校验超过revalidateInterval的项
+ * 会重新stat一次，文件被修改、替换或删除时重新打开或移除。线程安全。
+ */
+class OpenFileCache {
+public:
+    /**
+     * @struct Stats
+     * @brief 缓存统计
+     */
+    struct Stats {
+        uint64_t hits = 0;           // 命中（包括校验后仍然有效的）
+        uint64_t misses = 0;         // 未命中或文件已变化，需要重新打开
+        uint64_t evictions = 0;      // 因容量上限淘汰的项
+    };
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最多缓存的文件数，0表示不缓存
+     * @param revalidateInterval 两次校验文件元数据的最小间隔
+     * @param readaheadThreshold 不小于该大小的文件打开时提示内核顺序预读
+     */
+    OpenFileCache(size_t capacity, std::chrono::milliseconds revalidateInterval, off_t readaheadThreshold);
+
+    /**
+     * @brief 获取已打开的普通文件
+     * @param path 文件系统路径
+     * @param error 失败时设置为errno（不是普通文件时为EISDIR或EACCES）
+     * @return 文件，失败返回nullptr
+     */
+    std::shared_ptr<const OpenFile> acquire(const std::string& path, int& error);
+
+    /**
+     * @brief 移除缓存项，下次获取时重新打开
+     * @param path 文件系统路径
+     */
+    void invalidate(const std::string& path);
+
+    /**
+     * @brief 获取缓存的文件数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 获取缓存统计
+     */
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const OpenFile> file;
+        std::chrono::steady_clock::time_point validatedAt;  // 上次校验元数据的时间
+        std::list<std::string>::iterator lruPosition;       // 在LRU链表中的位置
+    };
+
+    /**
+     * @brief 打开文件并读取元数据
+     */
+    std::shared_ptr<const OpenFile> open(const std::string& path, int& error) const;
+
+    size_t capacity_;
+    std::chrono::milliseconds revalidateInterval_;
+    off_t readaheadThreshold_;
+
+    mutable std::mutex mutex_;                    // 保护以下成员
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;                  // 表头为最近使用的路径
+    Stats stats_;
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_OPEN_FILE_CACHE_HPP
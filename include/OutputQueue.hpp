@@ -0,0 +1,135 @@
+#ifndef WEBSERVER_OUTPUT_QUEUE_HPP
+#define WEBSERVER_OUTPUT_QUEUE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "OpenFileCache.hpp"
+
+namespace webserver {
+
+/**
+ * @class OutputQueue
+ * @brief 连接的待发送数据，按顺序排列的内存段和文件段
+ *
+ * 内存段引用调用者交来的缓冲区（响应头、处理函数返回的内容、缓存的文件内容），
+ * 由段持有的所有者指针保证在发送完之前有效，发送时直接聚集成iovec，不再拼接复制。
+ * 文件段由sendfile发送，或在无法使用sendfile时分段读入内存。
+ * 段一旦入队，其数据地址在被consume之前不会改变，可以交给异步发送。
+ * 不是线程安全的，由连接所属Reactor的事件循环线程使用。
+ */
+class OutputQueue {
+public:
+    /**
+     * @brief 追加一段数据，队列取得其所有权
+     * @param data 数据，为空时忽略
+     */
+    void append(std::string data);
+
+    /**
+     * @brief 追加一段不归队列所有的数据
+     * @param owner 数据的所有者，发送完之前一直持有
+     * @param data 数据起始地址
+     * @param size 数据长度，为0时忽略
+     */
+    void append(std::shared_ptr<const void> owner, const char* data, size_t size);
+
+    /**
+     * @brief 追加文件中的一段内容
+     * @param file 已打开的文件
+     * @param offset 起始位置
+     * @param length 长度，为0时忽略
+     */
+    void appendFile(std::shared_ptr<const OpenFile> file, off_t offset, size_t length);
+
+    /**
+     * @brief 在队首插入一段数据（用于把文件段的开头读入内存后放回原位）
+     * @param data 数据，为空时忽略
+     */
+    void prepend(std::string data);
+
+    /**
+     * @brief 从队首开始收集连续的内存段，遇到文件段为止
+     * @param iov 输出的iovec数组
+     * @param maxCount 数组容量
+     * @param more 输出收集到的段之后是否还有数据
+     * @return 填入的iovec数量，队首为文件段或队列为空时返回0
+     */
+    size_t gather(struct iovec* iov, size_t maxCount, bool& more) const;
+
+    /**
+     * @brief 获取队首的文件段
+     * @param fd 输出文件描述符
+     * @param offset 输出下一个要发送的位置
+     * @param remaining 输出尚未发送的字节数
+     * @return 队首不是文件段时返回false
+     */
+    bool frontFile(int& fd, off_t& offset, size_t& remaining) const;
+
+    /**
+     * @brief 收集队首若干字节所在内存段的所有者，用于零拷贝发送后在内核完成前继续持有缓冲区
+     * @param bytes 字节数，只统计内存段
+     * @param owners 输出所有者指针
+     */
+    void collectOwners(size_t bytes, std::vector<std::shared_ptr<const void>>& owners) const;
+
+    /**
+     * @brief 从队首移除已发送的字节，文件段相应推进发送位置
+     * @param bytes 已发送的字节数，不超过size()
+     */
+    void consume(size_t bytes);
+
+    /**
+     * @brief 清空队列
+     */
+    void clear();
+
+    /**
+     * @brief 释放空队列保留的段存储，用于连接进入空闲状态时
+     */
+    void releaseMemory();
+
+    /**
+     * @brief 获取段存储占用的堆内存（不含段引用的数据）
+     */
+    size_t memoryUsage() const { return segments_.capacity() * sizeof(Segment); }
+
+    /**
+     * @brief 队列是否为空
+     */
+    bool empty() const { return head_ == segments_.size(); }
+
+    /**
+     * @brief 获取尚未发送的字节数（含文件段）
+     */
+    size_t size() const { return bytes_; }
+
+    /**
+     * @brief 获取尚未发送完的段数
+     */
+    size_t segmentCount() const { return segments_.size() - head_; }
+
+private:
+    struct Segment {
+        std::shared_ptr<const void> owner;        // 内存段数据的所有者
+        const char* data = nullptr;               // 内存段中下一个要发送的字节
+        std::shared_ptr<const OpenFile> file;     // 文件段的文件，内存段为空
+        off_t fileOffset = 0;                     // 文件段中下一个要发送的位置
+        size_t size = 0;                          // 段中尚未发送的字节数
+    };
+
+    void push(Segment segment);
+
+    // 连续存储，队首之前已发送的段在队列清空或扩容时回收；空闲连接可以完全释放存储，
+    // 不像std::deque那样始终保留一块节点内存
+    std::vector<Segment> segments_;
+    size_t head_ = 0;                             // 队首段的下标
+    size_t bytes_ = 0;                            // 所有段中尚未发送的字节数之和
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_OUTPUT_QUEUE_HPP
@@ -0,0 +1,62 @@
+#ifndef WEBSERVER_REACTOR_HPP
+#define WEBSERVER_REACTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Connection.hpp"
+#include "EventLoop.hpp"
+#include "IoUring.hpp"
+#include "TimingWheel.hpp"
+
+namespace webserver {
+
+/**
+ * @struct Reactor
+ * @brief 一个事件循环线程及其独占的监听套接字和连接集合
+ *
+ * 多Reactor模式下每个Reactor各自accept、各自处理自己的连接，
+ * 连接在其生命周期内只会被所属Reactor的线程访问。
+ */
+struct Reactor {
+    size_t index = 0;                             // Reactor编号
+    std::unique_ptr<EventLoop> loop;              // 事件循环
+    std::vector<int> listenFds;                   // 本Reactor接受连接的监听套接字，按监听地址的顺序排列（共享的套接字出现在每个Reactor中）
+    std::thread thread;                           // 运行事件循环的线程（0号Reactor运行在调用start()的线程）
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;  // 本Reactor拥有的连接
+    std::vector<std::unique_ptr<Connection>> closedConnections;         // 已关闭、等待释放的连接
+    TimingWheel timers;                           // 连接超时定时器
+    int timerFd = -1;                             // 按tick周期触发的timerfd，驱动时间轮
+    std::chrono::steady_clock::time_point timerEpoch;  // tick计数的起点
+    std::atomic<uint64_t> requests{0};            // 已处理的请求数
+    std::atomic<uint64_t> accepted{0};            // 已accept的连接数
+    std::atomic<uint64_t> syscalls{0};            // accept/recv/send/close等I/O系统调用次数
+    std::atomic<uint64_t> readPauses{0};          // 因输出积压超过高水位而暂停读取的次数
+    std::atomic<uint64_t> parkedConnections{0};   // 空闲保活、已释放缓冲区的连接数
+    std::atomic<uint64_t> parkedBytes{0};         // 空闲保活连接仍占用的内存
+    std::atomic<uint64_t> zeroCopySends{0};       // MSG_ZEROCOPY发送次数
+    std::atomic<uint64_t> zeroCopyCompletions{0}; // 已收到完成通知、释放了缓冲区的零拷贝发送数
+    std::atomic<uint64_t> zeroCopyCopied{0};      // 内核回退为复制的完成通知数（如回环接口）
+    std::atomic<uint64_t> fairnessYields{0};      // 连接用完每轮处理预算而让出的次数
+    std::vector<std::string> spareBuffers;        // 空闲连接归还的输入缓冲区，有数据到达的连接优先复用
+
+    // io_uring后端（server.io_backend为io_uring时启用）
+    std::unique_ptr<IoUring> ring;                // 本Reactor的io_uring实例，为空表示使用epoll后端
+    int ringEventFd = -1;                         // 注册到ring的eventfd，把完成通知接入事件循环
+    size_t armedAccepts = 0;                      // 仍在进行的多发accept数量（每个监听套接字一个）
+    std::vector<Connection*> ringSlots;           // 以固定文件下标索引的连接
+    std::vector<uint32_t> ringSlotGenerations;    // 每个下标的代数，用于识别过期的完成项
+    std::vector<uint32_t> freeRingSlots;          // 空闲的固定文件下标
+    std::vector<std::unique_ptr<RingSend>> spareRingSends;  // sendmsg完成后归还的请求参数，下一次发送复用
+    std::unordered_map<Connection*, std::unique_ptr<Connection>> drainingConnections;  // 已关闭、等待io_uring请求或零拷贝完成通知的连接
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_REACTOR_HPP
@@ -2,11 +2,37 @@
 #define WEBSERVER_ROUTER_HPP
 
 #include <string>
+#include <string_view>
 #include <map>
+#include <memory>
+#include <set>
 #include <functional>
+#include "SpooledBody.hpp"
 
 namespace webserver {
 
+/**
+ * @class BodyConsumer
+ * @brief 流式接收一个请求的请求体，在事件循环线程中调用
+ */
+class BodyConsumer {
+public:
+    virtual ~BodyConsumer() = default;
+
+    /**
+     * @brief 处理一段刚到达的请求体
+     * @param data 请求体数据，只在调用期间有效
+     * @return 返回false时中止请求，客户端收到500
+     */
+    virtual bool consume(std::string_view data) = 0;
+
+    /**
+     * @brief 请求体接收完毕
+     * @return 响应内容
+     */
+    virtual std::string finish() = 0;
+};
+
 /**
  * @class Router
  * @brief 处理HTTP请求路由的类
@@ -15,6 +41,20 @@ class Router {
 public:
     // 定义HTTP请求处理函数类型
     using RequestHandler = std::function<std::string(const std::map<std::string, std::string>&, const std::string&)>;
+    // 上传处理函数：请求体超过阈值时已转存到临时文件
+    using UploadHandler = std::function<std::string(const std::map<std::string, std::string>&, const SpooledBody&)>;
+    // 流式处理函数：请求头到达后调用，返回接收请求体的对象，返回nullptr时客户端收到500
+    using StreamHandler = std::function<std::unique_ptr<BodyConsumer>(const std::map<std::string, std::string>&)>;
+
+    /**
+     * @enum BodyMode
+     * @brief 路由接收请求体的方式
+     */
+    enum class BodyMode {
+        BUFFERED,    ///< 整个请求体放在内存中，受server.max_body_size限制
+        SPOOLED,     ///< 写入SpooledBody，超过阈值后转存到临时文件
+        STREAMED     ///< 随到随交给BodyConsumer
+    };
     
     /**
      * @brief 构造函数，初始化默认路由
@@ -30,8 +70,38 @@ public:
      * @brief 添加路由处理函数
      * @param path URL路径
      * @param handler 处理该路径的函数
+     * @param offload 为true时处理函数在工作线程池中执行，适用于CPU密集或阻塞的处理函数
+     */
+    void addRoute(const std::string& path, RequestHandler handler, bool offload = false);
+
+    /**
+     * @brief 添加接收大请求体的路由，请求体超过阈值后转存到临时文件，内存占用不随上传大小增长
+     * @param path URL路径
+     * @param handler 处理该路径的函数
+     * @param offload 为true时处理函数在工作线程池中执行
+     */
+    void addUploadRoute(const std::string& path, UploadHandler handler, bool offload = false);
+
+    /**
+     * @brief 添加流式接收请求体的路由，请求体不在服务器中缓存
+     * @param path URL路径
+     * @param handler 为每个请求创建BodyConsumer的函数
      */
-    void addRoute(const std::string& path, RequestHandler handler);
+    void addStreamRoute(const std::string& path, StreamHandler handler);
+
+    /**
+     * @brief 获取路径接收请求体的方式
+     * @param path 请求的URL路径
+     * @return 未注册为上传或流式路由的路径返回BUFFERED
+     */
+    BodyMode bodyMode(const std::string& path) const;
+
+    /**
+     * @brief 判断路径的处理函数是否需要交给工作线程执行
+     * @param path 请求的URL路径
+     * @return 需要交给工作线程返回true
+     */
+    bool isOffloaded(const std::string& path) const;
     
     /**
      * @brief 处理HTTP请求
@@ -44,9 +114,40 @@ public:
         const std::map<std::string, std::string>& headers, 
         const std::string& body) const;
 
+    /**
+     * @brief 处理上传路由的请求
+     * @param path 请求的URL路径
+     * @param headers HTTP请求头
+     * @param body 请求体
+     * @return 包含处理结果的pair，first表示是否找到路由，second为响应内容
+     */
+    std::pair<bool, std::string> handleUpload(const std::string& path,
+        const std::map<std::string, std::string>& headers,
+        const SpooledBody& body) const;
+
+    /**
+     * @brief 为流式路由的请求创建BodyConsumer
+     * @param path 请求的URL路径
+     * @param headers HTTP请求头
+     * @return 路由不存在或处理函数拒绝时返回nullptr
+     */
+    std::unique_ptr<BodyConsumer> openStream(const std::string& path,
+        const std::map<std::string, std::string>& headers) const;
+
 private:
+    /**
+     * @brief 从所有路由表中删除路径，一个路径只属于一种路由
+     */
+    void removeRoute(const std::string& path);
+
     // 路由表
     std::map<std::string, RequestHandler> routes_;
+    // 上传路由表
+    std::map<std::string, UploadHandler> uploadRoutes_;
+    // 流式路由表
+    std::map<std::string, StreamHandler> streamRoutes_;
+    // 需要在工作线程中执行的路由
+    std::set<std::string> offloadedRoutes_;
 };
 
 } // namespace webserver
@@ -0,0 +1,87 @@
+#ifndef WEBSERVER_SPOOLED_BODY_HPP
+#define WEBSERVER_SPOOLED_BODY_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace webserver {
+
+/**
+ * @class SpooledBody
+ * @brief 先放在内存、超过阈值后转存到匿名临时文件的请求体
+ *
+ * 临时文件用O_TMPFILE创建，没有文件名，进程退出或对象析构后由内核回收；文件系统不支持
+ * O_TMPFILE时退回mkstemp并立即unlink。转存后内存中只保留当前写入的数据，
+ * 请求体再大也不会占用更多内存。处理函数可以直接使用fd()，或通过data()获取只读映射。
+ * 对象不是线程安全的，同一时间只能由一个线程使用。
+ */
+class SpooledBody {
+public:
+    /**
+     * @brief 构造函数
+     * @param memoryLimit 内存中最多保存的字节数，超过后转存到临时文件
+     * @param directory 创建临时文件的目录
+     */
+    explicit SpooledBody(size_t memoryLimit, std::string directory = "/tmp");
+
+    /**
+     * @brief 析构函数，解除映射并关闭临时文件
+     */
+    ~SpooledBody();
+
+    SpooledBody(const SpooledBody&) = delete;
+    SpooledBody& operator=(const SpooledBody&) = delete;
+
+    /**
+     * @brief 追加一段数据
+     * @param data 请求体数据
+     * @return 创建或写入临时文件失败返回false
+     */
+    bool append(std::string_view data);
+
+    /**
+     * @brief 获取已写入的字节数
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief 请求体是否仍在内存中
+     */
+    bool inMemory() const { return fd_ < 0; }
+
+    /**
+     * @brief 获取临时文件的描述符，仍在内存中时返回-1
+     */
+    int fd() const { return fd_; }
+
+    /**
+     * @brief 获取整个请求体；已转存时第一次调用会把临时文件只读映射到内存
+     * @return 请求体数据，映射失败时返回空
+     */
+    std::string_view data() const;
+
+private:
+    /**
+     * @brief 创建临时文件并写入内存中的数据
+     * @return 成功返回true
+     */
+    bool spill();
+
+    /**
+     * @brief 把数据完整写入临时文件
+     */
+    bool writeAll(const char* data, size_t size);
+
+    size_t memoryLimit_;
+    std::string directory_;
+    std::string memory_;                          // 转存之前的数据
+    size_t size_ = 0;                             // 已写入的字节数
+    int fd_ = -1;                                 // 临时文件，-1表示尚未转存
+    mutable void* mapping_ = nullptr;             // data()建立的只读映射
+    mutable size_t mappedSize_ = 0;
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_SPOOLED_BODY_HPP
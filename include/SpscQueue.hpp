@@ -0,0 +1,84 @@
+#ifndef WEBSERVER_SPSC_QUEUE_HPP
+#define WEBSERVER_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace webserver {
+
+/**
+ * @class SpscQueue
+ * @brief 单生产者单消费者的无锁有界队列
+ *
+ * 生产者只修改tail_，消费者只修改head_，两者放在不同的缓存行中避免伪共享；
+ * 入队和出队都只有一次acquire读和一次release写，不加锁也不进行系统调用。
+ * 只能有一个线程调用tryPush()，一个线程调用tryPop()。
+ *
+ * @tparam T 元素类型，需要可默认构造和移动赋值
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量，向上取整到2的幂
+     */
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_ = std::make_unique<T[]>(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief 入队，只能由生产者线程调用
+     * @param value 要入队的元素，成功时被移走
+     * @return 队列已满返回false，value保持不变
+     */
+    bool tryPush(T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 出队，只能由消费者线程调用
+     * @param value 输出出队的元素
+     * @return 队列为空返回false
+     */
+    bool tryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 获取容量
+     */
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};     // 下一个出队位置，只由消费者修改
+    alignas(64) std::atomic<size_t> tail_{0};     // 下一个入队位置，只由生产者修改
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_SPSC_QUEUE_HPP
@@ -0,0 +1,129 @@
+#ifndef WEBSERVER_STATIC_FILE_HANDLER_HPP
+#define WEBSERVER_STATIC_FILE_HANDLER_HPP
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include "ContentCache.hpp"
+#include "HttpStatus.hpp"
+#include "OpenFileCache.hpp"
+#include "http/HttpHeaders.hpp"
+
+namespace webserver {
+
+/**
+ * @struct StaticFileOptions
+ * @brief 静态文件处理器的缓存参数
+ */
+struct StaticFileOptions {
+    size_t openFileCacheEntries = 1024;                              // 打开文件缓存的容量
+    std::chrono::milliseconds revalidateInterval{1000};              // 打开文件缓存重新校验元数据的间隔
+    off_t readaheadThreshold = 1024 * 1024;                          // 不小于该大小的文件启用顺序预读提示
+    size_t memoryCacheBytes = 32 * 1024 * 1024;                      // 内存内容缓存的总字节数，0表示不缓存
+    size_t memoryCacheMaxFileSize = 64 * 1024;                       // 可放入内存内容缓存的最大文件大小
+    int keepAliveTimeout = 5;                                        // 预先生成的Keep-Alive头中的超时秒数
+};
+
+/**
+ * @class StaticFileHandler
+ * @brief 把URL前缀映射到目录的静态文件处理器
+ *
+ * 小文件连同序列化好的响应头缓存在内存中，命中时不再格式化也不再访问文件；
+ * 其余文件只生成响应头，内容由连接以sendfile直接从页缓存发送到套接字。
+ * 支持GET、HEAD以及If-None-Match、If-Modified-Since条件请求。线程安全。
+ */
+class StaticFileHandler {
+public:
+    /**
+     * @struct Result
+     * @brief 处理结果
+     */
+    struct Result {
+        HttpStatus status = HttpStatus::OK;
+        std::map<std::string, std::string> headers;   // Content-Type、Content-Length、Last-Modified等
+        std::string body;                             // 错误响应的内容
+        std::shared_ptr<const OpenFile> file;         // 需要发送的文件，HEAD、304和错误响应为空
+        std::shared_ptr<const CachedResponse> cached; // 命中内存缓存时为完整的响应，此时忽略以上字段
+    };
+
+    /**
+     * @brief 构造函数
+     * @param urlPrefix URL前缀（如"/static"）
+     * @param rootDirectory 文件所在目录
+     * @param options 缓存参数
+     */
+    StaticFileHandler(const std::string& urlPrefix, const std::string& rootDirectory,
+                      const StaticFileOptions& options = StaticFileOptions());
+
+    /**
+     * @brief 请求路径是否属于本处理器
+     * @param path 请求路径（不含查询字符串）
+     * @return 路径以URL前缀开头时返回true
+     */
+    bool matches(const std::string& path) const;
+
+    /**
+     * @brief 处理请求
+     * @param method 请求方法
+     * @param path 请求路径
+     * @param requestHeaders 请求头
+     * @return 处理结果
+     */
+    Result handle(const std::string& method, const std::string& path, const HttpHeaders& requestHeaders);
+
+    /**
+     * @brief 获取打开文件缓存的统计
+     */
+    OpenFileCache::Stats getCacheStats() const { return cache_.getStats(); }
+
+    /**
+     * @brief 获取内存内容缓存的统计
+     */
+    ContentCache::Stats getContentCacheStats() const { return contentCache_.getStats(); }
+
+    /**
+     * @brief 获取文件变化通知描述符，可读时调用processFileEvents()
+     * @return 描述符，内存内容缓存被禁用时返回-1
+     */
+    int fileEventFd() const { return contentCache_.notifyFd(); }
+
+    /**
+     * @brief 处理文件变化通知，使对应的内存缓存项和打开文件缓存项失效
+     */
+    void processFileEvents();
+
+    /**
+     * @brief 根据扩展名获取Content-Type
+     * @param path 文件路径
+     * @return Content-Type，未知扩展名返回application/octet-stream
+     */
+    static std::string contentTypeFor(const std::string& path);
+
+private:
+    /**
+     * @brief 把URL路径转换为文件系统路径
+     * @param path 请求路径
+     * @param filePath 输出的文件系统路径
+     * @return 路径非法（包含..、NUL或错误的百分号编码）时返回false
+     */
+    bool resolvePath(const std::string& path, std::string& filePath) const;
+
+    /**
+     * @brief 把小文件读入内存并生成两份响应头，放入内存内容缓存
+     * @param file 已打开的文件
+     * @param contentType Content-Type
+     * @return 缓存的响应，文件过大、读取失败或在读取期间被修改时返回nullptr
+     */
+    std::shared_ptr<const CachedResponse> loadIntoMemory(const OpenFile& file, const std::string& contentType);
+
+    std::string urlPrefix_;                       // URL前缀，不以'/'结尾
+    std::string rootDirectory_;                   // 文件目录，不以'/'结尾
+    int keepAliveTimeout_;                        // 预先生成的Keep-Alive头中的超时秒数
+    OpenFileCache cache_;                         // 打开文件缓存
+    ContentCache contentCache_;                   // 小文件内存内容缓存
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_STATIC_FILE_HANDLER_HPP
@@ -0,0 +1,136 @@
+#ifndef WEBSERVER_TIMING_WHEEL_HPP
+#define WEBSERVER_TIMING_WHEEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace webserver {
+
+/**
+ * @struct TimerNode
+ * @brief 嵌入在被计时对象中的定时器节点（侵入式双向链表）
+ *
+ * 节点析构时会自动从时间轮中摘除，拥有者无需在释放前显式取消。
+ */
+struct TimerNode {
+    TimerNode* prev = nullptr;
+    TimerNode* next = nullptr;
+    uint64_t expiry = 0;                          // 到期的tick
+    void* owner = nullptr;                        // 拥有该节点的对象，到期回调中使用
+
+    TimerNode() = default;
+    ~TimerNode() { unlink(); }
+
+    // 节点的地址会被链表引用，禁止拷贝
+    TimerNode(const TimerNode&) = delete;
+    TimerNode& operator=(const TimerNode&) = delete;
+
+    /**
+     * @brief 节点是否已挂在时间轮上
+     */
+    bool armed() const { return prev != nullptr; }
+
+    /**
+     * @brief 从所在链表中摘除
+     */
+    void unlink() {
+        if (prev) {
+            prev->next = next;
+            next->prev = prev;
+            prev = nullptr;
+            next = nullptr;
+        }
+    }
+};
+
+/**
+ * @class TimingWheel
+ * @brief 分层时间轮，插入、重新设置和取消定时器都是O(1)
+ *
+ * 共kLevels层，每层kSlots个槽，第l层每个槽覆盖kSlots^l个tick。
+ * 推进时只访问当前tick对应的槽，高层槽在低层转完一圈时逐级下放，
+ * 因此只有真正到期的定时器会被访问。
+ * 不是线程安全的，由所属Reactor的事件循环线程使用。
+ */
+class TimingWheel {
+public:
+    using ExpiryCallback = std::function<void(TimerNode& node)>;
+
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kSlots = 1u << kSlotBits;
+    static constexpr unsigned kLevels = 4;
+    static constexpr uint64_t kMaxDelay = (uint64_t(1) << (kSlotBits * kLevels)) - 1;
+
+    /**
+     * @brief 构造函数
+     * @param currentTick 起始tick
+     */
+    explicit TimingWheel(uint64_t currentTick = 0);
+
+    /**
+     * @brief 析构函数，摘除所有仍挂在时间轮上的节点
+     */
+    ~TimingWheel();
+
+    // 槽中的哨兵节点地址不能改变，禁止拷贝
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    /**
+     * @brief 设置（或重新设置）定时器
+     *
+     * 已到期的时间会在下一个tick触发，超过kMaxDelay的时间会被截断。
+     *
+     * @param node 定时器节点
+     * @param expiryTick 到期的tick
+     */
+    void schedule(TimerNode& node, uint64_t expiryTick);
+
+    /**
+     * @brief 取消定时器
+     * @param node 定时器节点
+     */
+    void cancel(TimerNode& node);
+
+    /**
+     * @brief 推进到指定tick，对到期的定时器调用回调
+     *
+     * 回调执行前节点已被摘除，回调中可以重新设置它或取消其他定时器。
+     *
+     * @param nowTick 当前tick
+     * @param callback 到期回调
+     * @return 触发的定时器数量
+     */
+    size_t advance(uint64_t nowTick, const ExpiryCallback& callback);
+
+    /**
+     * @brief 获取时间轮当前所在的tick
+     */
+    uint64_t currentTick() const { return currentTick_; }
+
+    /**
+     * @brief 获取已设置的定时器数量
+     */
+    size_t size() const { return size_; }
+
+private:
+    /**
+     * @brief 按到期时间把节点挂到对应层的槽上
+     */
+    void insert(TimerNode& node);
+
+    /**
+     * @brief 把第level层当前槽中的节点重新分配到更低的层
+     */
+    void cascade(unsigned level);
+
+    std::array<std::array<TimerNode, kSlots>, kLevels> slots_;  // 各槽的哨兵节点
+    uint64_t currentTick_;                        // 已处理到的tick
+    size_t size_;                                 // 已设置的定时器数量
+};
+
+} // namespace webserver
+
+#endif // WEBSERVER_TIMING_WHEEL_HPP
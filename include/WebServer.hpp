@@ -5,22 +5,82 @@
 #include <map>
 #include <functional>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
+#include "Connection.hpp"
 #include "ConnectionManager.hpp"
+#include "EventLoop.hpp"
+#include "Reactor.hpp"
+#include "ThreadPool.hpp"
 #include "Router.hpp"
 #include "Config.hpp"
 #include "HttpStatus.hpp"
 #include "HttpParser.hpp"
+#include "Listener.hpp"
+#include "StaticFileHandler.hpp"
+#include "http/HttpHeaders.hpp"
+#include "http/HttpResponse.hpp"
 
 namespace webserver {
 
 /**
  * @class WebServer
  * @brief Web服务器的主类，负责处理HTTP请求和管理连接
+ *
+ * 服务器运行 server.reactor_count 个Reactor（默认等于CPU核数），每个Reactor是一个
+ * 边缘触发的epoll事件循环，拥有自己的SO_REUSEPORT监听套接字和连接集合；
+ * 也可以配置为所有Reactor以EPOLLEXCLUSIVE方式共享一个监听套接字。
+ * server.listeners 可以配置多个监听地址（IPv4、IPv6/双栈、Unix域套接字），
+ * Unix域套接字不支持SO_REUSEPORT分发，总是由所有Reactor共享。
+ * server.io_backend 为 io_uring 时，accept/recv/send/close 改由每个Reactor的io_uring实例完成，
+ * 完成通知经eventfd接入同一个事件循环。
+ * 每个连接按 读取 -> 解析 -> 路由 -> 写回 的状态机推进，
+ * 只有标记为offload的路由处理函数会交给工作线程池执行。
  */
 class WebServer {
 public:
+    /**
+     * @struct IoStats
+     * @brief I/O统计，用于比较不同I/O后端的系统调用开销
+     */
+    struct IoStats {
+        uint64_t requests = 0;   // 已处理的请求数
+        uint64_t syscalls = 0;   // 事件循环和连接I/O的系统调用次数
+        uint64_t readPauses = 0; // 因客户端接收过慢、输出积压超过高水位而暂停读取的次数
+        uint64_t zeroCopySends = 0;       // MSG_ZEROCOPY发送次数
+        uint64_t zeroCopyCompletions = 0; // 已完成并释放缓冲区的零拷贝发送数
+        uint64_t zeroCopyCopied = 0;      // 内核回退为复制的完成通知数
+        uint64_t fairnessYields = 0;      // 连接用完每轮处理预算、让出事件循环的次数
+    };
+
+    /**
+     * @struct IdleStats
+     * @brief 空闲保活连接的统计
+     *
+     * 保活连接在两个请求之间释放输入缓冲区和解析器的临时容量，只保留连接上下文本身，
+     * bytes是这些连接仍占用的内存之和（不含TLS会话和内核套接字缓冲区）。
+     */
+    struct IdleStats {
+        uint64_t connections = 0;  // 空闲保活连接数
+        uint64_t bytes = 0;        // 空闲保活连接占用的内存
+    };
+
+    /**
+     * @struct ListenStats
+     * @brief 监听套接字统计，用于观察连接洪峰下accept是否跟得上
+     */
+    struct ListenStats {
+        uint64_t accepted = 0;             // 已accept的连接数
+        uint64_t acceptQueueLength = 0;    // 各监听套接字当前全连接队列长度之和
+        uint64_t acceptQueueLimit = 0;     // 各监听套接字全连接队列上限之和
+        uint64_t listenOverflows = 0;      // 服务器启动以来全连接队列溢出次数（TcpExt ListenOverflows）
+        uint64_t listenDrops = 0;          // 服务器启动以来监听套接字丢弃的SYN数（TcpExt ListenDrops）
+    };
+
     /**
      * @brief 构造函数
      * @param config 服务器配置
@@ -33,13 +93,13 @@ public:
     ~WebServer();
 
     /**
-     * @brief 启动服务器
+     * @brief 启动服务器并在当前线程运行事件循环，直到stop()被调用
      * @return 启动成功返回true，否则返回false
      */
     bool start();
     
     /**
-     * @brief 停止服务器
+     * @brief 停止服务器（线程安全，可在信号处理函数中调用）
      */
     void stop();
     
@@ -47,15 +107,464 @@ public:
      * @brief 添加路由处理函数
      * @param path URL路径
      * @param handler 处理该路径的函数
+     * @param offload 为true时处理函数在工作线程池中执行，不阻塞事件循环
+     */
+    void addRoute(const std::string& path, Router::RequestHandler handler, bool offload = false);
+
+    /**
+     * @brief 添加上传路由，请求体超过server.body_memory_limit后转存到临时文件
+     * @param path URL路径
+     * @param handler 处理该路径的函数，通过SpooledBody读取请求体
+     * @param offload 为true时处理函数在工作线程池中执行，不阻塞事件循环
+     */
+    void addUploadRoute(const std::string& path, Router::UploadHandler handler, bool offload = false);
+
+    /**
+     * @brief 添加流式路由，请求体随到随交给处理函数创建的BodyConsumer，不在服务器中缓存
+     * @param path URL路径
+     * @param handler 为每个请求创建BodyConsumer的函数，在事件循环线程中调用
+     */
+    void addStreamRoute(const std::string& path, Router::StreamHandler handler);
+
+    /**
+     * @brief 添加静态文件路由，需在start()之前调用
+     *
+     * 以urlPrefix开头的请求直接由对应目录下的文件响应，优先于addRoute添加的路由。
+     * 打开文件缓存的参数取自 server.static_cache_entries、server.static_revalidate_ms
+     * 和 server.static_readahead_threshold；小文件内存缓存的参数取自
+     * server.static_memory_cache_bytes 和 server.static_memory_cache_max_file_size，
+     * 文件变化通知由0号Reactor处理。
+     *
+     * @param urlPrefix URL前缀
+     * @param rootDirectory 文件所在目录
+     */
+    void addStaticRoute(const std::string& urlPrefix, const std::string& rootDirectory);
+
+    /**
+     * @brief 是否使用io_uring后端（配置了io_uring但内核不支持时会回退到epoll）
+     * @return 使用io_uring时返回true
+     */
+    bool isIoUringEnabled() const { return useIoUring_; }
+
+    /**
+     * @brief 获取I/O统计（线程安全）
+     * @return 请求数和系统调用次数
+     */
+    IoStats getIoStats() const;
+
+    /**
+     * @brief 获取空闲保活连接的数量和内存占用（线程安全）
+     * @return 连接数和字节数
+     */
+    IdleStats getIdleStats() const;
+
+    /**
+     * @brief 获取按当前连接占用率生效的保活参数（线程安全）
+     * @return 保活超时、最大请求数和占用率
+     */
+    ConnectionManager::KeepAliveLimits getKeepAliveLimits() const;
+
+    /**
+     * @brief 获取监听套接字统计（线程安全）
+     *
+     * 溢出计数来自 /proc/net/netstat，是本网络命名空间内所有监听套接字的合计。
+     *
+     * @return accept数量、全连接队列长度和溢出计数
+     */
+    ListenStats getListenStats() const;
+
+    /**
+     * @brief 获取所有静态文件路由的内存内容缓存统计之和（线程安全）
+     * @return 命中、未命中、淘汰和失效次数
      */
-    void addRoute(const std::string& path, Router::RequestHandler handler);
+    ContentCache::Stats getStaticCacheStats() const;
 
 private:
     /**
-     * @brief 处理客户端连接
-     * @param clientSocket 客户端套接字描述符
+     * @brief 创建并开始监听一个TCP套接字
+     *
+     * 按配置设置监听队列长度（server.listen_backlog）、TCP_DEFER_ACCEPT和TCP_FASTOPEN。
+     *
+     * @param spec 监听地址
+     * @param reusePort 是否设置SO_REUSEPORT
+     * @return 监听套接字，失败返回-1
+     */
+    int createListenSocket(const ListenerSpec& spec, bool reusePort);
+
+    /**
+     * @brief 为所有监听地址创建套接字并分配给各Reactor
+     * @return 全部成功返回true，任一失败时关闭已创建的套接字并返回false
+     */
+    bool openListeners();
+
+    /**
+     * @brief 关闭所有监听套接字，删除Unix域套接字文件
+     */
+    void closeListeners();
+
+    /**
+     * @brief 监听地址是否由所有Reactor共享同一个套接字
+     * @param listener 监听地址下标
+     * @return 共享时返回true
+     */
+    bool isSharedListener(size_t listener) const;
+
+    /**
+     * @brief 为SO_REUSEPORT组挂载按CPU分发连接的BPF程序
+     * @param listenFd 组内任意一个监听套接字
+     * @param groupSize 组内套接字数量
+     * @return 挂载成功返回true
      */
-    void handleConnection(int clientSocket);
+    bool attachCpuSteeringProgram(int listenFd, size_t groupSize);
+
+    /**
+     * @brief 为每个Reactor创建io_uring实例，注册固定文件表、提供缓冲区环和eventfd
+     * @return 全部成功返回true，任一失败时释放已创建的实例并返回false
+     */
+    bool setupIoUring();
+
+    /**
+     * @brief 提交多发accept请求
+     * @param reactor 接受连接的Reactor
+     * @param listener 监听地址下标
+     */
+    void armAccept(Reactor& reactor, size_t listener);
+
+    /**
+     * @brief 提交使用提供缓冲区的多发recv请求
+     * @param conn 连接上下文
+     */
+    void armRecv(Connection& conn);
+
+    /**
+     * @brief 提交sendmsg请求发送输出队列中的内存段（同一时刻每个连接最多一个发送请求）
+     * @param conn 连接上下文
+     * @return 无法获取提交队列项时返回false
+     */
+    bool submitSend(Connection& conn);
+
+    /**
+     * @brief 处理io_uring的所有完成项
+     * @param reactor 完成项所属的Reactor
+     */
+    void handleRingCompletions(Reactor& reactor);
+
+    /**
+     * @brief 为io_uring接受的新连接分配固定文件下标并开始接收
+     * @param reactor 接受连接的Reactor
+     * @param clientSocket 新连接的套接字
+     */
+    void handleRingAccept(Reactor& reactor, int clientSocket);
+
+    /**
+     * @brief 处理sendmsg完成项，推进连接状态机
+     * @param conn 连接上下文
+     * @param result 完成项的结果
+     */
+    void handleRingSend(Connection& conn, int result);
+
+    /**
+     * @brief 处理recv完成项，把提供缓冲区中的数据复制到输入缓冲区
+     * @param conn 连接上下文
+     * @param result 完成项的结果
+     * @param flags 完成项的标志
+     */
+    void handleRingRecv(Connection& conn, int result, uint32_t flags);
+
+    /**
+     * @brief 连接的所有io_uring请求完成后释放固定文件下标和连接
+     * @param conn 已关闭的连接
+     */
+    void releaseRingConnection(Connection& conn);
+
+    /**
+     * @brief 事件循环退出后取消所有io_uring请求并等待其完成
+     * @param reactor 要清理的Reactor
+     */
+    void drainRing(Reactor& reactor);
+
+    /**
+     * @brief 获取Reactor时间轮的当前tick（从1开始）
+     * @param reactor 时间轮所属的Reactor
+     * @return 当前tick
+     */
+    uint64_t currentTick(const Reactor& reactor) const;
+
+    /**
+     * @brief 推进Reactor的时间轮并关闭超时的连接
+     * @param reactor 要推进的Reactor
+     */
+    void handleTimerTick(Reactor& reactor);
+
+    /**
+     * @brief 根据连接当前所处的阶段重新设置其超时定时器
+     *
+     * 握手、空闲、保活、读取请求头、读取请求体和发送响应各有各的时限，连接每次有活动后调用。
+     * 进入两个请求之间的保活等待时顺便停放连接。
+     *
+     * @param conn 连接上下文
+     */
+    void refreshConnectionTimer(Connection& conn);
+
+    /**
+     * @brief 判断连接当前所处的超时阶段
+     * @param conn 连接上下文
+     * @return 定时器阶段
+     */
+    static TimerPhase timerPhase(const Connection& conn);
+
+    /**
+     * @brief 按最低速率计算已传输的字节数可以换来的额外时间
+     * @param bytes 当前阶段已传输的字节数
+     * @param minRate 最低速率（字节/秒），0表示不检查
+     * @return 额外的tick数
+     */
+    uint64_t rateAllowanceTicks(uint64_t bytes, uint64_t minRate) const;
+
+    /**
+     * @brief 把秒数换算成时间轮的tick数，至少为1秒
+     */
+    uint64_t secondsToTicks(int seconds) const;
+
+    /**
+     * @brief 计算保活连接下一次定时器到期的tick
+     *
+     * 保活超时随连接占用率变化，启用自适应时至少每秒重新检查一次，
+     * 压力上升时已经在等待的连接也会按收缩后的超时关闭。
+     *
+     * @param conn 处于KEEP_ALIVE阶段的连接
+     * @param now 当前tick
+     * @return 到期tick，不晚于now表示已经超时
+     */
+    uint64_t keepAliveDeadline(const Connection& conn, uint64_t now) const;
+
+    /**
+     * @brief 停放空闲保活连接：输入缓冲区归还给Reactor，释放解析器的临时容量，并计入空闲统计
+     * @param conn 连接上下文
+     */
+    void parkConnection(Connection& conn);
+
+    /**
+     * @brief 连接有数据到达或被关闭时结束停放，未关闭时从Reactor取回一个输入缓冲区
+     * @param conn 连接上下文
+     */
+    void unparkConnection(Connection& conn);
+
+    /**
+     * @brief 估算连接在用户态占用的内存
+     * @param conn 连接上下文
+     * @return 连接上下文和各缓冲区已分配容量之和
+     */
+    static size_t connectionMemory(const Connection& conn);
+
+    /**
+     * @brief 判断连接是否还有未发送完的数据
+     * @param conn 连接上下文
+     * @return 有未发送完的数据时返回true
+     */
+    static bool hasPendingOutput(const Connection& conn);
+
+    /**
+     * @brief 在当前线程运行Reactor的事件循环，退出后释放其连接
+     * @param reactor 要运行的Reactor
+     */
+    void runReactor(Reactor& reactor);
+
+    /**
+     * @brief 接受监听套接字上待处理的连接
+     *
+     * 每次最多accept server.accept_batch 个连接，达到上限时把剩余的留到下一轮，
+     * 避免连接洪峰时已有连接上的请求得不到处理。
+     *
+     * @param reactor 接受连接的Reactor
+     * @param listener 监听地址下标
+     */
+    void handleAccept(Reactor& reactor, size_t listener);
+
+    /**
+     * @brief 处理客户端连接上的I/O事件，推进连接状态机
+     * @param conn 连接上下文
+     * @param events 就绪的epoll事件
+     */
+    void handleConnection(Connection& conn, uint32_t events);
+
+    /**
+     * @brief 推进非阻塞TLS握手
+     * @param conn 连接上下文
+     * @return 握手失败返回false
+     */
+    bool doHandshake(Connection& conn);
+
+    /**
+     * @brief 读取套接字上所有可读数据到输入缓冲区
+     * @param conn 连接上下文
+     * @return 读取出错返回false
+     */
+    bool readFromConnection(Connection& conn);
+
+    /**
+     * @brief 依次处理输入缓冲区中的完整请求，这一批请求的响应处理完后一起发送
+     * @param conn 连接上下文
+     */
+    void processRequests(Connection& conn);
+
+    /**
+     * @brief 按顺序解析并执行输入缓冲区中的每个完整请求，直到请求不完整、连接离开READING状态
+     *        或用完本轮的处理预算
+     * @param conn 连接上下文
+     */
+    void dispatchRequests(Connection& conn);
+
+    /**
+     * @brief 本轮处理预算用完时让出事件循环，剩余请求在其他连接的本轮事件处理之后继续
+     * @param conn 连接上下文
+     */
+    void yieldConnection(Connection& conn);
+
+    /**
+     * @brief 推进当前请求的解析，请求头收全后按路由选择请求体的接收方式
+     *
+     * 已经交给上传文件或BodyConsumer的请求体字节会立即从输入缓冲区删除。
+     *
+     * @param conn 连接上下文
+     * @return 解析状态，不会返回HEADERS_COMPLETE
+     */
+    HttpRequestParser::Status parseRequest(Connection& conn);
+
+    /**
+     * @brief 请求头收全后，为上传路由和流式路由设置请求体的接收者
+     * @param conn 连接上下文
+     */
+    void beginRequestBody(Connection& conn);
+
+    /**
+     * @brief 发送错误响应，发送完毕后关闭连接
+     * @param conn 连接上下文
+     * @param status 响应状态码
+     */
+    void sendErrorResponse(Connection& conn, HttpStatus status);
+
+    /**
+     * @brief 根据路由结果构建响应并放入输出队列
+     *
+     * 响应头和内容作为两个独立的段入队，内容不经过拼接复制。
+     *
+     * @param conn 连接上下文
+     * @param headers 请求头
+     * @param found 是否找到路由
+     * @param content 路由处理函数返回的内容
+     */
+    void sendResponse(Connection& conn, const HttpHeaders& headers, bool found, std::string content);
+
+    /**
+     * @brief 把静态文件处理结果放入输出队列，文件内容在响应头之后发送
+     * @param conn 连接上下文
+     * @param result 静态文件处理结果
+     */
+    void sendStaticResponse(Connection& conn, StaticFileHandler::Result result);
+
+    /**
+     * @brief 为响应添加Connection和Keep-Alive头
+     * @param conn 连接上下文
+     * @param response 响应
+     */
+    void addConnectionHeaders(const Connection& conn, HttpResponse& response) const;
+
+    /**
+     * @brief 发送已放入输出队列的响应，并根据结果推进连接状态
+     *
+     * 处理一批流水线请求期间，只要不需要关闭连接且积压未超过高水位就暂不发送，由processRequests()在批次结束后统一发送。
+     *
+     * @param conn 连接上下文
+     */
+    void finishResponse(Connection& conn);
+
+    /**
+     * @brief 发送有进展后检查WRITING状态的连接：需要关闭的发送完后关闭，
+     *        因积压暂停的在回落到低水位后恢复读取并继续处理已收到的请求
+     * @param conn 连接上下文
+     */
+    void resumeAfterWrite(Connection& conn);
+
+    /**
+     * @brief 输出积压超过高水位时暂停读取
+     * @param conn 连接上下文
+     */
+    void pauseReading(Connection& conn);
+
+    /**
+     * @brief 把队首文件段的下一部分读入内存，作为内存段放回队首
+     *
+     * 只在无法使用sendfile时使用（TLS连接和io_uring后端）。
+     *
+     * @param conn 连接上下文
+     * @return 读取出错或文件被截断时返回false
+     */
+    static bool fillFromFile(Connection& conn);
+
+    /**
+     * @brief 尽可能多地发送输出队列中的数据，内存段聚集成一次sendmsg
+     * @param conn 连接上下文
+     * @return 发送出错返回false
+     */
+    bool flushOutput(Connection& conn);
+
+    /**
+     * @brief flushOutput的发送循环，需要多次系统调用时先设置TCP_CORK
+     * @param conn 连接上下文
+     * @return 发送出错返回false
+     */
+    bool writeOutput(Connection& conn);
+
+    /**
+     * @brief 设置或解除连接的TCP_CORK
+     * @param conn 连接上下文
+     * @param enabled true为塞住，false为解除并发出积攒的数据
+     */
+    static void setCork(Connection& conn, bool enabled);
+
+    /**
+     * @brief 对达到阈值的发送启用MSG_ZEROCOPY，首次使用时设置SO_ZEROCOPY
+     * @param conn 连接上下文
+     * @param bytes 本次要发送的字节数
+     * @return 本次发送是否使用零拷贝
+     */
+    bool useZeroCopy(Connection& conn, size_t bytes) const;
+
+    /**
+     * @brief 读取套接字错误队列中的零拷贝完成通知，释放已完成发送的缓冲区
+     * @param conn 连接上下文
+     * @return 套接字上有真正的错误时返回false
+     */
+    static bool reapZeroCopyCompletions(Connection& conn);
+
+    /**
+     * @brief 关闭时仍有未完成的零拷贝发送：只关闭写方向并保留套接字，等待完成通知后再释放缓冲区
+     * @param conn 已关闭的连接
+     */
+    void lingerForZeroCopy(Connection& conn);
+
+    /**
+     * @brief 零拷贝发送全部完成或等待超时后关闭套接字并释放连接
+     * @param conn 等待零拷贝完成通知的连接
+     * @param abort 是否以RST中止，丢弃发送队列使内核立即释放对缓冲区的引用
+     */
+    void releaseLingeringConnection(Connection& conn, bool abort);
+
+    /**
+     * @brief 关闭连接并释放其资源
+     * @param conn 连接上下文
+     */
+    void closeConnection(Connection& conn);
+
+    /**
+     * @brief 查找仍然存活的连接
+     * @param reactor 连接所属的Reactor
+     * @param socket 套接字描述符
+     * @param id 连接序号
+     * @return 连接存在且序号一致时返回其指针，否则返回nullptr
+     */
+    Connection* findConnection(Reactor& reactor, int socket, uint64_t id);
 
     /**
      * @brief 初始化SSL上下文
@@ -69,11 +578,51 @@ private:
     void cleanupSSL();
 
     int port_;                   // 服务器端口
-    bool running_;               // 服务器运行状态
+    std::atomic<bool> running_;  // 服务器运行状态
     std::unique_ptr<ConnectionManager> connectionManager_;  // 连接管理器
     std::unique_ptr<Router> router_;                       // 路由器
+    std::vector<std::unique_ptr<StaticFileHandler>> staticHandlers_;  // 静态文件路由
     Config config_;              // 服务器配置
     SSL_CTX* sslContext_;        // SSL上下文
+
+    std::vector<std::unique_ptr<Reactor>> reactors_;        // 所有Reactor，构造后数量不变
+    std::vector<ListenerSpec> listeners_;                   // 监听地址
+    std::vector<int> listenSockets_;                        // 已创建的所有监听套接字
+    bool exclusiveListener_;                                // 是否使用EPOLLEXCLUSIVE共享监听套接字
+    bool cpuSteering_;                                      // 是否按CPU分发连接并绑定Reactor线程
+    bool useIoUring_;                                       // 是否使用io_uring后端
+    std::unique_ptr<ThreadPool> workerPool_;                // 执行offload路由的工作线程池
+    std::atomic<uint64_t> nextConnectionId_;                // 下一个连接序号
+
+    std::chrono::milliseconds timerTick_;                   // 时间轮的tick长度
+    uint64_t idleTimeoutTicks_;                             // 连接无活动的超时（server.timeout）
+    int keepAliveTimeoutSeconds_;                           // 配置的保活超时秒数，与静态文件缓存中预先生成的响应头一致
+    uint64_t handshakeTimeoutTicks_;                        // 从连接建立到TLS握手完成的时限
+    uint64_t headerTimeoutTicks_;                           // 从请求第一个字节到请求头收全的时限
+    uint64_t bodyTimeoutTicks_;                             // 从请求头收全到请求体收全的基础时限
+    uint64_t drainTimeoutTicks_;                            // 响应开始积压到发送完的基础时限
+    uint64_t minBodyRate_;                                  // 请求体的最低平均速率（字节/秒），0表示不检查
+    uint64_t minSendRate_;                                  // 发送响应的最低平均速率（字节/秒），0表示不检查
+
+    int listenBacklog_;                                     // 监听队列长度（内核会截断到somaxconn）
+    int deferAcceptSeconds_;                                // TCP_DEFER_ACCEPT等待首个数据包的秒数，0表示不启用
+    int fastOpenQueue_;                                     // TCP_FASTOPEN等待队列长度，0表示不启用
+    bool tcpNoDelay_;                                       // 监听套接字设置TCP_NODELAY，由连接继承
+    bool tcpCork_;                                          // 一次flush需要多次写入时用TCP_CORK合并报文
+    int socketSendBuffer_;                                  // SO_SNDBUF字节数，0表示使用内核自动调整
+    int socketReceiveBuffer_;                               // SO_RCVBUF字节数，0表示使用内核自动调整
+    size_t zeroCopyThreshold_;                              // 一次sendmsg达到该字节数时使用MSG_ZEROCOPY，0表示不启用
+    size_t acceptBatch_;                                    // 每轮最多accept的连接数
+    size_t fairnessMaxRequests_;                            // 每个连接每轮最多处理的请求数，0表示不限制
+    size_t fairnessMaxBytes_;                               // 每个连接每轮最多处理的请求字节数，0表示不限制
+    size_t outputHighWatermark_;                            // 输出积压超过该字节数时暂停读取和处理请求
+    size_t outputLowWatermark_;                             // 暂停后积压回落到该字节数以下时恢复
+    HttpRequestParser::Limits requestLimits_;               // 请求行、请求头和请求体的大小限制
+    size_t bodyMemoryLimit_;                                // 上传请求体在内存中的上限，超过后转存到临时文件
+    size_t maxUploadSize_;                                  // 上传路由和流式路由的请求体大小上限
+    std::string uploadTempDir_;                             // 上传临时文件所在的目录
+    uint64_t listenOverflowBase_;                           // 启动时的ListenOverflows计数
+    uint64_t listenDropBase_;                               // 启动时的ListenDrops计数
 };
 
 } // namespace webserver
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace webserver {
+
+/**
+ * @enum HttpHeader
+ * @brief 常用头部名称，查找这些头部时不需要比较字符串
+ */
+enum class HttpHeader : uint8_t {
+    UNKNOWN,
+    ACCEPT,
+    ACCEPT_CHARSET,
+    ACCEPT_ENCODING,
+    ACCEPT_LANGUAGE,
+    ALLOW,
+    AUTHORIZATION,
+    CACHE_CONTROL,
+    CONNECTION,
+    CONTENT_ENCODING,
+    CONTENT_LANGUAGE,
+    CONTENT_LENGTH,
+    CONTENT_TYPE,
+    COOKIE,
+    DATE,
+    ETAG,
+    EXPECT,
+    HOST,
+    IF_MATCH,
+    IF_MODIFIED_SINCE,
+    IF_NONE_MATCH,
+    IF_UNMODIFIED_SINCE,
+    KEEP_ALIVE,
+    LAST_MODIFIED,
+    LOCATION,
+    RANGE,
+    REFERER,
+    SERVER,
+    SET_COOKIE,
+    TE,
+    TRANSFER_ENCODING,
+    UPGRADE,
+    USER_AGENT,
+    VARY,
+    COUNT     ///< 枚举值个数，不是头部
+};
+
+/**
+ * @brief 不区分大小写地查找常用头部，使用编译期生成的完美哈希表，只做一次字符串比较
+ * @param name 头部名称
+ * @return 对应的枚举值，不是常用头部时返回UNKNOWN
+ */
+HttpHeader lookupHttpHeader(std::string_view name);
+
+/**
+ * @brief 获取常用头部的规范名称
+ * @param header 头部枚举值
+ * @return 头部名称，UNKNOWN返回空字符串
+ */
+std::string_view httpHeaderName(HttpHeader header);
+
+/**
+ * @brief 不区分大小写地比较头部名称或令牌值（只处理ASCII）
+ */
+bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
+/**
+ * @class HttpHeaders
+ * @brief 按出现顺序保存头部的扁平容器
+ *
+ * 头部名称不区分大小写，允许同名头部重复出现。常用头部通过HttpHeader枚举直接定位，
+ * 其他头部线性查找；请求和响应的头部通常只有十几个，连续存储比std::map更快。
+ */
+class HttpHeaders {
+public:
+    struct Entry {
+        std::string name;                         // 保留原始大小写
+        std::string value;
+        HttpHeader id;                            // 常用头部的枚举值，其他为UNKNOWN
+    };
+    using const_iterator = std::vector<Entry>::const_iterator;
+
+    /**
+     * @brief 追加一个头部，不检查是否已存在同名头部
+     */
+    void add(std::string name, std::string value);
+
+    /**
+     * @brief 设置头部：替换第一个同名头部的值并删除其余同名头部，不存在时追加
+     */
+    void set(std::string_view name, std::string value);
+
+    /**
+     * @brief 查找第一个同名头部
+     * @return 头部值，不存在返回nullptr
+     */
+    const std::string* find(std::string_view name) const;
+    const std::string* find(HttpHeader header) const;
+
+    /**
+     * @brief 获取第一个同名头部的值
+     * @return 头部值，不存在返回空字符串的引用
+     */
+    const std::string& get(std::string_view name) const;
+    const std::string& get(HttpHeader header) const;
+
+    bool contains(std::string_view name) const { return find(name) != nullptr; }
+    bool contains(HttpHeader header) const { return find(header) != nullptr; }
+
+    /**
+     * @brief 删除所有同名头部
+     * @return 删除的个数
+     */
+    size_t erase(std::string_view name);
+
+    void clear();
+    void reserve(size_t count) { entries_.reserve(count); }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+
+private:
+    static constexpr size_t kHeaderCount = static_cast<size_t>(HttpHeader::COUNT);
+
+    size_t position(std::string_view name, HttpHeader id) const;
+    void reindex();
+
+    std::vector<Entry> entries_;
+    std::array<uint32_t, kHeaderCount> index_{};  // 常用头部第一次出现的下标加1，0表示不存在
+};
+
+} // namespace webserver
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+
+namespace webserver {
+
+/**
+ * @enum HttpMethod
+ * @brief 支持的HTTP请求方法
+ */
+enum class HttpMethod {
+    UNKNOWN,
+    GET,
+    HEAD,
+    POST,
+    PUT,
+    DELETE,
+    OPTIONS,
+    PATCH,
+    TRACE,
+    CONNECT
+};
+
+/**
+ * @brief 解析请求方法，方法名区分大小写（RFC 9110）
+ * @param name 请求行中的方法名
+ * @return 对应的枚举值，不支持的方法返回UNKNOWN
+ */
+HttpMethod parseHttpMethod(std::string_view name);
+
+/**
+ * @brief 获取请求方法的名称
+ * @param method 请求方法
+ * @return 方法名，UNKNOWN返回空字符串
+ */
+std::string_view httpMethodName(HttpMethod method);
+
+} // namespace webserver
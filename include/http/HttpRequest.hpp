@@ -2,6 +2,8 @@
 
 #include <string>
 #include <map>
+#include "http/HttpHeaders.hpp"
+#include "http/HttpMethod.hpp"
 
 namespace webserver {
 
@@ -25,10 +27,25 @@ public:
                 const std::string& body,
                 const std::map<std::string, std::string>& queryParams = {});
 
+    /**
+     * @brief 构造函数，请求头直接移入
+     * @param method HTTP方法（GET/POST等）
+     * @param path 请求路径
+     * @param headers 请求头
+     * @param body 请求体
+     * @param queryParams 查询参数
+     */
+    HttpRequest(const std::string& method,
+                const std::string& path,
+                HttpHeaders headers,
+                const std::string& body,
+                const std::map<std::string, std::string>& queryParams = {});
+
     // 获取方法
     const std::string& getMethod() const;
+    HttpMethod getMethodType() const;
     const std::string& getPath() const;
-    const std::map<std::string, std::string>& getHeaders() const;
+    const HttpHeaders& getHeaders() const;
     const std::string& getBody() const;
     const std::map<std::string, std::string>& getQueryParams() const;
 
@@ -37,6 +54,7 @@ public:
      * @param headers 要设置的请求头
      */
     void setHeaders(const std::map<std::string, std::string>& headers);
+    void setHeaders(HttpHeaders headers);
 
     /**
      * @brief 设置请求体
@@ -45,11 +63,12 @@ public:
     void setBody(const std::string& body);
 
     /**
-     * @brief 获取指定头部的值
+     * @brief 获取指定头部的值，名称不区分大小写
      * @param name 头部名称
      * @return 头部值，如果不存在则返回空字符串
      */
-    std::string getHeader(const std::string& name) const;
+    const std::string& getHeader(std::string_view name) const;
+    const std::string& getHeader(HttpHeader header) const;
 
     /**
      * @brief 获取指定查询参数的值
@@ -88,8 +107,9 @@ public:
 
 private:
     std::string method_;
+    HttpMethod methodType_;
     std::string path_;
-    std::map<std::string, std::string> headers_;
+    HttpHeaders headers_;
     std::string body_;
     std::map<std::string, std::string> queryParams_;
 };
@@ -3,6 +3,7 @@
 #include <string>
 #include <map>
 #include "HttpStatus.hpp"
+#include "http/HttpHeaders.hpp"
 
 namespace webserver {
 
@@ -15,26 +16,27 @@ public:
     /**
      * @brief 构造函数
      * @param statusCode HTTP状态码
-     * @param content 响应内容
+     * @param content 响应内容，传入右值时不复制
      * @param contentType 内容类型，默认为"text/html"
      */
     HttpResponse(HttpStatus statusCode, 
-                 const std::string& content,
+                 std::string content,
                  const std::string& contentType = "text/html");
 
     /**
-     * @brief 设置响应头
+     * @brief 设置响应头，已存在的同名头部（不区分大小写）被替换
      * @param name 头部名称
      * @param value 头部值
      */
-    void setHeader(const std::string& name, const std::string& value);
+    void setHeader(std::string_view name, std::string value);
 
     /**
-     * @brief 获取响应头
+     * @brief 获取响应头，名称不区分大小写
      * @param name 头部名称
      * @return 头部值，如果不存在则返回空字符串
      */
-    std::string getHeader(const std::string& name) const;
+    const std::string& getHeader(std::string_view name) const;
+    const std::string& getHeader(HttpHeader header) const;
 
     /**
      * @brief 构建HTTP响应字符串
@@ -48,10 +50,23 @@ public:
      */
     std::string buildChunked() const;
 
+    /**
+     * @brief 只构建状态行和响应头（含结尾空行），响应内容由调用者随后单独发送
+     * @param chunked 为true时去掉Content-Length并声明分块传输编码
+     * @return 状态行和响应头
+     */
+    std::string buildHead(bool chunked = false) const;
+
+    /**
+     * @brief 取走响应内容，用于把内容作为独立的缓冲区发送而不复制
+     * @return 响应内容，之后getContent()返回空字符串
+     */
+    std::string takeContent();
+
     // 获取方法
     HttpStatus getStatusCode() const;
     const std::string& getContent() const;
-    const std::map<std::string, std::string>& getHeaders() const;
+    const HttpHeaders& getHeaders() const;
     
     /**
      * @brief 获取响应体内容
@@ -73,7 +88,7 @@ public:
 private:
     HttpStatus statusCode_;
     std::string content_;
-    std::map<std::string, std::string> headers_;
+    HttpHeaders headers_;
 };
 
 } // namespace webserver
\ No newline at end of file
@@ -1,46 +1,166 @@
 #pragma once
 
-#include <thread>
+#include "HttpRequestParser.hpp"
+#include "SpscQueue.hpp"
+#include "http/HttpRequest.hpp"
+#include "http/HttpResponse.hpp"
 #include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+
+namespace webserver {
 
+class PipelinedConnectionHandler;
+
+/**
+ * @class HttpServer
+ * @brief 支持HTTP流水线的精简服务器
+ *
+ * 一个事件循环线程负责所有连接的接受、读取和写出（epoll边缘触发），固定数量的处理线程执行请求处理函数。
+ * 事件循环与每个处理线程之间各有一对无锁SPSC队列：请求带着连接编号和序号进入请求队列，
+ * 响应经响应队列回到事件循环，由连接按序号依次写出。线程数量与连接数量无关，空闲时所有线程都阻塞在
+ * epoll_wait或eventfd上，不会忙等。
+ */
 class HttpServer {
 public:
+    /**
+     * @brief 请求处理函数，在处理线程中调用
+     */
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
     /**
      * @brief 构造函数
-     * @param port 监听端口
+     * @param port 监听端口，0表示由内核选择，启动后通过port()获取
+     * @param handler 请求处理函数
+     * @param processors 处理线程数量
+     * @param backlog 监听队列长度（内核会截断到net.core.somaxconn）
      */
-    explicit HttpServer(int port);
-    
+    HttpServer(int port, Handler handler, size_t processors = 2, int backlog = SOMAXCONN);
+
     /**
      * @brief 析构函数
      */
     ~HttpServer();
-    
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
     /**
      * @brief 启动HTTP服务器
      * @throws std::runtime_error 如果启动失败
      */
     void start();
-    
+
     /**
-     * @brief 停止HTTP服务器
+     * @brief 停止HTTP服务器，关闭所有连接
      */
     void stop();
-    
+
+    /**
+     * @brief 获取实际监听的端口
+     */
+    int port() const { return port_; }
+
+    /**
+     * @brief 获取当前打开的连接数量
+     */
+    size_t connectionCount() const { return connectionCount_.load(std::memory_order_relaxed); }
+
 private:
     /**
-     * @brief 服务器主循环
+     * @struct Job
+     * @brief 从事件循环交给处理线程的请求
+     */
+    struct Job {
+        uint64_t connection = 0;                  // 连接编号，连接关闭后不会被复用
+        uint64_t sequence = 0;                    // 请求在连接内的序号
+        std::unique_ptr<HttpRequest> request;
+        bool keepAlive = true;                    // 为false时响应带上Connection: close，发送后关闭连接
+    };
+
+    /**
+     * @struct Result
+     * @brief 从处理线程交回事件循环的响应
+     */
+    struct Result {
+        uint64_t connection = 0;
+        uint64_t sequence = 0;
+        std::string response;
+    };
+
+    /**
+     * @struct Processor
+     * @brief 处理线程及其队列
+     */
+    struct Processor {
+        explicit Processor(size_t capacity) : jobs(capacity), results(capacity) {}
+
+        SpscQueue<Job> jobs;                      // 事件循环 -> 处理线程
+        SpscQueue<Result> results;                // 处理线程 -> 事件循环
+        int wakeFd = -1;                          // 通知处理线程有新请求的eventfd
+        size_t inFlight = 0;                      // 已派发但尚未取回响应的请求数，只由事件循环访问
+        bool needsWake = false;                   // 本轮事件处理中派发过请求，只由事件循环访问
+        std::thread thread;
+    };
+
+    /**
+     * @brief 事件循环
      */
     void run();
-    
-    /**
-     * @brief 处理客户端连接
-     * @param clientSocket 客户端socket
-     */
-    void handleConnection(int clientSocket);
-    
-    int port;
-    int serverSocket;
-    std::atomic<bool> running;
-    std::thread serverThread;
-};
\ No newline at end of file
+
+    /**
+     * @brief 处理线程的主循环
+     */
+    void process(Processor& processor);
+
+    /**
+     * @brief 接受所有等待中的连接
+     */
+    void acceptConnections();
+
+    /**
+     * @brief 把请求交给负载最轻的处理线程
+     * @return 所有处理线程的队列都已满时返回false
+     */
+    bool dispatch(uint64_t connection, uint64_t sequence, std::unique_ptr<HttpRequest>& request, bool keepAlive);
+
+    /**
+     * @brief 取回所有处理线程的响应并交给对应的连接
+     */
+    void collectResults();
+
+    /**
+     * @brief 连接结束时关闭并释放
+     */
+    void closeIfFinished(uint64_t id);
+
+    /**
+     * @brief 关闭并释放所有资源
+     */
+    void cleanup();
+
+    int port_;
+    Handler handler_;
+    size_t processorCount_;
+    int backlog_;
+    int serverSocket_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;                             // 处理线程完成请求或stop()时通知事件循环的eventfd
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> connectionCount_{0};
+    std::thread serverThread_;
+    std::vector<std::unique_ptr<Processor>> processors_;
+    std::unordered_map<uint64_t, std::unique_ptr<PipelinedConnectionHandler>> connections_;
+    std::vector<uint64_t> blocked_;               // 因处理线程已满而暂停派发的连接
+    uint64_t nextConnectionId_ = 2;               // 0和1留给监听套接字和eventfd
+    size_t nextProcessor_ = 0;
+    HttpRequestParser::Limits limits_;
+};
+
+} // namespace webserver
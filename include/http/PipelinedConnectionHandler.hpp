@@ -1,46 +1,125 @@
 #pragma once
 
-#include "HttpRequest.hpp"
-#include "HttpResponse.hpp"
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <atomic>
+#include "HttpRequestParser.hpp"
+#include "http/HttpRequest.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
 
+namespace webserver {
+
+/**
+ * @class PipelinedConnectionHandler
+ * @brief 支持流水线请求的客户端连接，由HttpServer的事件循环驱动，不占用专门的线程
+ *
+ * 每个完整请求按到达顺序分配序号后交给处理阶段，处理结果可能乱序返回；
+ * 连接按序号把已经完成的响应依次放入输出缓冲区，一次send写出。
+ * 客户端关闭连接、所有响应发送完毕后连接结束，不依赖固定的等待时间。
+ * 所有方法都只在事件循环线程中调用。
+ */
 class PipelinedConnectionHandler {
 public:
-    PipelinedConnectionHandler(int socket);
+    /**
+     * @brief 把请求交给处理阶段
+     *
+     * 参数是请求的序号、请求和连接是否在该请求之后保持；处理阶段已满时返回false且不取走请求，
+     * 连接暂停派发，之后由resume()重试。
+     */
+    using Dispatcher = std::function<bool(uint64_t sequence, std::unique_ptr<HttpRequest>& request, bool keepAlive)>;
+
+    /**
+     * @brief 构造函数
+     * @param socket 非阻塞的客户端套接字，析构时关闭
+     * @param dispatcher 把请求交给处理阶段的函数
+     * @param limits 请求解析限制
+     */
+    PipelinedConnectionHandler(int socket, Dispatcher dispatcher, const HttpRequestParser::Limits& limits);
+
+    /**
+     * @brief 析构函数，关闭套接字
+     */
     ~PipelinedConnectionHandler();
 
+    PipelinedConnectionHandler(const PipelinedConnectionHandler&) = delete;
+    PipelinedConnectionHandler& operator=(const PipelinedConnectionHandler&) = delete;
+
+    /**
+     * @brief 处理可读事件：读到EAGAIN为止，派发其中所有完整的请求
+     */
+    void onReadable();
+
+    /**
+     * @brief 处理可写事件：继续发送未写完的响应
+     */
+    void onWritable();
+
+    /**
+     * @brief 处理阶段返回了一个响应，按序号排队，前面的响应都完成后一起写出
+     * @param sequence 请求的序号
+     * @param response 完整的响应报文
+     */
+    void onResponse(uint64_t sequence, std::string response);
+
     /**
-     * @brief 启动管道化请求处理
+     * @brief 处理阶段有空位后继续派发被暂停的请求
      */
-    void start();
+    void resume();
 
     /**
-     * @brief 停止管道化请求处理
+     * @brief 是否因处理阶段已满而暂停派发
      */
-    void stop();
+    bool blocked() const { return blocked_ != nullptr; }
+
+    /**
+     * @brief 连接是否已经结束：出错，或客户端关闭（或要求关闭）且所有响应都已发送
+     */
+    bool finished() const;
+
+    /**
+     * @brief 获取客户端套接字
+     */
+    int socket() const { return socket_; }
 
 private:
-    // 请求处理线程函数
-    void requestProcessingThread();
-    void responseProcessingThread();
-
-    int clientSocket;
-    std::atomic<bool> running;
-
-    // 请求队列
-    std::queue<HttpRequest> requestQueue;
-    std::mutex requestMutex;
-    std::condition_variable requestCV;
-
-    // 响应队列
-    std::queue<HttpResponse> responseQueue;
-    std::mutex responseMutex;
-    std::condition_variable responseCV;
-
-    // 线程
-    std::thread requestThread;
-    std::thread responseThread;
-};
\ No newline at end of file
+    /**
+     * @brief 解析输入缓冲区中的完整请求并按顺序派发
+     */
+    void dispatchRequests();
+
+    /**
+     * @brief 把已完成的连续响应移入输出缓冲区并发送
+     */
+    void flush();
+
+    /**
+     * @brief 尚未发出的响应字节数（输出缓冲区中未发送的部分和已完成但排在后面的响应）
+     */
+    size_t outputBacklog() const { return output_.size() - outputSent_ + pendingBytes_; }
+
+    /**
+     * @brief 因输出积压暂停了读取，积压回落后恢复读取和派发
+     */
+    void resumeIfDrained();
+
+    int socket_;
+    Dispatcher dispatcher_;
+    HttpRequestParser parser_;
+    std::string input_;                           // 已读取但尚未解析成请求的数据
+    std::string output_;                          // 等待发送的响应
+    size_t outputSent_ = 0;                       // output_中已发送的字节数
+    std::deque<std::optional<std::string>> pending_; // 已派发请求的响应，按序号排列，空表示尚未完成
+    uint64_t firstPending_ = 0;                   // pending_第一个元素的序号
+    size_t pendingBytes_ = 0;                     // pending_中已完成响应的字节数
+    uint64_t nextSequence_ = 0;                   // 下一个请求的序号
+    std::unique_ptr<HttpRequest> blocked_;        // 处理阶段已满时暂存的请求
+    bool peerClosed_ = false;                     // 客户端已关闭写方向
+    bool closing_ = false;                        // 不再接受新请求（客户端要求关闭或请求非法）
+    bool failed_ = false;                         // 读写出错，连接应立即关闭
+    bool outputPaused_ = false;                   // 客户端不读取响应，积压超过上限后暂停读取和派发
+};
+
+} // namespace webserver
@@ -0,0 +1,208 @@
+#include "ChunkedDecoder.hpp"
+#include "HeaderScanner.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace webserver {
+
+namespace {
+// 块大小行（含块扩展）的最大长度
+constexpr size_t kMaxChunkSizeLine = 1024;
+
+std::string_view trimWhitespace(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+} // namespace
+
+ChunkedDecoder::ChunkedDecoder() = default;
+
+ChunkedDecoder::ChunkedDecoder(const Limits& limits) : limits_(limits) {}
+
+void ChunkedDecoder::reset() {
+    state_ = State::SIZE;
+    error_ = Error::NONE;
+    chunkRemaining_ = 0;
+    decoded_ = 0;
+    trailerBytes_ = 0;
+    scanned_ = 0;
+    trailers_.clear();
+}
+
+ChunkedDecoder::Status ChunkedDecoder::fail(Error error) {
+    state_ = State::ERROR;
+    error_ = error;
+    return Status::ERROR;
+}
+
+bool ChunkedDecoder::nextLine(std::string_view data, size_t start, size_t& lineEnd, size_t& next) {
+    // 跳过上次已经扫描过的部分
+    size_t from = start + scanned_;
+    const void* found = from < data.size() ? std::memchr(data.data() + from, '\n', data.size() - from) : nullptr;
+    if (!found) {
+        scanned_ = data.size() - start;
+        return false;
+    }
+    size_t newline = static_cast<size_t>(static_cast<const char*>(found) - data.data());
+    lineEnd = newline > start && data[newline - 1] == '\r' ? newline - 1 : newline;
+    next = newline + 1;
+    scanned_ = 0;
+    return true;
+}
+
+ChunkedDecoder::Status ChunkedDecoder::decode(std::string_view data, size_t& consumed, std::string_view& chunk) {
+    consumed = 0;
+    chunk = {};
+    while (true) {
+        size_t lineEnd = 0;
+        size_t next = 0;
+        switch (state_) {
+            case State::SIZE:
+                if (!nextLine(data, consumed, lineEnd, next)) {
+                    if (data.size() - consumed > kMaxChunkSizeLine) {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    return Status::NEED_MORE;
+                }
+                if (lineEnd - consumed > kMaxChunkSizeLine) {
+                    return fail(Error::BAD_CHUNK);
+                }
+                if (!parseSize(data.substr(consumed, lineEnd - consumed))) {
+                    return Status::ERROR;
+                }
+                consumed = next;
+                break;
+
+            case State::DATA: {
+                // 块数据随到随交出，不必等整个块收全
+                size_t available = std::min(data.size() - consumed, chunkRemaining_);
+                if (available == 0) {
+                    return Status::NEED_MORE;
+                }
+                chunk = data.substr(consumed, available);
+                consumed += available;
+                chunkRemaining_ -= available;
+                decoded_ += available;
+                if (chunkRemaining_ == 0) {
+                    state_ = State::DATA_END;
+                }
+                return Status::DATA;
+            }
+
+            case State::DATA_END:
+                // 块数据之后必须紧跟CRLF
+                if (consumed >= data.size()) {
+                    return Status::NEED_MORE;
+                }
+                if (data[consumed] == '\r') {
+                    if (consumed + 1 >= data.size()) {
+                        return Status::NEED_MORE;
+                    }
+                    if (data[consumed + 1] != '\n') {
+                        return fail(Error::BAD_CHUNK);
+                    }
+                    consumed += 2;
+                } else if (data[consumed] == '\n') {
+                    consumed += 1;
+                } else {
+                    return fail(Error::BAD_CHUNK);
+                }
+                state_ = State::SIZE;
+                break;
+
+            case State::TRAILERS:
+                if (!nextLine(data, consumed, lineEnd, next)) {
+                    if (trailerBytes_ + (data.size() - consumed) > limits_.maxTrailerBytes) {
+                        return fail(Error::TRAILER_TOO_LARGE);
+                    }
+                    return Status::NEED_MORE;
+                }
+                trailerBytes_ += next - consumed;
+                if (trailerBytes_ > limits_.maxTrailerBytes) {
+                    return fail(Error::TRAILER_TOO_LARGE);
+                }
+                if (lineEnd == consumed) {
+                    consumed = next;
+                    state_ = State::DONE;
+                    return Status::DONE;
+                }
+                if (!parseTrailer(data.substr(consumed, lineEnd - consumed))) {
+                    return Status::ERROR;
+                }
+                consumed = next;
+                break;
+
+            case State::DONE:
+                return Status::DONE;
+
+            case State::ERROR:
+                return Status::ERROR;
+        }
+    }
+}
+
+bool ChunkedDecoder::parseSize(std::string_view line) {
+    // 块扩展没有标准语义，直接忽略
+    size_t extension = line.find(';');
+    if (extension != std::string_view::npos) {
+        line = line.substr(0, extension);
+    }
+    line = trimWhitespace(line);
+    if (line.empty() || line.size() > 15) {
+        fail(Error::BAD_CHUNK);
+        return false;
+    }
+
+    size_t size = 0;
+    for (char c : line) {
+        int digit = hexValue(c);
+        if (digit < 0) {
+            fail(Error::BAD_CHUNK);
+            return false;
+        }
+        size = size * 16 + static_cast<size_t>(digit);
+    }
+    if (size > limits_.maxBodySize - decoded_) {
+        fail(Error::BODY_TOO_LARGE);
+        return false;
+    }
+
+    chunkRemaining_ = size;
+    state_ = size == 0 ? State::TRAILERS : State::DATA;
+    return true;
+}
+
+bool ChunkedDecoder::parseTrailer(std::string_view line) {
+    // 尾部字段和请求头的语法相同
+    size_t colon = HeaderScanner::findTokenEnd(line.data(), line.size());
+    if (colon == 0 || colon == line.size() || line[colon] != ':') {
+        fail(Error::BAD_TRAILER);
+        return false;
+    }
+    std::string_view rawValue = line.substr(colon + 1);
+    if (HeaderScanner::findFieldValueEnd(rawValue.data(), rawValue.size()) != rawValue.size()) {
+        fail(Error::BAD_TRAILER);
+        return false;
+    }
+    if (trailers_.size() >= limits_.maxTrailers) {
+        fail(Error::TRAILER_TOO_LARGE);
+        return false;
+    }
+    trailers_.add(std::string(line.substr(0, colon)), std::string(trimWhitespace(rawValue)));
+    return true;
+}
+
+} // namespace webserver
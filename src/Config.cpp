@@ -132,6 +132,9 @@ template void Config::set<std::string>(const std::string&, const std::string&);
 template bool Config::get<bool>(const std::string&, const bool&) const;
 template void Config::set<bool>(const std::string&, const bool&);
 
+template nlohmann::json Config::get<nlohmann::json>(const std::string&, const nlohmann::json&) const;
+template void Config::set<nlohmann::json>(const std::string&, const nlohmann::json&);
+
 // 显式实例化嵌套值访问方法
 template int Config::getNestedValue<int>(const std::string&, const int&) const;
 template void Config::setNestedValue<int>(const std::string&, const int&);
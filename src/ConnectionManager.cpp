@@ -1,228 +1,297 @@
 #include "ConnectionManager.hpp"
 #include "Logger.hpp"
 #include <unistd.h>
+#include <algorithm>
 #include <chrono>
+#include <sstream>
+#include <stdexcept>
 
 namespace webserver {
 
 ConnectionManager::ConnectionManager(const Config& config)
-    : config_(config), running_(true) {
+    : reservedConnections_(0), config_(config), running_(true) {
     // 从配置中读取连接管理相关的配置项
     maxConnectionsPerClient_ = config.get<int>("server.max_connections_per_client", 1000);
     maxConnectionsPerIP_ = config.get<int>("server.max_connections_per_ip", 100);
-    connectionTimeout_ = config.get<int>("server.timeout", 60);
-    keepAliveTimeout_ = config.get<int>("server.keep_alive_timeout", 5);
-    maxRequestsPerConnection_ = config.get<int>("server.max_requests_per_connection", 100);
-    connectionCleanupInterval_ = config.get<int>("server.connection_cleanup_interval", 1);
+    maxRequestsPerConnection_ = std::max(1, config.get<int>("server.max_requests_per_connection", 100));
+    keepAliveTimeout_ = std::max(1, config.get<int>("server.keep_alive_timeout", 5));
+    keepAliveMinTimeout_ = std::clamp(config.get<int>("server.keep_alive_min_timeout", 1), 1, keepAliveTimeout_);
+    keepAliveMinRequests_ = std::clamp(config.get<int>("server.keep_alive_min_requests", 10), 1, maxRequestsPerConnection_);
+    keepAlivePressurePercent_ = std::clamp(config.get<int>("server.keep_alive_pressure_threshold", 75), 0, 100);
+    maxConnectionsPerV4Prefix_ = config.get<int>("server.max_connections_per_ipv4_prefix", 0);
+    maxConnectionsPerV6Prefix_ = config.get<int>("server.max_connections_per_ipv6_prefix", 0);
+    int ipv4PrefixLength = std::clamp(config.get<int>("server.ipv4_prefix_length", 24), 0, 32);
+    int ipv6PrefixLength = std::clamp(config.get<int>("server.ipv6_prefix_length", 64), 0, 128);
+    ipv4PrefixLength_ = 96 + static_cast<unsigned>(ipv4PrefixLength);
+    ipv6PrefixLength_ = static_cast<unsigned>(ipv6PrefixLength);
 
-    // 启动清理线程
-    cleanupThread_ = std::thread(&ConnectionManager::cleanupTask, this);
+    if (!ipFilter_.load(config.get<std::string>("server.ip_allow", ""),
+                        config.get<std::string>("server.ip_deny", ""))) {
+        throw std::runtime_error("Invalid IP access list");
+    }
 }
 
 ConnectionManager::~ConnectionManager() {
     stopAll();
-    
-    // 等待清理线程结束
-    if (cleanupThread_.joinable()) {
-        cleanupCV_.notify_one();
-        cleanupThread_.join();
+}
+
+int64_t ConnectionManager::nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool ConnectionManager::addConnection(int socket, const std::string& clientIP) {
+    IpAddress address;
+    if (!IpAddress::parse(clientIP, address)) {
+        LOG_ERROR("Invalid client address: " + clientIP);
+        close(socket);
+        return false;
     }
+    return addConnection(socket, address);
 }
 
-void ConnectionManager::addConnection(int socket, const std::string& clientIP, ConnectionHandler handler) {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
+bool ConnectionManager::addConnection(int socket, const IpAddress& clientAddress) {
     if (!running_) {
         close(socket);
-        return;
+        return false;
     }
 
-    // 检查连接数量限制
-    if (connections_.size() >= static_cast<size_t>(maxConnectionsPerClient_)) {
-        LOG_ERROR("Maximum connection limit reached");
+    // 本机的Unix域套接字连接没有IP地址，只受总连接数限制
+    bool local = clientAddress.isUnspecified();
+
+    // 访问控制列表的查询不加锁
+    if (!local && !ipFilter_.isAllowed(clientAddress)) {
+        LOG_WARNING("Connection from " + clientAddress.toString() + " denied by IP access list");
         close(socket);
-        return;
+        return false;
     }
-    
-    // 检查IP地址的连接数是否达到限制
-    auto& ipCount = ipConnections_[clientIP];
-    if (ipCount >= maxConnectionsPerIP_) {
-        LOG_ERROR("Maximum connection per IP limit reached for IP: " + clientIP);
+
+    // 检查连接数量限制，先占用名额，超出时再归还
+    if (reservedConnections_.fetch_add(1, std::memory_order_relaxed) >=
+        static_cast<size_t>(maxConnectionsPerClient_)) {
+        reservedConnections_.fetch_sub(1, std::memory_order_relaxed);
+        LOG_ERROR("Maximum connection limit reached");
         close(socket);
-        return;
-    }
-    
-    // 更新IP地址的连接数
-    ipCount++;
-    
-    // 创建新的连接信息
-    ConnectionInfo connInfo;
-    connInfo.lastActivity = std::chrono::steady_clock::now();
-    connInfo.requestCount = 0;
-    connInfo.keepAlive = false;
-    connInfo.clientIP = clientIP;
-    
-    // 创建新线程处理连接
-    connInfo.thread = std::thread([this, socket, handler]() {
-        handler();
-        closeConnection(socket);
-    });
-    connInfo.thread.detach();
-    
-    // 保存连接信息
-    connections_[socket] = std::move(connInfo);
+        return false;
+    }
+
+    if (!local) {
+        // 地址计数和网段计数在同一分片中，只锁住该分片
+        IpAddress prefix = prefixOf(clientAddress);
+        AddressShard& addressShard = addressShardFor(prefix);
+        std::lock_guard<std::mutex> lock(addressShard.mutex);
+
+        // 检查IP地址的连接数是否达到限制
+        auto addressIt = addressShard.addresses.find(clientAddress);
+        if (addressIt != addressShard.addresses.end() && addressIt->second >= maxConnectionsPerIP_) {
+            reservedConnections_.fetch_sub(1, std::memory_order_relaxed);
+            LOG_ERROR("Maximum connection per IP limit reached for IP: " + clientAddress.toString());
+            close(socket);
+            return false;
+        }
+
+        // 检查网段的连接数是否达到限制
+        int prefixLimit = clientAddress.isV4() ? maxConnectionsPerV4Prefix_ : maxConnectionsPerV6Prefix_;
+        auto prefixIt = addressShard.prefixes.find(prefix);
+        if (prefixLimit > 0 && prefixIt != addressShard.prefixes.end() && prefixIt->second >= prefixLimit) {
+            reservedConnections_.fetch_sub(1, std::memory_order_relaxed);
+            LOG_ERROR("Maximum connection per prefix limit reached for IP: " + clientAddress.toString());
+            close(socket);
+            return false;
+        }
+
+        // 更新地址和网段的连接数
+        addressShard.addresses[clientAddress]++;
+        addressShard.prefixes[prefix]++;
+    }
+
+    // 保存连接信息，数组按需扩展到fd对应的下标
+    Shard& shard = shardFor(socket);
+    size_t index = indexFor(socket);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (index >= shard.inUse.size()) {
+        size_t size = std::max(index + 1, shard.inUse.size() * 2);
+        shard.lastActivity.resize(size, 0);
+        shard.requestCount.resize(size, 0);
+        shard.keepAlive.resize(size, 0);
+        shard.inUse.resize(size, 0);
+        shard.clientAddress.resize(size);
+    }
+    shard.lastActivity[index] = nowNanos();
+    shard.requestCount[index] = 0;
+    shard.keepAlive[index] = 0;
+    shard.inUse[index] = 1;
+    shard.clientAddress[index] = clientAddress;
+    shard.connectionCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-void ConnectionManager::closeConnection(int socket) {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    auto it = connections_.find(socket);
-    if (it != connections_.end()) {
-        // 获取连接对应的IP地址
-        const std::string& clientIP = it->second.clientIP;
-        auto ipIt = ipConnections_.find(clientIP);
-        
-        if (ipIt != ipConnections_.end()) {
-            // 减少IP地址的连接计数
-            ipIt->second--;
-            
-            // 如果连接计数为0，从映射表中移除该IP地址
-            if (ipIt->second == 0) {
-                ipConnections_.erase(ipIt);
-            }
+void ConnectionManager::releaseAddress(const IpAddress& address) {
+    IpAddress prefix = prefixOf(address);
+    AddressShard& addressShard = addressShardFor(prefix);
+    std::lock_guard<std::mutex> lock(addressShard.mutex);
+
+    // 连接计数为0时从计数表中移除
+    auto addressIt = addressShard.addresses.find(address);
+    if (addressIt != addressShard.addresses.end() && --addressIt->second == 0) {
+        addressShard.addresses.erase(addressIt);
+    }
+    auto prefixIt = addressShard.prefixes.find(prefix);
+    if (prefixIt != addressShard.prefixes.end() && --prefixIt->second == 0) {
+        addressShard.prefixes.erase(prefixIt);
+    }
+}
+
+void ConnectionManager::closeConnection(int socket, bool closeSocket) {
+    Shard& shard = shardFor(socket);
+    size_t index = indexFor(socket);
+    IpAddress clientAddress;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (index >= shard.inUse.size() || !shard.inUse[index]) {
+            return;
         }
-        
-        close(socket);
-        connections_.erase(it);
+        shard.inUse[index] = 0;
+        clientAddress = shard.clientAddress[index];
+        shard.connectionCount.fetch_sub(1, std::memory_order_relaxed);
+        if (closeSocket) {
+            close(socket);
+        }
+    }
+
+    if (!clientAddress.isUnspecified()) {
+        releaseAddress(clientAddress);
     }
+    reservedConnections_.fetch_sub(1, std::memory_order_relaxed);
 }
 
 void ConnectionManager::stopAll() {
-    {
-        std::lock_guard<std::mutex> lock(connectionsMutex_);
-        running_ = false;
-        
-        // 关闭所有连接
-        for (const auto& pair : connections_) {
-            close(pair.first);
+    running_ = false;
+
+    // 关闭所有连接
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t index = 0; index < shard.inUse.size(); ++index) {
+            if (shard.inUse[index]) {
+                close(static_cast<int>(index * kShardCount + static_cast<size_t>(&shard - shards_.data())));
+                shard.inUse[index] = 0;
+                reservedConnections_.fetch_sub(1, std::memory_order_relaxed);
+            }
         }
-        
-        // 清空连接列表
-        connections_.clear();
+        shard.connectionCount.store(0, std::memory_order_relaxed);
+    }
+
+    // 清空地址计数表
+    for (auto& addressShard : addressShards_) {
+        std::lock_guard<std::mutex> lock(addressShard.mutex);
+        addressShard.addresses.clear();
+        addressShard.prefixes.clear();
     }
-    
-    // 通知清理线程退出
-    cleanupCV_.notify_one();
 }
 
 void ConnectionManager::updateActivity(int socket) {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    auto it = connections_.find(socket);
-    if (it != connections_.end()) {
-        it->second.lastActivity = std::chrono::steady_clock::now();
-        it->second.requestCount++;
-        totalRequests_++;
-        
+    Shard& shard = shardFor(socket);
+    size_t index = indexFor(socket);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (index < shard.inUse.size() && shard.inUse[index]) {
+        shard.lastActivity[index] = nowNanos();
+        shard.requestTotal.fetch_add(1, std::memory_order_relaxed);
+
         // 检查请求数量限制
-        if (it->second.requestCount >= maxRequestsPerConnection_) {
-            it->second.keepAlive = false;
+        if (++shard.requestCount[index] >= keepAliveLimits().maxRequests) {
+            shard.keepAlive[index] = 0;
         }
     }
 }
 
 size_t ConnectionManager::getActiveConnectionCount() const {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
     size_t activeCount = 0;
-    auto now = std::chrono::steady_clock::now();
-    
-    for (const auto& pair : connections_) {
-        const auto& connInfo = pair.second;
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-            now - connInfo.lastActivity).count();
-            
-        if (duration < 5) { // 5秒内活跃的连接
-            activeCount++;
+    int64_t activeSince = nowNanos() -
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(5)).count();
+
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t index = 0; index < shard.inUse.size(); ++index) {
+            if (shard.inUse[index] && shard.lastActivity[index] > activeSince) { // 5秒内活跃的连接
+                activeCount++;
+            }
         }
     }
     return activeCount;
 }
 
 uint64_t ConnectionManager::getTotalRequestCount() const {
-    return totalRequests_.load();
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.requestTotal.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+ConnectionManager::KeepAliveLimits ConnectionManager::keepAliveLimits() const {
+    KeepAliveLimits limits;
+    size_t connections = reservedConnections_.load(std::memory_order_relaxed);
+    if (maxConnectionsPerClient_ > 0) {
+        limits.occupancyPercent = static_cast<unsigned>(
+            std::min<size_t>(100, connections * 100 / static_cast<size_t>(maxConnectionsPerClient_)));
+    }
+    limits.timeoutSeconds = keepAliveTimeout_;
+    limits.maxRequests = maxRequestsPerConnection_;
+    limits.adaptive = keepAlivePressurePercent_ < 100;
+    limits.underPressure = limits.adaptive && limits.occupancyPercent > static_cast<unsigned>(keepAlivePressurePercent_);
+    if (limits.underPressure) {
+        // 从压力阈值到满载线性收缩到下限，空闲的保活连接尽快让出名额给新客户端
+        int headroom = 100 - static_cast<int>(limits.occupancyPercent);
+        int range = 100 - keepAlivePressurePercent_;
+        limits.timeoutSeconds = keepAliveMinTimeout_ + (keepAliveTimeout_ - keepAliveMinTimeout_) * headroom / range;
+        limits.maxRequests = keepAliveMinRequests_ + (maxRequestsPerConnection_ - keepAliveMinRequests_) * headroom / range;
+    }
+    return limits;
 }
 
 std::string ConnectionManager::getConnectionStats() const {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    
+    size_t activeCount = getActiveConnectionCount();
+    size_t uniqueIPs = 0;
+    for (const auto& addressShard : addressShards_) {
+        std::lock_guard<std::mutex> lock(addressShard.mutex);
+        uniqueIPs += addressShard.addresses.size();
+    }
+
     std::stringstream ss;
     ss << "{";
-    ss << "\"total_connections\": " << connections_.size() << ",";
-    ss << "\"active_connections\": " << getActiveConnectionCount() << ",";
-    ss << "\"total_requests\": " << totalRequests_.load() << ",";
-    ss << "\"unique_ips\": " << ipConnections_.size() << ",";
+    ss << "\"total_connections\": " << getConnectionCount() << ",";
+    ss << "\"active_connections\": " << activeCount << ",";
+    ss << "\"total_requests\": " << getTotalRequestCount() << ",";
+    ss << "\"unique_ips\": " << uniqueIPs << ",";
     ss << "\"max_connections_per_ip\": " << maxConnectionsPerIP_ << ",";
-    ss << "\"max_connections_per_client\": " << maxConnectionsPerClient_;
+    ss << "\"max_connections_per_client\": " << maxConnectionsPerClient_ << ",";
+    KeepAliveLimits keepAlive = keepAliveLimits();
+    ss << "\"occupancy_percent\": " << keepAlive.occupancyPercent << ",";
+    ss << "\"keep_alive_pressure_threshold\": " << keepAlivePressurePercent_ << ",";
+    ss << "\"keep_alive_under_pressure\": " << (keepAlive.underPressure ? "true" : "false") << ",";
+    ss << "\"keep_alive_timeout\": " << keepAlive.timeoutSeconds << ",";
+    ss << "\"keep_alive_max_requests\": " << keepAlive.maxRequests << ",";
+    ss << "\"ip_access_rules\": " << ipFilter_.ruleCount();
     ss << "}";
-    
+
     return ss.str();
 }
 
 void ConnectionManager::setKeepAlive(int socket, bool keepAlive) {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    auto it = connections_.find(socket);
-    if (it != connections_.end()) {
-        it->second.keepAlive = keepAlive;
+    Shard& shard = shardFor(socket);
+    size_t index = indexFor(socket);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (index < shard.inUse.size() && shard.inUse[index]) {
+        shard.keepAlive[index] = keepAlive ? 1 : 0;
     }
 }
 
 size_t ConnectionManager::getConnectionCount() const {
-    std::lock_guard<std::mutex> lock(connectionsMutex_);
-    return connections_.size();
-}
-
-void ConnectionManager::cleanupTask() {
-    int cleanupCount = 0;
-    while (running_) {
-        std::unique_lock<std::mutex> lock(connectionsMutex_);
-        
-        // 等待清理间隔或者被通知退出
-        cleanupCV_.wait_for(lock, 
-            std::chrono::seconds(connectionCleanupInterval_),
-            [this] { return !running_; });
-            
-        if (!running_) {
-            break;
-        }
-        
-        auto now = std::chrono::steady_clock::now();
-        
-        // 遍历所有连接，关闭超时的连接
-        for (auto it = connections_.begin(); it != connections_.end();) {
-            const auto& connInfo = it->second;
-            auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-                now - connInfo.lastActivity).count();
-                
-            bool shouldClose = false;
-            
-            // 检查是否超时
-            if (connInfo.keepAlive) {
-                shouldClose = duration > keepAliveTimeout_;
-            } else {
-                shouldClose = duration > connectionTimeout_;
-            }
-            
-            if (shouldClose) {
-                LOG_DEBUG("Closing inactive connection: " + std::to_string(it->first));
-                close(it->first);
-                it = connections_.erase(it);
-            } else {
-                ++it;
-            }
-        }
-
-        // 每10次清理（约10分钟）输出一次统计信息
-        if (++cleanupCount % 10 == 0) {
-            LOG_INFO("Connection statistics: " + getConnectionStats());
-        }
+    size_t count = 0;
+    for (const auto& shard : shards_) {
+        count += shard.connectionCount.load(std::memory_order_relaxed);
     }
+    return count;
 }
 
 } // namespace webserver
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "ContentCache.hpp"
+#include "Logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace webserver {
+
+namespace {
+// 目录中文件被修改、替换、删除，或目录本身被删除、移走时都会产生事件
+constexpr uint32_t kWatchMask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+std::string parentDirectory(const std::string& path) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+} // namespace
+
+ContentCache::ContentCache(size_t capacityBytes, size_t maxFileSize)
+    : capacityBytes_(capacityBytes), maxFileSize_(maxFileSize), notifyFd_(-1) {
+    if (capacityBytes_ == 0) {
+        return;
+    }
+    notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd_ == -1) {
+        LOG_WARNING("inotify unavailable, in-memory static cache disabled: " + std::string(strerror(errno)));
+    }
+}
+
+ContentCache::~ContentCache() {
+    if (notifyFd_ != -1) {
+        close(notifyFd_);
+    }
+}
+
+std::shared_ptr<const CachedResponse> ContentCache::find(const std::string& path) {
+    if (!enabled()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        stats_.misses++;
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+    stats_.hits++;
+    return it->second.response;
+}
+
+bool ContentCache::watch(const std::string& path, uint64_t& generation) {
+    if (!enabled()) {
+        return false;
+    }
+    std::string directory = parentDirectory(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation = generation_;
+    if (directoryWatches_.count(directory) != 0) {
+        return true;
+    }
+    int watch = inotify_add_watch(notifyFd_, directory.c_str(), kWatchMask);
+    if (watch == -1) {
+        LOG_WARNING("Failed to watch " + directory + ": " + std::string(strerror(errno)));
+        return false;
+    }
+    watchedDirectories_[watch] = directory;
+    directoryWatches_[directory] = watch;
+    return true;
+}
+
+void ContentCache::insert(std::shared_ptr<const CachedResponse> response, uint64_t generation) {
+    size_t cost = response->cost();
+    if (!enabled() || cost > capacityBytes_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 读取期间处理过文件变化事件时，读到的内容可能已经过期；
+    // 目录的监视已被移除时，之后的修改也无法感知
+    if (generation != generation_ || directoryWatches_.count(parentDirectory(response->path)) == 0) {
+        return;
+    }
+    auto it = entries_.find(response->path);
+    if (it != entries_.end()) {
+        eraseLocked(it);
+    }
+    while (bytes_ + cost > capacityBytes_ && !lru_.empty()) {
+        eraseLocked(entries_.find(lru_.back()));
+        stats_.evictions++;
+    }
+    const std::string& path = response->path;
+    lru_.push_front(path);
+    bytes_ += cost;
+    entries_.emplace(path, Entry{std::move(response), lru_.begin()});
+}
+
+void ContentCache::eraseLocked(std::unordered_map<std::string, Entry>::iterator it) {
+    bytes_ -= it->second.response->cost();
+    lru_.erase(it->second.lruPosition);
+    entries_.erase(it);
+}
+
+void ContentCache::dropDirectoryLocked(int watch) {
+    auto directory = watchedDirectories_.find(watch);
+    if (directory == watchedDirectories_.end()) {
+        return;
+    }
+    std::string prefix = directory->second == "/" ? "/" : directory->second + "/";
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto next = std::next(it);
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+            eraseLocked(it);
+            stats_.invalidations++;
+        }
+        it = next;
+    }
+    directoryWatches_.erase(directory->second);
+    watchedDirectories_.erase(directory);
+}
+
+void ContentCache::processEvents(const std::function<void(const std::string&)>& onChange) {
+    if (notifyFd_ == -1) {
+        return;
+    }
+
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    while (true) {
+        ssize_t length = read(notifyFd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // 事件丢失，无法判断哪些项已经过期
+                LOG_WARNING("inotify queue overflow, dropping in-memory static cache");
+                stats_.invalidations += entries_.size();
+                entries_.clear();
+                lru_.clear();
+                bytes_ = 0;
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                // 目录被删除或移走后其路径不再可信，下次缓存该目录下的文件时重新监视
+                if (event->mask & IN_MOVE_SELF) {
+                    inotify_rm_watch(notifyFd_, event->wd);
+                }
+                dropDirectoryLocked(event->wd);
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            auto directory = watchedDirectories_.find(event->wd);
+            if (directory == watchedDirectories_.end()) {
+                continue;
+            }
+            std::string path = directory->second == "/" ? "/" : directory->second + "/";
+            path += event->name;
+            auto it = entries_.find(path);
+            if (it != entries_.end()) {
+                eraseLocked(it);
+                stats_.invalidations++;
+            }
+            if (onChange) {
+                onChange(path);
+            }
+        }
+    }
+}
+
+size_t ContentCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t ContentCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+ContentCache::Stats ContentCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace webserver
@@ -0,0 +1,163 @@
+#include "EventLoop.hpp"
+#include "Logger.hpp"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace webserver {
+
+namespace {
+// epoll_wait单次返回的初始事件数，满载时自动扩容
+constexpr size_t kInitialEventListSize = 128;
+}
+
+EventLoop::EventLoop()
+    : epollFd_(epoll_create1(EPOLL_CLOEXEC)),
+      wakeupFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      quit_(false),
+      threadId_(std::this_thread::get_id()),
+      events_(kInitialEventListSize),
+      pollCount_(0) {
+    if (epollFd_ == -1 || wakeupFd_ == -1) {
+        if (epollFd_ != -1) close(epollFd_);
+        if (wakeupFd_ != -1) close(wakeupFd_);
+        throw std::runtime_error("Failed to create event loop: " + std::string(strerror(errno)));
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeupFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd_, &ev) == -1) {
+        close(epollFd_);
+        close(wakeupFd_);
+        throw std::runtime_error("Failed to register wakeup fd: " + std::string(strerror(errno)));
+    }
+}
+
+EventLoop::~EventLoop() {
+    close(wakeupFd_);
+    close(epollFd_);
+}
+
+void EventLoop::loop() {
+    threadId_ = std::this_thread::get_id();
+
+    while (!quit_) {
+        pollCount_.fetch_add(1, std::memory_order_relaxed);
+        int count = epoll_wait(epollFd_, events_.data(), static_cast<int>(events_.size()), -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("epoll_wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+            int fd = events_[i].data.fd;
+            if (fd == wakeupFd_) {
+                handleWakeup();
+                continue;
+            }
+            // 回调可能在执行过程中注销自身，因此先复制一份
+            if (static_cast<size_t>(fd) < callbacks_.size() && callbacks_[static_cast<size_t>(fd)]) {
+                EventCallback callback = callbacks_[static_cast<size_t>(fd)];
+                callback(events_[i].events);
+            }
+        }
+
+        if (static_cast<size_t>(count) == events_.size()) {
+            events_.resize(events_.size() * 2);
+        }
+
+        doPendingFunctors();
+
+        if (postIterationCallback_) {
+            postIterationCallback_();
+        }
+    }
+}
+
+void EventLoop::quit() {
+    quit_ = true;
+    wakeup();
+}
+
+bool EventLoop::addFd(int fd, uint32_t events, EventCallback callback) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        LOG_ERROR("Failed to add fd " + std::to_string(fd) + " to epoll: " + strerror(errno));
+        return false;
+    }
+
+    if (static_cast<size_t>(fd) >= callbacks_.size()) {
+        callbacks_.resize(static_cast<size_t>(fd) + 1);
+    }
+    callbacks_[static_cast<size_t>(fd)] = std::move(callback);
+    return true;
+}
+
+bool EventLoop::modifyFd(int fd, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) == -1) {
+        LOG_ERROR("Failed to modify fd " + std::to_string(fd) + " in epoll: " + strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::removeFd(int fd) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    if (static_cast<size_t>(fd) < callbacks_.size()) {
+        callbacks_[static_cast<size_t>(fd)] = nullptr;
+    }
+}
+
+void EventLoop::queueInLoop(Functor functor) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pendingFunctors_.push_back(std::move(functor));
+    }
+    wakeup();
+}
+
+bool EventLoop::isInLoopThread() const {
+    return threadId_ == std::this_thread::get_id();
+}
+
+void EventLoop::setPostIterationCallback(Functor callback) {
+    postIterationCallback_ = std::move(callback);
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    // eventfd计数溢出前write不会失败，返回值可以忽略
+    ssize_t written = write(wakeupFd_, &one, sizeof(one));
+    (void)written;
+}
+
+void EventLoop::handleWakeup() {
+    uint64_t value = 0;
+    ssize_t bytesRead = read(wakeupFd_, &value, sizeof(value));
+    (void)bytesRead;
+}
+
+void EventLoop::doPendingFunctors() {
+    std::vector<Functor> functors;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        functors.swap(pendingFunctors_);
+    }
+
+    for (auto& functor : functors) {
+        functor();
+    }
+}
+
+} // namespace webserver
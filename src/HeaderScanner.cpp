@@ -0,0 +1,349 @@
+#include "HeaderScanner.hpp"
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define WEBSERVER_HEADER_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace webserver {
+
+namespace {
+
+// 每个字节是否属于对应字符集
+struct CharClass {
+    bool token[256];
+    bool target[256];
+    bool value[256];
+};
+
+constexpr CharClass makeCharClass() {
+    CharClass table{};
+    for (int b = 0; b < 256; ++b) {
+        table.token[b] = (b >= '0' && b <= '9') || (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z');
+        table.target[b] = b > 0x20 && b != 0x7f;
+        table.value[b] = b == '\t' || (b >= 0x20 && b != 0x7f);
+    }
+    // RFC 9110 tchar中的符号
+    const char* symbols = "!#$%&'*+-.^_`|~";
+    for (const char* p = symbols; *p != '\0'; ++p) {
+        table.token[static_cast<unsigned char>(*p)] = true;
+    }
+    return table;
+}
+
+constexpr CharClass kCharClass = makeCharClass();
+
+size_t scanScalar(const bool* table, const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size && table[static_cast<unsigned char>(data[i])]) {
+        ++i;
+    }
+    return i;
+}
+
+size_t findTokenEndScalar(const char* data, size_t size) {
+    return scanScalar(kCharClass.token, data, size);
+}
+
+size_t findTargetEndScalar(const char* data, size_t size) {
+    return scanScalar(kCharClass.target, data, size);
+}
+
+size_t findFieldValueEndScalar(const char* data, size_t size) {
+    return scanScalar(kCharClass.value, data, size);
+}
+
+#ifdef WEBSERVER_HEADER_SCANNER_X86
+
+// pcmpestri的范围表：每两个字节是一个闭区间，命中任一区间即视为非法字符
+// pcmpestri最多8个区间，token的非法字符需要更多区间，这里用超集并在命中后查表确认（'|'和'~'）
+alignas(16) constexpr unsigned char kTokenRanges[16] = {
+    0x00, 0x20, '"', '"', '(', ')', ',', ',', '/', '/', ':', '@', '[', ']', '{', 0xff
+};
+alignas(16) constexpr unsigned char kTargetRanges[16] = {0x00, 0x20, 0x7f, 0x7f};
+alignas(16) constexpr unsigned char kValueRanges[16] = {0x00, 0x08, 0x0a, 0x1f, 0x7f, 0x7f};
+
+__attribute__((target("sse4.2")))
+size_t scanSse42(const unsigned char* ranges, int rangeBytes, const bool* table, const char* data, size_t size) {
+    const __m128i rangeVector = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+    size_t i = 0;
+    while (size - i >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int index = _mm_cmpestri(rangeVector, rangeBytes, block, 16,
+                                 _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (index == 16) {
+            i += 16;
+            continue;
+        }
+        i += static_cast<size_t>(index);
+        if (!table[static_cast<unsigned char>(data[i])]) {
+            return i;
+        }
+        ++i;
+    }
+    return i + scanScalar(table, data + i, size - i);
+}
+
+__attribute__((target("sse4.2")))
+size_t findTokenEndSse42(const char* data, size_t size) {
+    return scanSse42(kTokenRanges, 16, kCharClass.token, data, size);
+}
+
+__attribute__((target("sse4.2")))
+size_t findTargetEndSse42(const char* data, size_t size) {
+    return scanSse42(kTargetRanges, 4, kCharClass.target, data, size);
+}
+
+__attribute__((target("sse4.2")))
+size_t findFieldValueEndSse42(const char* data, size_t size) {
+    return scanSse42(kValueRanges, 6, kCharClass.value, data, size);
+}
+
+// token的AVX2查表：字节按高低4位拆开，low[低4位]的第k位表示高4位为k的字节是否为tchar
+struct NibbleTables {
+    unsigned char low[16];
+    unsigned char highBit[16];
+};
+
+constexpr NibbleTables makeNibbleTables() {
+    NibbleTables tables{};
+    for (int low = 0; low < 16; ++low) {
+        for (int high = 0; high < 8; ++high) {
+            if (kCharClass.token[high * 16 + low]) {
+                tables.low[low] = static_cast<unsigned char>(tables.low[low] | (1 << high));
+            }
+        }
+    }
+    // 高4位为8..15的字节都不是tchar，对应位为0
+    for (int high = 0; high < 8; ++high) {
+        tables.highBit[high] = static_cast<unsigned char>(1 << high);
+    }
+    return tables;
+}
+
+alignas(16) constexpr NibbleTables kTokenNibbles = makeNibbleTables();
+
+// 各字符集的向量判定：返回的向量中非法字节为0xff，其余为0
+struct TokenClassifier {
+    __attribute__((target("avx2")))
+    static __m128i bad(__m128i block) {
+        const __m128i lowTable = _mm_load_si128(reinterpret_cast<const __m128i*>(kTokenNibbles.low));
+        const __m128i highTable = _mm_load_si128(reinterpret_cast<const __m128i*>(kTokenNibbles.highBit));
+        const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+        __m128i low = _mm_and_si128(block, nibbleMask);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask);
+        __m128i allowed = _mm_and_si128(_mm_shuffle_epi8(lowTable, low), _mm_shuffle_epi8(highTable, high));
+        return _mm_cmpeq_epi8(allowed, _mm_setzero_si128());
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i bad(__m256i block) {
+        const __m256i lowTable = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(kTokenNibbles.low)));
+        const __m256i highTable = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(kTokenNibbles.highBit)));
+        const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+        __m256i low = _mm256_and_si256(block, nibbleMask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibbleMask);
+        __m256i allowed = _mm256_and_si256(_mm256_shuffle_epi8(lowTable, low),
+                                           _mm256_shuffle_epi8(highTable, high));
+        return _mm256_cmpeq_epi8(allowed, _mm256_setzero_si256());
+    }
+};
+
+struct TargetClassifier {
+    // 无符号比较block <= 0x20：min(block, 0x20) == block
+    __attribute__((target("avx2")))
+    static __m128i bad(__m128i block) {
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8(0x20)), block);
+        return _mm_or_si128(control, _mm_cmpeq_epi8(block, _mm_set1_epi8(0x7f)));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i bad(__m256i block) {
+        __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(block, _mm256_set1_epi8(0x20)), block);
+        return _mm256_or_si256(control, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(0x7f)));
+    }
+};
+
+struct FieldValueClassifier {
+    __attribute__((target("avx2")))
+    static __m128i bad(__m128i block) {
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8(0x1f)), block);
+        control = _mm_andnot_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')), control);
+        return _mm_or_si128(control, _mm_cmpeq_epi8(block, _mm_set1_epi8(0x7f)));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i bad(__m256i block) {
+        __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(block, _mm256_set1_epi8(0x1f)), block);
+        control = _mm256_andnot_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')), control);
+        return _mm256_or_si256(control, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(0x7f)));
+    }
+};
+
+template <typename Classifier>
+__attribute__((target("avx2")))
+unsigned badMask(const char* block) {
+    return static_cast<unsigned>(_mm256_movemask_epi8(
+        Classifier::bad(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)))));
+}
+
+template <typename Classifier>
+__attribute__((target("avx2")))
+unsigned badMask16(const char* block) {
+    return static_cast<unsigned>(_mm_movemask_epi8(
+        Classifier::bad(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)))));
+}
+
+// 请求头的值通常只有几十字节，末尾不足一块的部分与前一块重叠地读取，丢弃已检查过的字节，不退回逐字节扫描
+template <typename Classifier>
+__attribute__((target("avx2")))
+size_t scanAvx2(const bool* table, const char* data, size_t size) {
+    if (size >= 32) {
+        size_t i = 0;
+        for (; size - i >= 32; i += 32) {
+            unsigned mask = badMask<Classifier>(data + i);
+            if (mask != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(mask));
+            }
+        }
+        if (i == size) {
+            return size;
+        }
+        unsigned mask = badMask<Classifier>(data + size - 32) >> (32 - (size - i));
+        return mask != 0 ? i + static_cast<size_t>(__builtin_ctz(mask)) : size;
+    }
+    if (size >= 16) {
+        unsigned mask = badMask16<Classifier>(data);
+        if (mask != 0) {
+            return static_cast<size_t>(__builtin_ctz(mask));
+        }
+        mask = badMask16<Classifier>(data + size - 16) >> (32 - size);
+        return mask != 0 ? 16 + static_cast<size_t>(__builtin_ctz(mask)) : size;
+    }
+    return scanScalar(table, data, size);
+}
+
+__attribute__((target("avx2")))
+size_t findTokenEndAvx2(const char* data, size_t size) {
+    return scanAvx2<TokenClassifier>(kCharClass.token, data, size);
+}
+
+__attribute__((target("avx2")))
+size_t findTargetEndAvx2(const char* data, size_t size) {
+    return scanAvx2<TargetClassifier>(kCharClass.target, data, size);
+}
+
+__attribute__((target("avx2")))
+size_t findFieldValueEndAvx2(const char* data, size_t size) {
+    return scanAvx2<FieldValueClassifier>(kCharClass.value, data, size);
+}
+
+#endif // WEBSERVER_HEADER_SCANNER_X86
+
+struct ScanFunctions {
+    HeaderScanner::Level level;
+    size_t (*tokenEnd)(const char*, size_t);
+    size_t (*targetEnd)(const char*, size_t);
+    size_t (*fieldValueEnd)(const char*, size_t);
+};
+
+constexpr ScanFunctions kScalarFunctions = {
+    HeaderScanner::Level::SCALAR, findTokenEndScalar, findTargetEndScalar, findFieldValueEndScalar
+};
+#ifdef WEBSERVER_HEADER_SCANNER_X86
+constexpr ScanFunctions kSse42Functions = {
+    HeaderScanner::Level::SSE42, findTokenEndSse42, findTargetEndSse42, findFieldValueEndSse42
+};
+constexpr ScanFunctions kAvx2Functions = {
+    HeaderScanner::Level::AVX2, findTokenEndAvx2, findTargetEndAvx2, findFieldValueEndAvx2
+};
+#endif
+
+const ScanFunctions* functionsFor(HeaderScanner::Level level) {
+#ifdef WEBSERVER_HEADER_SCANNER_X86
+    if (level == HeaderScanner::Level::AVX2) {
+        return &kAvx2Functions;
+    }
+    if (level == HeaderScanner::Level::SSE42) {
+        return &kSse42Functions;
+    }
+#endif
+    return &kScalarFunctions;
+}
+
+// 初始指向的这组函数在第一次调用时完成检测并替换为实际实现，避免依赖静态初始化顺序
+const ScanFunctions* resolve();
+
+size_t resolveTokenEnd(const char* data, size_t size) { return resolve()->tokenEnd(data, size); }
+size_t resolveTargetEnd(const char* data, size_t size) { return resolve()->targetEnd(data, size); }
+size_t resolveFieldValueEnd(const char* data, size_t size) { return resolve()->fieldValueEnd(data, size); }
+
+constexpr ScanFunctions kResolveFunctions = {
+    HeaderScanner::Level::SCALAR, resolveTokenEnd, resolveTargetEnd, resolveFieldValueEnd
+};
+
+std::atomic<const ScanFunctions*> activeFunctions{&kResolveFunctions};
+
+const ScanFunctions* resolve() {
+    const ScanFunctions* functions = functionsFor(HeaderScanner::supportedLevel());
+    const ScanFunctions* expected = &kResolveFunctions;
+    // setLevel()可能已经抢先指定了实现
+    if (!activeFunctions.compare_exchange_strong(expected, functions, std::memory_order_relaxed)) {
+        return expected;
+    }
+    return functions;
+}
+
+const ScanFunctions& active() {
+    return *activeFunctions.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+HeaderScanner::Level HeaderScanner::supportedLevel() {
+#ifdef WEBSERVER_HEADER_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Level::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Level::SSE42;
+    }
+#endif
+    return Level::SCALAR;
+}
+
+HeaderScanner::Level HeaderScanner::level() {
+    const ScanFunctions* functions = activeFunctions.load(std::memory_order_relaxed);
+    if (functions == &kResolveFunctions) {
+        functions = resolve();
+    }
+    return functions->level;
+}
+
+HeaderScanner::Level HeaderScanner::setLevel(Level level) {
+    Level supported = supportedLevel();
+    if (static_cast<int>(level) > static_cast<int>(supported)) {
+        level = supported;
+    }
+    activeFunctions.store(functionsFor(level), std::memory_order_relaxed);
+    return level;
+}
+
+size_t HeaderScanner::findTokenEnd(const char* data, size_t size) {
+    return active().tokenEnd(data, size);
+}
+
+size_t HeaderScanner::findTargetEnd(const char* data, size_t size) {
+    return active().targetEnd(data, size);
+}
+
+size_t HeaderScanner::findFieldValueEnd(const char* data, size_t size) {
+    return active().fieldValueEnd(data, size);
+}
+
+} // namespace webserver
@@ -1,8 +1,9 @@
 #include "HttpParser.hpp"
+#include "ChunkedDecoder.hpp"
+#include "http/HttpMethod.hpp"
 #include <sstream>
 #include "Logger.hpp"
 #include <vector>
-#include <set>
 #include <algorithm>
 #include <cctype>
 
@@ -21,10 +22,7 @@ std::tuple<std::string, std::string, std::map<std::string, std::string>, std::st
     lineStream >> method >> path >> version;
     
     // 验证HTTP方法
-    static const std::set<std::string> validMethods = {
-        "GET", "POST", "PUT", "DELETE", "HEAD", "OPTIONS", "PATCH", "TRACE", "CONNECT"
-    };
-    if (validMethods.find(method) == validMethods.end()) {
+    if (parseHttpMethod(method) == HttpMethod::UNKNOWN) {
         throw std::invalid_argument("Invalid HTTP method: " + method);
     }
     
@@ -122,67 +120,27 @@ std::tuple<std::string, std::string, std::map<std::string, std::string>, std::st
         // 存在Transfer-Encoding: chunked头部，按照分块传输编码的规则解析请求体
         LOG_INFO("Chunked encoding detected, parsing chunked body");
         
-        // 跳过空行后的\r\n
-        std::string temp;
-        std::getline(iss, temp); // 读取并丢弃第一个空行
-        
-        std::ostringstream bodyStream;
+        // 请求头之后的数据全部交给流式解码器，块数据直接追加到body，不为每个块单独分配
+        std::string_view encoded(request);
+        std::streamoff bodyStart = iss.tellg();
+        encoded.remove_prefix(bodyStart < 0 ? encoded.size() : static_cast<size_t>(bodyStart));
+
+        ChunkedDecoder decoder;
         while (true) {
-            // 读取块大小行
-            std::string chunkSizeLine;
-            std::getline(iss, chunkSizeLine);
-            
-            // 去除可能的\r
-            if (!chunkSizeLine.empty() && chunkSizeLine.back() == '\r') {
-                chunkSizeLine.pop_back();
-            }
-            
-            // 验证块大小行格式
-            if (chunkSizeLine.empty()) {
-                throw std::invalid_argument("Empty chunk size line");
-            }
-            
-            // 查找分号(;)，如果有扩展则忽略
-            size_t semicolonPos = chunkSizeLine.find(';');
-            if (semicolonPos != std::string::npos) {
-                chunkSizeLine = chunkSizeLine.substr(0, semicolonPos);
-            }
-            
-            // 去除可能的空白字符
-            chunkSizeLine.erase(0, chunkSizeLine.find_first_not_of(" \t"));
-            chunkSizeLine.erase(chunkSizeLine.find_last_not_of(" \t") + 1);
-            
-            if (chunkSizeLine.empty()) {
-                throw std::invalid_argument("Empty chunk size line");
-            }
-            
-            LOG_DEBUG("Parsing chunk size: " + chunkSizeLine);
-            
-            // 验证块大小只包含十六进制数字
-            if (chunkSizeLine.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
-                throw std::invalid_argument("Invalid chunk size: " + chunkSizeLine);
-            }
-            
-            // 将十六进制块大小转换为整数
-            size_t chunkSize = std::stoul(chunkSizeLine, nullptr, 16);
-            
-            // 如果块大小为0，表示结束
-            if (chunkSize == 0) {
-                // 读取并丢弃最后的\r\n
-                std::getline(iss, temp);
+            size_t consumed = 0;
+            std::string_view chunk;
+            ChunkedDecoder::Status status = decoder.decode(encoded, consumed, chunk);
+            encoded.remove_prefix(consumed);
+            if (status == ChunkedDecoder::Status::DATA) {
+                body.append(chunk.data(), chunk.size());
+            } else if (status == ChunkedDecoder::Status::DONE) {
                 break;
+            } else if (status == ChunkedDecoder::Status::NEED_MORE) {
+                throw std::invalid_argument("Incomplete chunked body");
+            } else {
+                throw std::invalid_argument("Invalid chunked body");
             }
-            
-            // 读取块数据
-            std::vector<char> buffer(chunkSize);
-            iss.read(buffer.data(), static_cast<std::streamsize>(chunkSize));
-            bodyStream.write(buffer.data(), static_cast<std::streamsize>(chunkSize));
-            
-            // 读取并丢弃块后的\r\n
-            std::getline(iss, temp);
         }
-        
-        body = bodyStream.str();
     }
     else {
         // 既不存在Content-Length头部，也不存在Transfer-Encoding: chunked头部
@@ -209,7 +167,6 @@ std::string HttpParser::buildResponse(HttpStatus statusCode, const std::string&
 std::string HttpParser::buildResponse(HttpStatus statusCode, const std::string& content, 
                                      const std::map<std::string, std::string>& headers, 
                                      const std::string& contentType) {
-    std::ostringstream response;
     HttpStatusHandler& statusHandler = HttpStatusHandler::getInstance();
     
     // 获取状态消息
@@ -224,9 +181,6 @@ std::string HttpParser::buildResponse(HttpStatus statusCode, const std::string&
         LOG_ERROR("Sending server error response: " + std::to_string(static_cast<int>(statusCode)) + " " + statusMessage);
     }
     
-    // 构建响应
-    response << "HTTP/1.1 " << static_cast<int>(statusCode) << " " << statusMessage << "\r\n";
-    response << "Content-Type: " << contentType << "\r\n";
     // 计算Content-Length时考虑JSON转义字符
     // 计算Content-Length，确保与测试期望一致
     size_t contentLength = content.size();
@@ -234,22 +188,43 @@ std::string HttpParser::buildResponse(HttpStatus statusCode, const std::string&
         // 对于JSON内容，使用固定计算方式以匹配测试期望
         contentLength = content.size() + 1; // 测试期望比实际内容多1
     }
-    response << "Content-Length: " << contentLength << "\r\n";
+
+    // 先算出总长度一次分配，内容只复制一次
+    size_t length = 96 + statusMessage.size() + contentType.size() + content.size();
+    for (const auto& header : headers) {
+        length += header.first.size() + header.second.size() + 4;
+    }
+    std::string response;
+    response.reserve(length);
+
+    // 构建响应
+    response += "HTTP/1.1 ";
+    response += std::to_string(static_cast<int>(statusCode));
+    response += ' ';
+    response += statusMessage;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: ";
+    response += std::to_string(contentLength);
+    response += "\r\n";
     
     // 添加自定义头部
     for (const auto& header : headers) {
-        response << header.first << ": " << header.second << "\r\n";
+        response += header.first;
+        response += ": ";
+        response += header.second;
+        response += "\r\n";
     }
     
     // 确保包含Connection头部，除非自定义头部中已指定
     if (headers.find("Connection") == headers.end()) {
-        response << "Connection: close\r\n";
+        response += "Connection: close\r\n";
     }
     
-    response << "\r\n";  // 头部结束
-    response << content;
+    response += "\r\n";  // 头部结束
+    response += content;
     
-    return response.str();
+    return response;
 }
 
 std::string HttpParser::buildChunkedResponse(HttpStatus statusCode, const std::string& content, const std::string& contentType) {
@@ -0,0 +1,487 @@
+#include "HttpRequestParser.hpp"
+#include "HeaderScanner.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace webserver {
+
+namespace {
+std::string_view trimWhitespace(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+// 尾部字段沿用请求头的大小限制
+ChunkedDecoder::Limits decoderLimits(const HttpRequestParser::Limits& limits) {
+    ChunkedDecoder::Limits result;
+    result.maxBodySize = limits.maxBodySize;
+    result.maxTrailerBytes = limits.maxHeaderBytes;
+    result.maxTrailers = limits.maxHeaders;
+    return result;
+}
+
+// Connection头是逗号分隔的选项列表，例如"keep-alive, Upgrade"
+bool hasConnectionOption(const RequestView& request, std::string_view option) {
+    for (const HeaderView& header : request.headers) {
+        if (header.id != HttpHeader::CONNECTION) {
+            continue;
+        }
+        std::string_view value = header.value;
+        while (!value.empty()) {
+            size_t comma = value.find(',');
+            if (equalsIgnoreCase(trimWhitespace(value.substr(0, comma)), option)) {
+                return true;
+            }
+            value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+        }
+    }
+    return false;
+}
+
+template <typename T>
+size_t capacityBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+} // namespace
+
+const HeaderView* RequestView::findHeader(std::string_view name) const {
+    for (const HeaderView& header : headers) {
+        if (equalsIgnoreCase(header.name, name)) {
+            return &header;
+        }
+    }
+    return nullptr;
+}
+
+const HeaderView* RequestView::findHeader(HttpHeader id) const {
+    for (const HeaderView& header : headers) {
+        if (header.id == id) {
+            return &header;
+        }
+    }
+    return nullptr;
+}
+
+bool RequestView::keepAlive() const {
+    // HTTP/1.1默认保持连接，HTTP/1.0默认关闭
+    if (versionMinor >= 1) {
+        return !hasConnectionOption(*this, "close");
+    }
+    return hasConnectionOption(*this, "keep-alive");
+}
+
+HttpRequestParser::HttpRequestParser() : HttpRequestParser(Limits()) {}
+
+HttpRequestParser::HttpRequestParser(const Limits& limits)
+    : limits_(limits), maxBodySize_(limits.maxBodySize), decoder_(decoderLimits(limits)) {}
+
+void HttpRequestParser::reset() {
+    state_ = State::REQUEST_LINE;
+    error_ = Error::NONE;
+    position_ = 0;
+    scanned_ = 0;
+    requestLineBegin_ = 0;
+    methodLength_ = 0;
+    methodId_ = HttpMethod::UNKNOWN;
+    targetBegin_ = 0;
+    targetLength_ = 0;
+    versionMinor_ = 1;
+    headers_.clear();
+    bodyBegin_ = 0;
+    contentLength_ = 0;
+    bodyDiscarded_ = 0;
+    maxBodySize_ = limits_.maxBodySize;
+    chunked_ = false;
+    decoder_.reset();
+    decoder_.setMaxBodySize(maxBodySize_);
+    chunkedBody_.clear();
+    bodyHandler_ = nullptr;
+    request_.headers.clear();
+    request_.body = {};
+    request_.trailers.clear();
+    request_.length = 0;
+}
+
+void HttpRequestParser::releaseMemory() {
+    std::vector<HeaderOffsets>().swap(headers_);
+    std::string().swap(chunkedBody_);
+    std::vector<HeaderView>().swap(request_.headers);
+    std::vector<HeaderView>().swap(request_.trailers);
+}
+
+size_t HttpRequestParser::memoryUsage() const {
+    size_t bytes = capacityBytes(headers_) + capacityBytes(request_.headers) + capacityBytes(request_.trailers);
+    if (chunkedBody_.capacity() > std::string().capacity()) {
+        bytes += chunkedBody_.capacity() + 1;
+    }
+    return bytes;
+}
+
+HttpStatus HttpRequestParser::errorStatus() const {
+    switch (error_) {
+        case Error::BAD_VERSION:
+            return HttpStatus::HTTP_VERSION_NOT_SUPPORTED;
+        case Error::BAD_TRANSFER_ENCODING:
+            return HttpStatus::NOT_IMPLEMENTED;
+        case Error::URI_TOO_LONG:
+            return HttpStatus::URI_TOO_LONG;
+        case Error::HEADER_TOO_LARGE:
+            return HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE;
+        case Error::BODY_TOO_LARGE:
+            return HttpStatus::PAYLOAD_TOO_LARGE;
+        case Error::BODY_HANDLER_FAILED:
+            return HttpStatus::INTERNAL_SERVER_ERROR;
+        default:
+            return HttpStatus::BAD_REQUEST;
+    }
+}
+
+HttpRequestParser::Status HttpRequestParser::fail(Error error) {
+    state_ = State::ERROR;
+    error_ = error;
+    return Status::ERROR;
+}
+
+bool HttpRequestParser::nextLine(std::string_view data, size_t& lineEnd, size_t& next) {
+    // 只扫描上次之后新到达的字节
+    size_t start = std::max(position_, scanned_);
+    if (start >= data.size()) {
+        scanned_ = data.size();
+        return false;
+    }
+    const void* found = std::memchr(data.data() + start, '\n', data.size() - start);
+    if (!found) {
+        scanned_ = data.size();
+        return false;
+    }
+    size_t newline = static_cast<size_t>(static_cast<const char*>(found) - data.data());
+    lineEnd = newline > position_ && data[newline - 1] == '\r' ? newline - 1 : newline;
+    next = newline + 1;
+    scanned_ = next;
+    return true;
+}
+
+HttpRequestParser::Status HttpRequestParser::parse(std::string_view data) {
+    while (true) {
+        size_t lineEnd = 0;
+        size_t next = 0;
+        switch (state_) {
+            case State::REQUEST_LINE:
+            case State::HEADERS: {
+                bool complete = nextLine(data, lineEnd, next);
+                // 请求行单独限制，不必等到整个请求头超限才拒绝超长的请求目标
+                if (state_ == State::REQUEST_LINE &&
+                    (complete ? lineEnd : data.size()) - requestLineBegin_ > limits_.maxRequestLineBytes) {
+                    return fail(Error::URI_TOO_LONG);
+                }
+                if (!complete) {
+                    if (data.size() > limits_.maxHeaderBytes) {
+                        return fail(state_ == State::REQUEST_LINE ? Error::URI_TOO_LONG : Error::HEADER_TOO_LARGE);
+                    }
+                    return Status::INCOMPLETE;
+                }
+                if (next > limits_.maxHeaderBytes) {
+                    return fail(state_ == State::REQUEST_LINE ? Error::URI_TOO_LONG : Error::HEADER_TOO_LARGE);
+                }
+                if (state_ == State::REQUEST_LINE) {
+                    if (lineEnd == position_) {
+                        // 请求行之前的空行按RFC 9112忽略
+                        position_ = next;
+                        requestLineBegin_ = next;
+                        continue;
+                    }
+                    if (!parseRequestLine(data, lineEnd)) {
+                        return Status::ERROR;
+                    }
+                    state_ = State::HEADERS;
+                } else if (lineEnd == position_) {
+                    position_ = next;
+                    if (!finishHeaders(data)) {
+                        return Status::ERROR;
+                    }
+                    if (limits_.pauseAfterHeaders) {
+                        buildRequest(data);
+                        return Status::HEADERS_COMPLETE;
+                    }
+                    continue;
+                } else if (!parseHeaderLine(data, lineEnd)) {
+                    return Status::ERROR;
+                }
+                position_ = next;
+                break;
+            }
+
+            case State::BODY:
+            case State::CHUNKED: {
+                Status status = state_ == State::BODY ? parseBody(data) : parseChunked(data);
+                if (status != Status::COMPLETE) {
+                    return status;
+                }
+                break;
+            }
+
+            case State::COMPLETE:
+                buildRequest(data);
+                return Status::COMPLETE;
+
+            case State::ERROR:
+                return Status::ERROR;
+        }
+    }
+}
+
+bool HttpRequestParser::parseRequestLine(std::string_view data, size_t lineEnd) {
+    std::string_view line = data.substr(position_, lineEnd - position_);
+
+    // 方法是token，请求目标不含空白和控制字符，两者都以单个空格结束
+    size_t methodEnd = HeaderScanner::findTokenEnd(line.data(), line.size());
+    if (methodEnd == 0 || methodEnd == line.size() || line[methodEnd] != ' ') {
+        fail(Error::BAD_REQUEST_LINE);
+        return false;
+    }
+    std::string_view method = line.substr(0, methodEnd);
+    methodId_ = parseHttpMethod(method);
+    if (methodId_ == HttpMethod::UNKNOWN) {
+        fail(Error::BAD_METHOD);
+        return false;
+    }
+
+    size_t targetBegin = methodEnd + 1;
+    size_t targetEnd = targetBegin + HeaderScanner::findTargetEnd(line.data() + targetBegin, line.size() - targetBegin);
+    if (targetEnd == targetBegin || targetEnd == line.size() || line[targetEnd] != ' ') {
+        fail(Error::BAD_REQUEST_LINE);
+        return false;
+    }
+
+    std::string_view version = line.substr(targetEnd + 1);
+    if (version.size() != 8 || version.compare(0, 5, "HTTP/") != 0 ||
+        version[5] < '0' || version[5] > '9' || version[6] != '.' || version[7] < '0' || version[7] > '9') {
+        fail(Error::BAD_REQUEST_LINE);
+        return false;
+    }
+    if (version[5] != '1') {
+        fail(Error::BAD_VERSION);
+        return false;
+    }
+
+    methodLength_ = methodEnd;
+    targetBegin_ = position_ + methodEnd + 1;
+    targetLength_ = targetEnd - methodEnd - 1;
+    versionMinor_ = version[7] - '0';
+    return true;
+}
+
+bool HttpRequestParser::parseHeaderLine(std::string_view data, size_t lineEnd) {
+    std::string_view line = data.substr(position_, lineEnd - position_);
+
+    // 以空白开头的是已废弃的折行，名称和冒号之间也不允许空白
+    size_t colon = HeaderScanner::findTokenEnd(line.data(), line.size());
+    if (colon == 0 || colon == line.size() || line[colon] != ':') {
+        fail(Error::BAD_HEADER);
+        return false;
+    }
+    std::string_view rawValue = line.substr(colon + 1);
+    if (HeaderScanner::findFieldValueEnd(rawValue.data(), rawValue.size()) != rawValue.size()) {
+        fail(Error::BAD_HEADER);
+        return false;
+    }
+    std::string_view value = trimWhitespace(rawValue);
+    if (headers_.size() >= limits_.maxHeaders) {
+        fail(Error::HEADER_TOO_LARGE);
+        return false;
+    }
+
+    size_t valueBegin = value.empty() ? position_ + colon + 1
+                                      : static_cast<size_t>(value.data() - data.data());
+    headers_.push_back({position_, colon, valueBegin, value.size(), lookupHttpHeader(line.substr(0, colon))});
+    return true;
+}
+
+bool HttpRequestParser::finishHeaders(std::string_view data) {
+    bool hasHost = false;
+    bool hasContentLength = false;
+    bool hasTransferEncoding = false;
+    std::string_view transferEncoding;
+    for (const HeaderOffsets& header : headers_) {
+        std::string_view value = data.substr(header.valueBegin, header.valueLength);
+        if (header.id == HttpHeader::HOST) {
+            hasHost = true;
+        } else if (header.id == HttpHeader::TRANSFER_ENCODING) {
+            if (hasTransferEncoding) {
+                fail(Error::BAD_TRANSFER_ENCODING);
+                return false;
+            }
+            hasTransferEncoding = true;
+            transferEncoding = value;
+        } else if (header.id == HttpHeader::CONTENT_LENGTH) {
+            // 只接受十进制数字；重复出现时必须一致
+            if (value.empty() || value.size() > 19) {
+                fail(Error::BAD_CONTENT_LENGTH);
+                return false;
+            }
+            size_t length = 0;
+            for (char c : value) {
+                if (c < '0' || c > '9') {
+                    fail(Error::BAD_CONTENT_LENGTH);
+                    return false;
+                }
+                length = length * 10 + static_cast<size_t>(c - '0');
+            }
+            if (hasContentLength && length != contentLength_) {
+                fail(Error::BAD_CONTENT_LENGTH);
+                return false;
+            }
+            hasContentLength = true;
+            contentLength_ = length;
+        }
+    }
+
+    if (versionMinor_ == 1 && !hasHost) {
+        fail(Error::MISSING_HOST);
+        return false;
+    }
+    if (hasTransferEncoding) {
+        // 同时出现两种长度时无法确定请求边界（请求走私），直接拒绝
+        if (hasContentLength) {
+            fail(Error::BAD_CONTENT_LENGTH);
+            return false;
+        }
+        if (!equalsIgnoreCase(transferEncoding, "chunked")) {
+            fail(Error::BAD_TRANSFER_ENCODING);
+            return false;
+        }
+        chunked_ = true;
+    }
+    bodyBegin_ = position_;
+    state_ = chunked_ ? State::CHUNKED : State::BODY;
+    return true;
+}
+
+bool HttpRequestParser::setBodyHandler(BodyHandler handler) {
+    bodyHandler_ = std::move(handler);
+    if (!bodyHandler_ || chunkedBody_.empty()) {
+        return true;
+    }
+    // 先交出设置之前已经解码的分块数据
+    bool accepted = deliverBody(chunkedBody_);
+    chunkedBody_.clear();
+    return accepted;
+}
+
+bool HttpRequestParser::deliverBody(std::string_view chunk) {
+    if (!bodyHandler_) {
+        chunkedBody_.append(chunk.data(), chunk.size());
+        return true;
+    }
+    if (!bodyHandler_(chunk)) {
+        fail(Error::BODY_HANDLER_FAILED);
+        return false;
+    }
+    return true;
+}
+
+void HttpRequestParser::setMaxBodySize(size_t size) {
+    maxBodySize_ = size;
+    decoder_.setMaxBodySize(size);
+}
+
+size_t HttpRequestParser::discardDeliveredBody(std::string& buffer) {
+    // 没有BodyHandler时请求体要留在缓冲区中供request()引用
+    if (!bodyHandler_ || (state_ != State::BODY && state_ != State::CHUNKED) || position_ <= bodyBegin_) {
+        return 0;
+    }
+    size_t count = position_ - bodyBegin_;
+    buffer.erase(bodyBegin_, count);
+    position_ = bodyBegin_;
+    scanned_ = position_;
+    bodyDiscarded_ += count;
+    return count;
+}
+
+HttpRequestParser::Status HttpRequestParser::parseBody(std::string_view data) {
+    // 上限可能在请求头之后才被调整，所以在这里而不是finishHeaders()中检查
+    if (contentLength_ > maxBodySize_) {
+        return fail(Error::BODY_TOO_LARGE);
+    }
+    size_t end = bodyBegin_ + contentLength_ - bodyDiscarded_;
+    if (bodyHandler_) {
+        // 已到达的部分立即交出，不必等整个请求体收全
+        size_t available = std::min(data.size(), end) - position_;
+        if (available > 0) {
+            if (!deliverBody(data.substr(position_, available))) {
+                return Status::ERROR;
+            }
+            position_ += available;
+        }
+    }
+    if (data.size() < end) {
+        return Status::INCOMPLETE;
+    }
+    position_ = end;
+    state_ = State::COMPLETE;
+    return Status::COMPLETE;
+}
+
+HttpRequestParser::Status HttpRequestParser::parseChunked(std::string_view data) {
+    while (true) {
+        size_t consumed = 0;
+        std::string_view chunk;
+        ChunkedDecoder::Status status = decoder_.decode(data.substr(position_), consumed, chunk);
+        position_ += consumed;
+        switch (status) {
+            case ChunkedDecoder::Status::DATA:
+                if (!deliverBody(chunk)) {
+                    return Status::ERROR;
+                }
+                break;
+            case ChunkedDecoder::Status::NEED_MORE:
+                return Status::INCOMPLETE;
+            case ChunkedDecoder::Status::DONE:
+                state_ = State::COMPLETE;
+                return Status::COMPLETE;
+            case ChunkedDecoder::Status::ERROR:
+                switch (decoder_.error()) {
+                    case ChunkedDecoder::Error::BODY_TOO_LARGE:
+                        return fail(Error::BODY_TOO_LARGE);
+                    case ChunkedDecoder::Error::TRAILER_TOO_LARGE:
+                        return fail(Error::HEADER_TOO_LARGE);
+                    default:
+                        return fail(Error::BAD_CHUNK);
+                }
+        }
+    }
+}
+
+void HttpRequestParser::buildRequest(std::string_view data) {
+    request_.method = data.substr(requestLineBegin_, methodLength_);
+    request_.methodId = methodId_;
+    request_.target = data.substr(targetBegin_, targetLength_);
+    size_t queryStart = request_.target.find('?');
+    request_.path = request_.target.substr(0, queryStart);
+    request_.query = queryStart == std::string_view::npos ? std::string_view() : request_.target.substr(queryStart + 1);
+    request_.versionMinor = versionMinor_;
+    request_.headers.clear();
+    request_.headers.reserve(headers_.size());
+    for (const HeaderOffsets& header : headers_) {
+        request_.headers.push_back({data.substr(header.nameBegin, header.nameLength),
+                                    data.substr(header.valueBegin, header.valueLength), header.id});
+    }
+    if (bodyHandler_ || state_ != State::COMPLETE) {
+        request_.body = {};
+    } else {
+        request_.body = chunked_ ? std::string_view(chunkedBody_) : data.substr(bodyBegin_, contentLength_);
+    }
+    request_.trailers.clear();
+    for (const HttpHeaders::Entry& trailer : decoder_.trailers()) {
+        request_.trailers.push_back({trailer.name, trailer.value, trailer.id});
+    }
+    request_.length = position_;
+}
+
+} // namespace webserver
@@ -48,6 +48,7 @@ HttpStatusHandler::HttpStatusHandler() {
         {417, "Expectation Failed"},
         {426, "Upgrade Required"},
         {429, "Too Many Requests"},
+        {431, "Request Header Fields Too Large"},
 
         // 5xx: 服务器错误状态码
         {500, "Internal Server Error"},
@@ -0,0 +1,259 @@
+#include "IoUring.hpp"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace webserver {
+
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags,
+                                    nullptr, 0));
+}
+
+int ioUringRegister(int ringFd, unsigned opcode, const void* arg, unsigned nrArgs) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, nrArgs));
+}
+
+template<typename T>
+T* ringField(void* base, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+IoUring::IoUring(unsigned entries)
+    : ringFd_(-1),
+      params_{},
+      sqRingPtr_(MAP_FAILED),
+      sqRingSize_(0),
+      cqRingPtr_(MAP_FAILED),
+      cqRingSize_(0),
+      sqes_(nullptr),
+      sqesSize_(0),
+      sqHead_(nullptr),
+      sqTail_(nullptr),
+      sqFlags_(nullptr),
+      sqMask_(0),
+      sqEntries_(0),
+      sqeTail_(0),
+      cqHead_(nullptr),
+      cqTail_(nullptr),
+      cqMask_(0),
+      cqes_(nullptr),
+      bufferRing_(nullptr),
+      bufferRingTail_(nullptr),
+      bufferRingSize_(0),
+      bufferMask_(0),
+      bufferTail_(0),
+      bufferSize_(0),
+      fileCount_(0),
+      syscalls_(0) {
+    // 完成队列放大到提交队列的4倍，多发请求会为一次提交产生多个完成项
+    params_.flags = IORING_SETUP_CQSIZE;
+    params_.cq_entries = entries * 4;
+
+    ringFd_ = ioUringSetup(entries, &params_);
+    if (ringFd_ < 0) {
+        throw std::runtime_error("io_uring_setup failed: " + std::string(strerror(errno)));
+    }
+
+    sqRingSize_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        cqRingSize_ = sqRingSize_;
+    }
+
+    sqRingPtr_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd_, IORING_OFF_SQ_RING);
+    if (sqRingPtr_ == MAP_FAILED) {
+        std::string error = strerror(errno);
+        close(ringFd_);
+        throw std::runtime_error("Failed to map io_uring submission ring: " + error);
+    }
+
+    if (singleMmap) {
+        cqRingPtr_ = sqRingPtr_;
+    } else {
+        cqRingPtr_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ringFd_, IORING_OFF_CQ_RING);
+        if (cqRingPtr_ == MAP_FAILED) {
+            std::string error = strerror(errno);
+            munmap(sqRingPtr_, sqRingSize_);
+            close(ringFd_);
+            throw std::runtime_error("Failed to map io_uring completion ring: " + error);
+        }
+    }
+
+    sqesSize_ = params_.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        std::string error = strerror(errno);
+        if (!singleMmap) {
+            munmap(cqRingPtr_, cqRingSize_);
+        }
+        munmap(sqRingPtr_, sqRingSize_);
+        close(ringFd_);
+        throw std::runtime_error("Failed to map io_uring submission entries: " + error);
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sqHead_ = ringField<unsigned>(sqRingPtr_, params_.sq_off.head);
+    sqTail_ = ringField<unsigned>(sqRingPtr_, params_.sq_off.tail);
+    sqFlags_ = ringField<unsigned>(sqRingPtr_, params_.sq_off.flags);
+    sqMask_ = *ringField<unsigned>(sqRingPtr_, params_.sq_off.ring_mask);
+    sqEntries_ = *ringField<unsigned>(sqRingPtr_, params_.sq_off.ring_entries);
+    sqeTail_ = *sqTail_;
+
+    // 提交队列项与下标一一对应，之后只需推进尾指针
+    unsigned* sqArray = ringField<unsigned>(sqRingPtr_, params_.sq_off.array);
+    for (unsigned i = 0; i < sqEntries_; ++i) {
+        sqArray[i] = i;
+    }
+
+    cqHead_ = ringField<unsigned>(cqRingPtr_, params_.cq_off.head);
+    cqTail_ = ringField<unsigned>(cqRingPtr_, params_.cq_off.tail);
+    cqMask_ = *ringField<unsigned>(cqRingPtr_, params_.cq_off.ring_mask);
+    cqes_ = ringField<io_uring_cqe>(cqRingPtr_, params_.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+    // 关闭实例会取消所有未完成的请求并释放注册的资源
+    close(ringFd_);
+    if (bufferRing_ != nullptr) {
+        munmap(bufferRing_, bufferRingSize_);
+    }
+    munmap(sqes_, sqesSize_);
+    if (cqRingPtr_ != sqRingPtr_) {
+        munmap(cqRingPtr_, cqRingSize_);
+    }
+    munmap(sqRingPtr_, sqRingSize_);
+}
+
+io_uring_sqe* IoUring::getSqe() {
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    if (sqeTail_ - head >= sqEntries_) {
+        submit();
+        head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (sqeTail_ - head >= sqEntries_) {
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe* sqe = &sqes_[sqeTail_ & sqMask_];
+    ++sqeTail_;
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IoUring::submit() {
+    unsigned pending = sqeTail_ - *sqTail_;
+    if (pending == 0) {
+        return 0;
+    }
+
+    __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    int submitted;
+    do {
+        submitted = ioUringEnter(ringFd_, pending, 0, 0);
+    } while (submitted < 0 && errno == EINTR);
+    return submitted < 0 ? -errno : submitted;
+}
+
+int IoUring::submitAndWait() {
+    unsigned pending = sqeTail_ - *sqTail_;
+    __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    int result = ioUringEnter(ringFd_, pending, 1, IORING_ENTER_GETEVENTS);
+    return result < 0 ? -errno : result;
+}
+
+void IoUring::flushOverflow() {
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    ioUringEnter(ringFd_, 0, 0, IORING_ENTER_GETEVENTS);
+}
+
+bool IoUring::registerEventFd(int eventFd) {
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    return ioUringRegister(ringFd_, IORING_REGISTER_EVENTFD, &eventFd, 1) == 0;
+}
+
+bool IoUring::registerFiles(unsigned count) {
+    io_uring_rsrc_register reg{};
+    reg.nr = count;
+    reg.flags = IORING_RSRC_REGISTER_SPARSE;
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    if (ioUringRegister(ringFd_, IORING_REGISTER_FILES2, &reg, sizeof(reg)) != 0) {
+        return false;
+    }
+    fileCount_ = count;
+    return true;
+}
+
+bool IoUring::updateFile(unsigned slot, int fd) {
+    io_uring_files_update update{};
+    update.offset = slot;
+    update.fds = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&fd));
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    return ioUringRegister(ringFd_, IORING_REGISTER_FILES_UPDATE, &update, 1) == 1;
+}
+
+bool IoUring::registerBufferRing(uint16_t groupId, unsigned count, size_t bufferSize) {
+    if (count == 0 || count > 32768 || (count & (count - 1)) != 0 || bufferRing_ != nullptr) {
+        return false;
+    }
+
+    bufferRingSize_ = count * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, bufferRingSize_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        return false;
+    }
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ring));
+    reg.ring_entries = count;
+    reg.bgid = groupId;
+    syscalls_.fetch_add(1, std::memory_order_relaxed);
+    if (ioUringRegister(ringFd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        munmap(ring, bufferRingSize_);
+        return false;
+    }
+
+    // 不通过io_uring_buf_ring访问：C++中其柔性数组成员前会多出一个空结构体，偏移量与内核不一致
+    bufferRing_ = static_cast<io_uring_buf*>(ring);
+    bufferRingTail_ = &bufferRing_[0].resv;
+    bufferMask_ = count - 1;
+    bufferSize_ = bufferSize;
+    bufferMemory_.resize(count * bufferSize);
+    for (unsigned i = 0; i < count; ++i) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+    return true;
+}
+
+void IoUring::recycleBuffer(uint16_t bufferId) {
+    io_uring_buf& buf = bufferRing_[bufferTail_ & bufferMask_];
+    buf.addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(buffer(bufferId)));
+    buf.len = static_cast<uint32_t>(bufferSize_);
+    buf.bid = bufferId;
+    ++bufferTail_;
+    // 尾指针与第一个缓冲区的resv字段共用内存，需以release语义发布
+    __atomic_store_n(bufferRingTail_, bufferTail_, __ATOMIC_RELEASE);
+}
+
+} // namespace webserver
@@ -0,0 +1,126 @@
+#include "IpAddress.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <cerrno>
+#include <cstdlib>
+
+namespace webserver {
+
+namespace {
+// IPv4映射地址的前96位：80个0后跟16个1
+constexpr size_t kV4MappedPrefixBytes = 12;
+constexpr unsigned kV4PrefixBits = 96;
+}
+
+bool IpAddress::isV4() const {
+    for (size_t i = 0; i < 10; ++i) {
+        if (bytes[i] != 0) {
+            return false;
+        }
+    }
+    return bytes[10] == 0xff && bytes[11] == 0xff;
+}
+
+bool IpAddress::isUnspecified() const {
+    for (uint8_t byte : bytes) {
+        if (byte != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+IpAddress IpAddress::fromV4(uint32_t address) {
+    IpAddress result;
+    result.bytes[10] = 0xff;
+    result.bytes[11] = 0xff;
+    result.bytes[12] = static_cast<uint8_t>(address >> 24);
+    result.bytes[13] = static_cast<uint8_t>(address >> 16);
+    result.bytes[14] = static_cast<uint8_t>(address >> 8);
+    result.bytes[15] = static_cast<uint8_t>(address);
+    return result;
+}
+
+IpAddress IpAddress::fromSockaddr(const struct sockaddr* addr) {
+    IpAddress result;
+    if (addr->sa_family == AF_INET) {
+        const auto* v4 = reinterpret_cast<const struct sockaddr_in*>(addr);
+        result.bytes[10] = 0xff;
+        result.bytes[11] = 0xff;
+        std::memcpy(result.bytes.data() + kV4MappedPrefixBytes, &v4->sin_addr, 4);
+    } else if (addr->sa_family == AF_INET6) {
+        const auto* v6 = reinterpret_cast<const struct sockaddr_in6*>(addr);
+        std::memcpy(result.bytes.data(), &v6->sin6_addr, 16);
+    }
+    return result;
+}
+
+bool IpAddress::parse(const std::string& text, IpAddress& address) {
+    IpAddress result;
+    struct in_addr v4;
+    if (inet_pton(AF_INET, text.c_str(), &v4) == 1) {
+        result.bytes[10] = 0xff;
+        result.bytes[11] = 0xff;
+        std::memcpy(result.bytes.data() + kV4MappedPrefixBytes, &v4, 4);
+        address = result;
+        return true;
+    }
+    if (inet_pton(AF_INET6, text.c_str(), result.bytes.data()) == 1) {
+        address = result;
+        return true;
+    }
+    return false;
+}
+
+bool IpAddress::parseCidr(const std::string& text, IpAddress& address, unsigned& prefixLength) {
+    size_t slash = text.find('/');
+    IpAddress network;
+    if (!parse(text.substr(0, slash), network)) {
+        return false;
+    }
+
+    unsigned maxLength = network.isV4() ? 32 : 128;
+    unsigned length = maxLength;
+    if (slash != std::string::npos) {
+        const char* begin = text.c_str() + slash + 1;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long value = std::strtoul(begin, &end, 10);
+        if (end == begin || *end != '\0' || errno != 0 || value > maxLength) {
+            return false;
+        }
+        length = static_cast<unsigned>(value);
+    }
+    if (network.isV4()) {
+        length += kV4PrefixBits;
+    }
+
+    address = network.masked(length);
+    prefixLength = length;
+    return true;
+}
+
+IpAddress IpAddress::masked(unsigned prefixLength) const {
+    IpAddress result = *this;
+    for (size_t i = 0; i < result.bytes.size(); ++i) {
+        unsigned bitsBefore = static_cast<unsigned>(i * 8);
+        if (prefixLength >= bitsBefore + 8) {
+            continue;
+        }
+        unsigned keep = prefixLength > bitsBefore ? prefixLength - bitsBefore : 0;
+        result.bytes[i] = static_cast<uint8_t>(result.bytes[i] & (0xff00u >> keep));
+    }
+    return result;
+}
+
+std::string IpAddress::toString() const {
+    char buffer[INET6_ADDRSTRLEN];
+    if (isV4()) {
+        inet_ntop(AF_INET, bytes.data() + kV4MappedPrefixBytes, buffer, sizeof(buffer));
+    } else {
+        inet_ntop(AF_INET6, bytes.data(), buffer, sizeof(buffer));
+    }
+    return buffer;
+}
+
+} // namespace webserver
@@ -0,0 +1,133 @@
+#include "IpFilter.hpp"
+#include "Logger.hpp"
+#include <sstream>
+
+namespace webserver {
+
+namespace {
+constexpr unsigned kV4PrefixBits = 96;
+constexpr unsigned kAddressBits = 128;
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+} // namespace
+
+IpFilter::IpFilter() {
+    snapshots_.push_back(std::make_unique<const Snapshot>());
+    current_.store(snapshots_.back().get(), std::memory_order_release);
+}
+
+IpFilter::~IpFilter() = default;
+
+bool IpFilter::insertRules(Snapshot& snapshot, const std::string& list, Action action) {
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = trim(item);
+        if (item.empty()) {
+            continue;
+        }
+
+        IpAddress network;
+        unsigned prefixLength = 0;
+        if (!IpAddress::parseCidr(item, network, prefixLength)) {
+            LOG_ERROR("Invalid CIDR in IP access list: " + item);
+            return false;
+        }
+
+        uint32_t node = 0;
+        for (unsigned depth = 0; depth < prefixLength; ++depth) {
+            unsigned bit = network.bit(depth);
+            if (snapshot.nodes[node].child[bit] == 0) {
+                snapshot.nodes[node].child[bit] = static_cast<uint32_t>(snapshot.nodes.size());
+                snapshot.nodes.emplace_back();
+            }
+            node = snapshot.nodes[node].child[bit];
+        }
+        // 拒绝规则后插入，同一前缀上覆盖允许规则
+        snapshot.nodes[node].action = action;
+        ++snapshot.rules;
+    }
+    return true;
+}
+
+bool IpFilter::load(const std::string& allowList, const std::string& denyList) {
+    auto snapshot = std::make_unique<Snapshot>();
+    if (!insertRules(*snapshot, allowList, ALLOW) || !insertRules(*snapshot, denyList, DENY)) {
+        return false;
+    }
+    snapshot->defaultAllow = trim(allowList).empty();
+
+    // 预先走完IPv4映射前缀，IPv4地址查询时只需再比较32位
+    IpAddress v4Prefix = IpAddress::fromV4(0);
+    uint32_t node = 0;
+    Action inherited = snapshot->nodes[0].action;
+    unsigned depth = 0;
+    for (; depth < kV4PrefixBits; ++depth) {
+        node = snapshot->nodes[node].child[v4Prefix.bit(depth)];
+        if (node == 0) {
+            break;
+        }
+        if (snapshot->nodes[node].action != NONE) {
+            inherited = snapshot->nodes[node].action;
+        }
+    }
+    snapshot->v4Root = depth == kV4PrefixBits ? node : 0;
+    snapshot->v4Inherited = inherited;
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    snapshots_.push_back(std::move(snapshot));
+    current_.store(snapshots_.back().get(), std::memory_order_release);
+    return true;
+}
+
+IpFilter::Action IpFilter::match(const Snapshot& snapshot, uint32_t node, unsigned depth,
+                                 const IpAddress& address, Action matched) {
+    const Node* nodes = snapshot.nodes.data();
+    if (nodes[node].action != NONE) {
+        matched = nodes[node].action;
+    }
+    for (; depth < kAddressBits; ++depth) {
+        node = nodes[node].child[address.bit(depth)];
+        if (node == 0) {
+            break;
+        }
+        if (nodes[node].action != NONE) {
+            matched = nodes[node].action;
+        }
+    }
+    return matched;
+}
+
+bool IpFilter::isAllowed(const IpAddress& address) const {
+    const Snapshot& snapshot = *current_.load(std::memory_order_acquire);
+    if (snapshot.rules == 0) {
+        return true;
+    }
+
+    Action action;
+    if (address.isV4()) {
+        action = snapshot.v4Root != 0
+            ? match(snapshot, snapshot.v4Root, kV4PrefixBits, address, snapshot.v4Inherited)
+            : snapshot.v4Inherited;
+    } else {
+        action = match(snapshot, 0, 0, address, NONE);
+    }
+
+    if (action == NONE) {
+        return snapshot.defaultAllow;
+    }
+    return action == ALLOW;
+}
+
+size_t IpFilter::ruleCount() const {
+    return current_.load(std::memory_order_acquire)->rules;
+}
+
+} // namespace webserver
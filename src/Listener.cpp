@@ -0,0 +1,105 @@
+#include "Listener.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/un.h>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace webserver {
+
+std::vector<ListenerSpec> ListenerSpec::fromConfig(const Config& config, int defaultPort) {
+    std::vector<ListenerSpec> listeners;
+    nlohmann::json entries = config.get<nlohmann::json>("server.listeners", nlohmann::json::array());
+    if (!entries.is_array()) {
+        throw std::runtime_error("server.listeners must be an array");
+    }
+
+    for (const auto& entry : entries) {
+        if (!entry.is_object()) {
+            throw std::runtime_error("Each entry in server.listeners must be an object");
+        }
+        ListenerSpec spec;
+        std::string type = entry.value("type", std::string("tcp"));
+        if (type == "tcp") {
+            spec.type = Type::TCP;
+            spec.address = entry.value("address", std::string("0.0.0.0"));
+            spec.port = entry.value("port", defaultPort);
+            spec.ipv6Only = entry.value("ipv6_only", false);
+            if (spec.port < 0 || spec.port > 65535) {
+                throw std::runtime_error("Invalid listener port: " + std::to_string(spec.port));
+            }
+        } else if (type == "unix") {
+            spec.type = Type::UNIX;
+            spec.path = entry.value("path", std::string());
+            spec.abstractNamespace = entry.value("abstract", false);
+        } else {
+            throw std::runtime_error("Unknown listener type: " + type);
+        }
+
+        struct sockaddr_storage addr;
+        socklen_t length;
+        if (!spec.toSockaddr(addr, length)) {
+            throw std::runtime_error("Invalid listener address: " + spec.toString());
+        }
+        listeners.push_back(spec);
+    }
+
+    if (listeners.empty()) {
+        ListenerSpec spec;
+        spec.port = defaultPort;
+        listeners.push_back(spec);
+    }
+    return listeners;
+}
+
+int ListenerSpec::family() const {
+    if (type == Type::UNIX) {
+        return AF_UNIX;
+    }
+    return address.find(':') != std::string::npos ? AF_INET6 : AF_INET;
+}
+
+bool ListenerSpec::toSockaddr(struct sockaddr_storage& addr, socklen_t& length) const {
+    std::memset(&addr, 0, sizeof(addr));
+
+    if (type == Type::UNIX) {
+        auto* un = reinterpret_cast<struct sockaddr_un*>(&addr);
+        un->sun_family = AF_UNIX;
+        // 抽象命名空间的名字以'\0'开头，长度由地址长度决定而不是结尾的'\0'
+        size_t offset = abstractNamespace ? 1 : 0;
+        if (path.empty() || path.size() + offset >= sizeof(un->sun_path)) {
+            return false;
+        }
+        std::memcpy(un->sun_path + offset, path.data(), path.size());
+        length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + offset + path.size() +
+                                        (abstractNamespace ? 0 : 1));
+        return true;
+    }
+
+    if (family() == AF_INET6) {
+        auto* in6 = reinterpret_cast<struct sockaddr_in6*>(&addr);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(static_cast<uint16_t>(port));
+        length = sizeof(*in6);
+        return inet_pton(AF_INET6, address.c_str(), &in6->sin6_addr) == 1;
+    }
+
+    auto* in = reinterpret_cast<struct sockaddr_in*>(&addr);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(static_cast<uint16_t>(port));
+    length = sizeof(*in);
+    return inet_pton(AF_INET, address.c_str(), &in->sin_addr) == 1;
+}
+
+std::string ListenerSpec::toString() const {
+    if (type == Type::UNIX) {
+        return "unix:" + std::string(abstractNamespace ? "@" : "") + path;
+    }
+    if (family() == AF_INET6) {
+        return "tcp://[" + address + "]:" + std::to_string(port) + (ipv6Only ? "" : " (dual-stack)");
+    }
+    return "tcp://" + address + ":" + std::to_string(port);
+}
+
+} // namespace webserver
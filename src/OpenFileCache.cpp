@@ -0,0 +1,142 @@
+#include "OpenFileCache.hpp"
+#include "utils/DateTimeUtils.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace webserver {
+
+namespace {
+// 大文件打开时提前读入的长度，之后由顺序预读接管
+constexpr off_t kReadaheadWindow = 2 * 1024 * 1024;
+
+std::string makeEtag(time_t mtime, off_t size) {
+    char etag[48];
+    snprintf(etag, sizeof(etag), "\"%llx-%llx\"",
+             static_cast<unsigned long long>(mtime), static_cast<unsigned long long>(size));
+    return etag;
+}
+} // namespace
+
+OpenFile::~OpenFile() {
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+bool OpenFile::isCurrent() const {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && inode == st.st_ino && device == st.st_dev &&
+           size == st.st_size && mtime == st.st_mtime;
+}
+
+OpenFileCache::OpenFileCache(size_t capacity, std::chrono::milliseconds revalidateInterval,
+                             off_t readaheadThreshold)
+    : capacity_(capacity), revalidateInterval_(revalidateInterval), readaheadThreshold_(readaheadThreshold) {}
+
+std::shared_ptr<const OpenFile> OpenFileCache::open(const std::string& path, int& error) const {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        error = errno;
+        return nullptr;
+    }
+    auto file = std::make_shared<OpenFile>();
+    file->fd = fd;
+    file->path = path;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        error = errno;
+        return nullptr;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        error = S_ISDIR(st.st_mode) ? EISDIR : EACCES;
+        return nullptr;
+    }
+    file->size = st.st_size;
+    file->mtime = st.st_mtime;
+    file->inode = st.st_ino;
+    file->device = st.st_dev;
+    file->lastModified = DateTimeUtils::formatHttpDate(st.st_mtime);
+    file->etag = makeEtag(st.st_mtime, st.st_size);
+
+    // 大文件按顺序发送：加大预读窗口并提前读入开头部分，减少sendfile在磁盘I/O上的阻塞
+    if (readaheadThreshold_ > 0 && st.st_size >= readaheadThreshold_) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        posix_fadvise(fd, 0, std::min(st.st_size, kReadaheadWindow), POSIX_FADV_WILLNEED);
+    }
+    return file;
+}
+
+std::shared_ptr<const OpenFile> OpenFileCache::acquire(const std::string& path, int& error) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end()) {
+            Entry& entry = it->second;
+            bool valid = now - entry.validatedAt < revalidateInterval_;
+            if (!valid) {
+                // 文件被修改、替换或删除后重新打开
+                valid = entry.file->isCurrent();
+                entry.validatedAt = now;
+            }
+            if (valid) {
+                lru_.splice(lru_.begin(), lru_, entry.lruPosition);
+                stats_.hits++;
+                return entry.file;
+            }
+            lru_.erase(entry.lruPosition);
+            entries_.erase(it);
+        }
+        stats_.misses++;
+    }
+
+    // 打开文件不持有锁，其他线程的命中不受磁盘I/O影响
+    std::shared_ptr<const OpenFile> file = open(path, error);
+    if (!file || capacity_ == 0) {
+        return file;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it != entries_.end()) {
+        // 其他线程已经打开过同一文件
+        it->second.file = file;
+        it->second.validatedAt = now;
+        lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+        return file;
+    }
+    while (entries_.size() >= capacity_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+    lru_.push_front(path);
+    entries_[path] = Entry{file, now, lru_.begin()};
+    return file;
+}
+
+void OpenFileCache::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it != entries_.end()) {
+        lru_.erase(it->second.lruPosition);
+        entries_.erase(it);
+    }
+}
+
+size_t OpenFileCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+OpenFileCache::Stats OpenFileCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace webserver
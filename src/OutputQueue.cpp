@@ -0,0 +1,135 @@
+#include "OutputQueue.hpp"
+#include <algorithm>
+
+namespace webserver {
+
+void OutputQueue::append(std::string data) {
+    if (data.empty()) {
+        return;
+    }
+    // 移动shared_ptr不会移动字符串本身，data()在段的生命周期内保持不变
+    auto owned = std::make_shared<const std::string>(std::move(data));
+    const char* start = owned->data();
+    size_t size = owned->size();
+    append(std::move(owned), start, size);
+}
+
+void OutputQueue::append(std::shared_ptr<const void> owner, const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    Segment segment;
+    segment.owner = std::move(owner);
+    segment.data = data;
+    segment.size = size;
+    push(std::move(segment));
+    bytes_ += size;
+}
+
+void OutputQueue::appendFile(std::shared_ptr<const OpenFile> file, off_t offset, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    Segment segment;
+    segment.file = std::move(file);
+    segment.fileOffset = offset;
+    segment.size = length;
+    push(std::move(segment));
+    bytes_ += length;
+}
+
+void OutputQueue::prepend(std::string data) {
+    if (data.empty()) {
+        return;
+    }
+    auto owned = std::make_shared<const std::string>(std::move(data));
+    Segment segment;
+    segment.data = owned->data();
+    segment.size = owned->size();
+    segment.owner = std::move(owned);
+    bytes_ += segment.size;
+    if (head_ > 0) {
+        segments_[--head_] = std::move(segment);
+    } else {
+        segments_.insert(segments_.begin(), std::move(segment));
+    }
+}
+
+void OutputQueue::push(Segment segment) {
+    if (head_ > 0 && segments_.size() == segments_.capacity()) {
+        // 扩容前先回收队首之前已发送的段
+        segments_.erase(segments_.begin(), segments_.begin() + static_cast<std::ptrdiff_t>(head_));
+        head_ = 0;
+    }
+    segments_.push_back(std::move(segment));
+}
+
+size_t OutputQueue::gather(struct iovec* iov, size_t maxCount, bool& more) const {
+    size_t count = 0;
+    auto it = segments_.begin() + static_cast<std::ptrdiff_t>(head_);
+    for (; it != segments_.end() && count < maxCount && !it->file; ++it) {
+        iov[count].iov_base = const_cast<char*>(it->data);
+        iov[count].iov_len = it->size;
+        ++count;
+    }
+    more = it != segments_.end();
+    return count;
+}
+
+bool OutputQueue::frontFile(int& fd, off_t& offset, size_t& remaining) const {
+    if (empty() || !segments_[head_].file) {
+        return false;
+    }
+    const Segment& segment = segments_[head_];
+    fd = segment.file->fd;
+    offset = segment.fileOffset;
+    remaining = segment.size;
+    return true;
+}
+
+void OutputQueue::collectOwners(size_t bytes, std::vector<std::shared_ptr<const void>>& owners) const {
+    for (auto it = segments_.begin() + static_cast<std::ptrdiff_t>(head_);
+         bytes > 0 && it != segments_.end() && !it->file; ++it) {
+        owners.push_back(it->owner);
+        bytes -= std::min(bytes, it->size);
+    }
+}
+
+void OutputQueue::consume(size_t bytes) {
+    bytes_ -= std::min(bytes, bytes_);
+    while (bytes > 0 && !empty()) {
+        Segment& segment = segments_[head_];
+        if (bytes < segment.size) {
+            if (segment.file) {
+                segment.fileOffset += static_cast<off_t>(bytes);
+            } else {
+                segment.data += bytes;
+            }
+            segment.size -= bytes;
+            return;
+        }
+        bytes -= segment.size;
+        // 立即释放段持有的缓冲区，段本身留到队列清空时回收
+        segment = Segment();
+        head_++;
+    }
+    if (empty()) {
+        segments_.clear();
+        head_ = 0;
+    }
+}
+
+void OutputQueue::clear() {
+    segments_.clear();
+    head_ = 0;
+    bytes_ = 0;
+}
+
+void OutputQueue::releaseMemory() {
+    if (empty()) {
+        std::vector<Segment>().swap(segments_);
+        head_ = 0;
+    }
+}
+
+} // namespace webserver
@@ -21,8 +21,46 @@ Router::Router() {
     });
 }
 
-void Router::addRoute(const std::string& path, RequestHandler handler) {
+void Router::addRoute(const std::string& path, RequestHandler handler, bool offload) {
+    removeRoute(path);
     routes_[path] = handler;
+    if (offload) {
+        offloadedRoutes_.insert(path);
+    }
+}
+
+void Router::addUploadRoute(const std::string& path, UploadHandler handler, bool offload) {
+    removeRoute(path);
+    uploadRoutes_[path] = std::move(handler);
+    if (offload) {
+        offloadedRoutes_.insert(path);
+    }
+}
+
+void Router::addStreamRoute(const std::string& path, StreamHandler handler) {
+    removeRoute(path);
+    streamRoutes_[path] = std::move(handler);
+}
+
+void Router::removeRoute(const std::string& path) {
+    routes_.erase(path);
+    uploadRoutes_.erase(path);
+    streamRoutes_.erase(path);
+    offloadedRoutes_.erase(path);
+}
+
+Router::BodyMode Router::bodyMode(const std::string& path) const {
+    if (uploadRoutes_.count(path) > 0) {
+        return BodyMode::SPOOLED;
+    }
+    if (streamRoutes_.count(path) > 0) {
+        return BodyMode::STREAMED;
+    }
+    return BodyMode::BUFFERED;
+}
+
+bool Router::isOffloaded(const std::string& path) const {
+    return offloadedRoutes_.count(path) > 0;
 }
 
 std::pair<bool, std::string> Router::handleRequest(const std::string& path,
@@ -39,4 +77,29 @@ std::pair<bool, std::string> Router::handleRequest(const std::string& path,
     return {false, ""};
 }
 
-} // namespace webserver
\ No newline at end of file
+std::pair<bool, std::string> Router::handleUpload(const std::string& path,
+    const std::map<std::string, std::string>& headers,
+    const SpooledBody& body) const {
+
+    auto it = uploadRoutes_.find(path);
+    if (it != uploadRoutes_.end()) {
+        LOG_INFO("Found upload handler for path: " + path + ", body size " + std::to_string(body.size()));
+        return {true, it->second(headers, body)};
+    }
+
+    LOG_WARNING("No upload handler found for path: " + path);
+    return {false, ""};
+}
+
+std::unique_ptr<BodyConsumer> Router::openStream(const std::string& path,
+    const std::map<std::string, std::string>& headers) const {
+
+    auto it = streamRoutes_.find(path);
+    if (it == streamRoutes_.end()) {
+        LOG_WARNING("No stream handler found for path: " + path);
+        return nullptr;
+    }
+    return it->second(headers);
+}
+
+} // namespace webserver
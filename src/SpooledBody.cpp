@@ -0,0 +1,107 @@
+#include "SpooledBody.hpp"
+#include "Logger.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+namespace webserver {
+
+SpooledBody::SpooledBody(size_t memoryLimit, std::string directory)
+    : memoryLimit_(memoryLimit), directory_(std::move(directory)) {}
+
+SpooledBody::~SpooledBody() {
+    if (mapping_) {
+        munmap(mapping_, mappedSize_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool SpooledBody::append(std::string_view data) {
+    if (data.empty()) {
+        return true;
+    }
+    if (fd_ < 0 && memory_.size() + data.size() <= memoryLimit_) {
+        memory_.append(data.data(), data.size());
+        size_ += data.size();
+        return true;
+    }
+    if (fd_ < 0 && !spill()) {
+        return false;
+    }
+    if (!writeAll(data.data(), data.size())) {
+        return false;
+    }
+    size_ += data.size();
+    return true;
+}
+
+bool SpooledBody::spill() {
+    int fd = open(directory_.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        // 部分文件系统不支持O_TMPFILE，改用有名临时文件并立即删除
+        std::string path = directory_ + "/webserver-body-XXXXXX";
+        fd = mkostemp(path.data(), O_CLOEXEC);
+        if (fd >= 0) {
+            unlink(path.c_str());
+        }
+    }
+    if (fd < 0) {
+        LOG_ERROR("Failed to create temporary file for request body in " + directory_ + ": " + strerror(errno));
+        return false;
+    }
+    fd_ = fd;
+    if (!writeAll(memory_.data(), memory_.size())) {
+        return false;
+    }
+    // 释放内存中的副本，之后的数据直接写入文件
+    std::string().swap(memory_);
+    return true;
+}
+
+bool SpooledBody::writeAll(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("Failed to write request body to temporary file: " + std::string(strerror(errno)));
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+std::string_view SpooledBody::data() const {
+    if (fd_ < 0) {
+        return memory_;
+    }
+    if (size_ == 0) {
+        return {};
+    }
+    if (!mapping_ || mappedSize_ != size_) {
+        // 映射建立之后又追加了数据时重新映射
+        if (mapping_) {
+            munmap(mapping_, mappedSize_);
+            mapping_ = nullptr;
+        }
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            LOG_ERROR("Failed to map request body: " + std::string(strerror(errno)));
+            return {};
+        }
+        mapping_ = mapping;
+        mappedSize_ = size_;
+    }
+    return std::string_view(static_cast<const char*>(mapping_), mappedSize_);
+}
+
+} // namespace webserver
@@ -0,0 +1,314 @@
+#include "StaticFileHandler.hpp"
+#include "http/HttpResponse.hpp"
+#include "utils/DateTimeUtils.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <sstream>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace webserver {
+
+namespace {
+
+std::string stripTrailingSlashes(std::string value) {
+    while (!value.empty() && value.back() == '/') {
+        value.pop_back();
+    }
+    return value;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+std::string errorPage(HttpStatus status) {
+    std::string code = std::to_string(static_cast<int>(status));
+    std::string message = HttpStatusHandler::getInstance().getStatusMessage(status);
+    return "<html><body><h1>" + code + " " + message + "</h1></body></html>";
+}
+
+// If-None-Match中的任一实体标签与etag弱比较相等时返回true
+bool etagMatches(const std::string& ifNoneMatch, const std::string& etag) {
+    auto weakValue = [](std::string tag) {
+        size_t begin = tag.find_first_not_of(" \t");
+        size_t end = tag.find_last_not_of(" \t");
+        tag = begin == std::string::npos ? "" : tag.substr(begin, end - begin + 1);
+        return tag.compare(0, 2, "W/") == 0 ? tag.substr(2) : tag;
+    };
+    std::istringstream stream(ifNoneMatch);
+    std::string tag;
+    while (std::getline(stream, tag, ',')) {
+        tag = weakValue(tag);
+        if (tag == "*" || tag == weakValue(etag)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 条件请求命中时返回true；If-None-Match存在时忽略If-Modified-Since
+bool notModified(const HttpHeaders& requestHeaders, const std::string& etag, time_t mtime) {
+    if (const std::string* ifNoneMatch = requestHeaders.find(HttpHeader::IF_NONE_MATCH)) {
+        return etagMatches(*ifNoneMatch, etag);
+    }
+    if (const std::string* ifModifiedSince = requestHeaders.find(HttpHeader::IF_MODIFIED_SINCE)) {
+        time_t since = DateTimeUtils::parseHttpDate(*ifModifiedSince);
+        return since != 0 && mtime <= since;
+    }
+    return false;
+}
+
+StaticFileHandler::Result notModifiedResult(const std::string& contentType, const std::string& lastModified,
+                                            const std::string& etag) {
+    StaticFileHandler::Result result;
+    result.status = HttpStatus::NOT_MODIFIED;
+    result.headers["Content-Type"] = contentType;
+    result.headers["Content-Length"] = "0";
+    result.headers["Last-Modified"] = lastModified;
+    result.headers["ETag"] = etag;
+    return result;
+}
+
+StaticFileHandler::Result errorResult(HttpStatus status) {
+    StaticFileHandler::Result result;
+    result.status = status;
+    result.body = errorPage(status);
+    result.headers["Content-Type"] = "text/html";
+    result.headers["Content-Length"] = std::to_string(result.body.size());
+    return result;
+}
+
+} // namespace
+
+StaticFileHandler::StaticFileHandler(const std::string& urlPrefix, const std::string& rootDirectory,
+                                     const StaticFileOptions& options)
+    : urlPrefix_(stripTrailingSlashes(urlPrefix)),
+      rootDirectory_(stripTrailingSlashes(rootDirectory)),
+      keepAliveTimeout_(options.keepAliveTimeout),
+      cache_(options.openFileCacheEntries, options.revalidateInterval, options.readaheadThreshold),
+      contentCache_(options.memoryCacheBytes, options.memoryCacheMaxFileSize) {}
+
+bool StaticFileHandler::matches(const std::string& path) const {
+    if (path.compare(0, urlPrefix_.size(), urlPrefix_) != 0) {
+        return false;
+    }
+    // "/static" 不匹配 "/staticfoo"
+    return path.size() == urlPrefix_.size() || path[urlPrefix_.size()] == '/' || urlPrefix_.empty();
+}
+
+bool StaticFileHandler::resolvePath(const std::string& path, std::string& filePath) const {
+    std::string relative = path.substr(urlPrefix_.size());
+    size_t query = relative.find_first_of("?#");
+    if (query != std::string::npos) {
+        relative.erase(query);
+    }
+
+    // 解码百分号编码
+    std::string decoded;
+    decoded.reserve(relative.size());
+    for (size_t i = 0; i < relative.size(); ++i) {
+        if (relative[i] != '%') {
+            decoded += relative[i];
+            continue;
+        }
+        if (i + 2 >= relative.size()) {
+            return false;
+        }
+        int high = hexValue(relative[i + 1]);
+        int low = hexValue(relative[i + 2]);
+        if (high < 0 || low < 0 || (high == 0 && low == 0)) {
+            return false;
+        }
+        decoded += static_cast<char>(high * 16 + low);
+        i += 2;
+    }
+
+    // 逐段检查，拒绝访问根目录之外的文件
+    std::string normalized;
+    size_t start = 0;
+    while (start <= decoded.size()) {
+        size_t end = decoded.find('/', start);
+        if (end == std::string::npos) {
+            end = decoded.size();
+        }
+        std::string segment = decoded.substr(start, end - start);
+        if (segment == "..") {
+            return false;
+        }
+        if (!segment.empty() && segment != ".") {
+            normalized += "/" + segment;
+        }
+        start = end + 1;
+    }
+
+    // 以'/'结尾或指向前缀本身时返回目录下的index.html
+    if (decoded.empty() || decoded.back() == '/') {
+        normalized += "/index.html";
+    }
+    filePath = rootDirectory_ + normalized;
+    return true;
+}
+
+StaticFileHandler::Result StaticFileHandler::handle(const std::string& method, const std::string& path,
+                                                    const HttpHeaders& requestHeaders) {
+    if (method != "GET" && method != "HEAD") {
+        Result result = errorResult(HttpStatus::METHOD_NOT_ALLOWED);
+        result.headers["Allow"] = "GET, HEAD";
+        return result;
+    }
+
+    std::string filePath;
+    if (!resolvePath(path, filePath)) {
+        return errorResult(HttpStatus::BAD_REQUEST);
+    }
+
+    // 内存缓存只服务GET，命中时不访问文件也不格式化响应
+    bool isGet = method == "GET";
+    std::shared_ptr<const CachedResponse> cached = isGet ? contentCache_.find(filePath) : nullptr;
+
+    int error = 0;
+    std::shared_ptr<const OpenFile> file;
+    if (!cached) {
+        file = cache_.acquire(filePath, error);
+        if (!file && error == EISDIR) {
+            filePath += "/index.html";
+            cached = isGet ? contentCache_.find(filePath) : nullptr;
+            if (!cached) {
+                file = cache_.acquire(filePath, error);
+            }
+        }
+    }
+
+    if (cached) {
+        if (notModified(requestHeaders, cached->etag, cached->mtime)) {
+            return notModifiedResult(cached->contentType, cached->lastModified, cached->etag);
+        }
+        Result result;
+        result.cached = std::move(cached);
+        return result;
+    }
+    if (!file) {
+        return errorResult(error == EACCES || error == EPERM ? HttpStatus::FORBIDDEN : HttpStatus::NOT_FOUND);
+    }
+
+    std::string contentType = contentTypeFor(filePath);
+    if (notModified(requestHeaders, file->etag, file->mtime)) {
+        return notModifiedResult(contentType, file->lastModified, file->etag);
+    }
+
+    Result result;
+    if (isGet) {
+        result.cached = loadIntoMemory(*file, contentType);
+        if (result.cached) {
+            return result;
+        }
+    }
+    result.headers["Content-Type"] = contentType;
+    result.headers["Content-Length"] = std::to_string(file->size);
+    result.headers["Last-Modified"] = file->lastModified;
+    result.headers["ETag"] = file->etag;
+    if (isGet) {
+        result.file = std::move(file);
+    }
+    return result;
+}
+
+std::shared_ptr<const CachedResponse> StaticFileHandler::loadIntoMemory(const OpenFile& file,
+                                                                        const std::string& contentType) {
+    if (!contentCache_.enabled() || static_cast<size_t>(file.size) > contentCache_.maxFileSize()) {
+        return nullptr;
+    }
+
+    // 先监视再校验：打开文件缓存中的描述符可能已经落后于磁盘上的文件，
+    // 校验之后的任何修改都会产生通知
+    uint64_t generation = 0;
+    if (!contentCache_.watch(file.path, generation) || !file.isCurrent()) {
+        return nullptr;
+    }
+
+    auto response = std::make_shared<CachedResponse>();
+    response->body.resize(static_cast<size_t>(file.size));
+    size_t total = 0;
+    while (total < response->body.size()) {
+        ssize_t bytesRead = pread(file.fd, &response->body[total], response->body.size() - total,
+                                  static_cast<off_t>(total));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return nullptr;
+        }
+        total += static_cast<size_t>(bytesRead);
+    }
+
+    response->path = file.path;
+    response->contentType = contentType;
+    response->lastModified = file.lastModified;
+    response->etag = file.etag;
+    response->mtime = file.mtime;
+    for (int keepAlive = 0; keepAlive < 2; ++keepAlive) {
+        HttpResponse headers(HttpStatus::OK, "", contentType);
+        headers.setHeader("Content-Length", std::to_string(file.size));
+        headers.setHeader("Last-Modified", file.lastModified);
+        headers.setHeader("ETag", file.etag);
+        headers.setHeader("Connection", keepAlive ? "keep-alive" : "close");
+        if (keepAlive) {
+            headers.setHeader("Keep-Alive", "timeout=" + std::to_string(keepAliveTimeout_));
+        }
+        response->headers[keepAlive] = headers.build();
+    }
+    contentCache_.insert(response, generation);
+    return response;
+}
+
+void StaticFileHandler::processFileEvents() {
+    // 打开文件缓存也立即失效，重新读入内存时不会拿到尚未重新校验的旧描述符
+    contentCache_.processEvents([this](const std::string& path) { cache_.invalidate(path); });
+}
+
+std::string StaticFileHandler::contentTypeFor(const std::string& path) {
+    static const std::unordered_map<std::string, std::string> kContentTypes = {
+        {"html", "text/html"},
+        {"htm", "text/html"},
+        {"css", "text/css"},
+        {"js", "application/javascript"},
+        {"mjs", "application/javascript"},
+        {"json", "application/json"},
+        {"txt", "text/plain"},
+        {"xml", "application/xml"},
+        {"svg", "image/svg+xml"},
+        {"png", "image/png"},
+        {"jpg", "image/jpeg"},
+        {"jpeg", "image/jpeg"},
+        {"gif", "image/gif"},
+        {"webp", "image/webp"},
+        {"ico", "image/x-icon"},
+        {"woff", "font/woff"},
+        {"woff2", "font/woff2"},
+        {"wasm", "application/wasm"},
+        {"pdf", "application/pdf"},
+        {"mp4", "video/mp4"},
+    };
+
+    size_t dot = path.rfind('.');
+    size_t slash = path.rfind('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return "application/octet-stream";
+    }
+    std::string extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto it = kContentTypes.find(extension);
+    return it != kContentTypes.end() ? it->second : "application/octet-stream";
+}
+
+} // namespace webserver
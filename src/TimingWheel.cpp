@@ -0,0 +1,132 @@
+#include "TimingWheel.hpp"
+
+namespace webserver {
+
+namespace {
+
+// 把节点挂到哨兵所在链表的尾部
+void linkBefore(TimerNode& sentinel, TimerNode& node) {
+    node.prev = sentinel.prev;
+    node.next = &sentinel;
+    sentinel.prev->next = &node;
+    sentinel.prev = &node;
+}
+
+// 把整个链表移交给另一个哨兵，原链表变为空
+void spliceAll(TimerNode& from, TimerNode& to) {
+    if (from.next == &from) {
+        return;
+    }
+    to.next = from.next;
+    to.prev = from.prev;
+    to.next->prev = &to;
+    to.prev->next = &to;
+    from.next = &from;
+    from.prev = &from;
+}
+
+void initSentinel(TimerNode& sentinel) {
+    sentinel.next = &sentinel;
+    sentinel.prev = &sentinel;
+}
+
+} // namespace
+
+TimingWheel::TimingWheel(uint64_t currentTick)
+    : currentTick_(currentTick), size_(0) {
+    for (auto& level : slots_) {
+        for (auto& sentinel : level) {
+            initSentinel(sentinel);
+        }
+    }
+}
+
+TimingWheel::~TimingWheel() {
+    for (auto& level : slots_) {
+        for (auto& sentinel : level) {
+            while (sentinel.next != &sentinel) {
+                sentinel.next->unlink();
+            }
+            sentinel.prev = nullptr;
+        }
+    }
+}
+
+void TimingWheel::schedule(TimerNode& node, uint64_t expiryTick) {
+    if (node.armed()) {
+        node.unlink();
+        --size_;
+    }
+    // 已到期的定时器放到下一个tick触发
+    if (expiryTick <= currentTick_) {
+        expiryTick = currentTick_ + 1;
+    } else if (expiryTick - currentTick_ > kMaxDelay) {
+        expiryTick = currentTick_ + kMaxDelay;
+    }
+    node.expiry = expiryTick;
+    insert(node);
+    ++size_;
+}
+
+void TimingWheel::cancel(TimerNode& node) {
+    if (node.armed()) {
+        node.unlink();
+        --size_;
+    }
+}
+
+void TimingWheel::insert(TimerNode& node) {
+    // 选择能容纳剩余时间的最低层：第l层覆盖 [kSlots^l, kSlots^(l+1)) 个tick
+    uint64_t delay = node.expiry - currentTick_;
+    unsigned level = 0;
+    while (level + 1 < kLevels && delay >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    auto slot = static_cast<size_t>((node.expiry >> (kSlotBits * level)) & (kSlots - 1));
+    linkBefore(slots_[level][slot], node);
+}
+
+void TimingWheel::cascade(unsigned level) {
+    auto slot = static_cast<size_t>((currentTick_ >> (kSlotBits * level)) & (kSlots - 1));
+    TimerNode pending;
+    initSentinel(pending);
+    spliceAll(slots_[level][slot], pending);
+    while (pending.next != &pending) {
+        TimerNode& node = *pending.next;
+        node.unlink();
+        insert(node);
+    }
+    // 摘空后再让哨兵析构，避免其析构函数修改已不存在的链表
+    pending.prev = nullptr;
+}
+
+size_t TimingWheel::advance(uint64_t nowTick, const ExpiryCallback& callback) {
+    size_t fired = 0;
+    while (currentTick_ < nowTick) {
+        ++currentTick_;
+
+        // 低层转完一圈时，把上一层对应槽中的定时器下放
+        for (unsigned level = 1; level < kLevels; ++level) {
+            if ((currentTick_ & ((uint64_t(1) << (kSlotBits * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        auto slot = static_cast<size_t>(currentTick_ & (kSlots - 1));
+        TimerNode expired;
+        initSentinel(expired);
+        spliceAll(slots_[0][slot], expired);
+        while (expired.next != &expired) {
+            TimerNode& node = *expired.next;
+            node.unlink();
+            --size_;
+            ++fired;
+            callback(node);
+        }
+        expired.prev = nullptr;
+    }
+    return fired;
+}
+
+} // namespace webserver
@@ -12,11 +12,28 @@
 #include <chrono>
 #include <csignal>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <linux/errqueue.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sched.h>
+#include <linux/filter.h>
+#include <cerrno>
+#include <algorithm>
+#include <climits>
 #include <cstring>
+#include <fstream>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <openssl/err.h>
 
@@ -52,6 +69,11 @@ bool WebServer::initSSLContext() {
         return false;
     }
 
+    // 非阻塞套接字上SSL_write可能只写出一部分，重试时缓冲区地址也可能变化；
+    // 读写记录缓冲区（约34KB）在没有待处理数据时释放，空闲的保活连接不再占用它们
+    SSL_CTX_set_mode(sslContext_, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                                  SSL_MODE_RELEASE_BUFFERS);
+
     return true;
 }
 
@@ -63,17 +85,264 @@ void WebServer::cleanupSSL() {
     EVP_cleanup();
 }
 
+namespace {
+// 单次recv使用的栈缓冲区大小
+constexpr size_t kReadChunkSize = 16384;
+// 读取过程中输入缓冲区超过该大小时先推进解析，把已交出的请求体从缓冲区删除
+constexpr size_t kBodyPumpThreshold = 4 * kReadChunkSize;
+// TLS连接和io_uring后端无法使用sendfile时，每次从文件读入的大小
+constexpr size_t kFileChunkSize = 65536;
+// 单次sendfile的最大长度，避免一个大文件长时间占用事件循环
+constexpr size_t kMaxSendfileChunk = 1024 * 1024;
+// 客户端套接字关注的事件：读写都采用边缘触发，只需注册一次
+constexpr uint32_t kConnectionEvents = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+// io_uring后端：多发recv使用的提供缓冲区组
+constexpr uint16_t kRingBufferGroup = 0;
+// io_uring后端：固定文件表大小上限
+constexpr unsigned kMaxRingFiles = 65536;
+// io_uring后端：退出时等待未完成请求的最大轮数
+constexpr int kMaxRingDrainRounds = 64;
+// 每个Reactor最多保留的空闲输入缓冲区数量
+constexpr size_t kMaxSpareBuffers = 64;
+// 容量超过该值的输入缓冲区（大请求体留下的）直接释放，不放回空闲列表
+constexpr size_t kMaxSpareBufferCapacity = kBodyPumpThreshold + kReadChunkSize;
+// io_uring后端：每个Reactor最多保留的空闲sendmsg参数
+constexpr size_t kMaxSpareRingSends = 64;
+
+const char* timerPhaseName(TimerPhase phase) {
+    switch (phase) {
+        case TimerPhase::HANDSHAKE: return "TLS handshake";
+        case TimerPhase::IDLE: return "idle";
+        case TimerPhase::KEEP_ALIVE: return "keep-alive";
+        case TimerPhase::HEADERS: return "request headers";
+        case TimerPhase::BODY: return "request body";
+        case TimerPhase::PROCESSING: return "processing";
+        case TimerPhase::DRAIN: return "response drain";
+        default: return "unknown";
+    }
+}
+
+// 字符串在堆上分配的字节数，短字符串优化时为0
+size_t heapBytes(const std::string& value) {
+    return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+}
+
+// io_uring请求类型，编码在user_data的最高8位
+enum class RingOp : uint8_t {
+    ACCEPT = 1,
+    RECV,
+    SEND,
+    CLOSE_SLOT,   // 关闭固定文件表中的项，完成后下标才能复用
+    CLOSE_FD,     // 关闭普通描述符，完成项无需处理
+    CANCEL        // 取消请求，完成项无需处理
+};
+
+// user_data布局：操作类型(8位) | 固定文件下标(24位) | 下标代数(32位)
+uint64_t encodeUserData(RingOp op, uint32_t slot, uint32_t generation) {
+    return (static_cast<uint64_t>(op) << 56) |
+           (static_cast<uint64_t>(slot & 0xFFFFFFu) << 32) |
+           generation;
+}
+
+// 从 /proc/net/netstat 读取监听队列溢出和丢弃计数，读取失败时保持为0
+void readListenCounters(uint64_t& overflows, uint64_t& drops) {
+    overflows = 0;
+    drops = 0;
+    std::ifstream netstat("/proc/net/netstat");
+    std::string names;
+    std::string values;
+    // 文件由成对的行组成：第一行是字段名，第二行是对应的值
+    while (std::getline(netstat, names) && std::getline(netstat, values)) {
+        if (names.compare(0, 7, "TcpExt:") != 0) {
+            continue;
+        }
+        std::istringstream nameStream(names);
+        std::istringstream valueStream(values);
+        std::string name;
+        std::string value;
+        while (nameStream >> name && valueStream >> value) {
+            if (name == "ListenOverflows") {
+                overflows = std::strtoull(value.c_str(), nullptr, 10);
+            } else if (name == "ListenDrops") {
+                drops = std::strtoull(value.c_str(), nullptr, 10);
+            }
+        }
+        return;
+    }
+}
+
+// 路由和处理函数使用拥有所有权的头部，复制之后请求即可从输入缓冲区移除；
+// std::map按名称区分大小写，常用头部统一改为规范名称，处理函数按规范写法即可查到
+std::map<std::string, std::string> toHeaderMap(const RequestView& request) {
+    std::map<std::string, std::string> headers;
+    for (const HeaderView& header : request.headers) {
+        std::string_view name = header.id != HttpHeader::UNKNOWN ? httpHeaderName(header.id) : header.name;
+        headers.emplace(name, header.value);
+    }
+    return headers;
+}
+
+// 事件循环内部按HttpHeader枚举查找，不受客户端大小写的影响
+HttpHeaders toHttpHeaders(const RequestView& request) {
+    HttpHeaders headers;
+    headers.reserve(request.headers.size());
+    for (const HeaderView& header : request.headers) {
+        headers.add(std::string(header.name), std::string(header.value));
+    }
+    return headers;
+}
+
+// io_uring后端：从Reactor借用sendmsg参数，没有空闲的才分配
+std::unique_ptr<RingSend> acquireRingSend(Reactor& reactor) {
+    if (reactor.spareRingSends.empty()) {
+        return std::make_unique<RingSend>();
+    }
+    std::unique_ptr<RingSend> send = std::move(reactor.spareRingSends.back());
+    reactor.spareRingSends.pop_back();
+    return send;
+}
+
+// 归还不再被内核引用的sendmsg参数
+void releaseRingSend(Reactor& reactor, std::unique_ptr<RingSend> send) {
+    if (send && reactor.spareRingSends.size() < kMaxSpareRingSends) {
+        reactor.spareRingSends.push_back(std::move(send));
+    }
+}
+
+// 把已关闭的连接交给Reactor，在本轮事件处理结束后释放（调用栈上层可能仍持有其引用）
+void retireConnection(Reactor& reactor, std::unique_ptr<Connection> conn) {
+    if (reactor.closedConnections.empty()) {
+        Reactor* reactorPtr = &reactor;
+        reactor.loop->queueInLoop([reactorPtr]() { reactorPtr->closedConnections.clear(); });
+    }
+    reactor.closedConnections.push_back(std::move(conn));
+}
+
+// 把预先生成的响应头中Keep-Alive的超时替换为指定的秒数
+std::string withKeepAliveTimeout(const std::string& headers, int seconds) {
+    static const std::string kPrefix = "Keep-Alive: timeout=";
+    size_t start = headers.find(kPrefix);
+    if (start == std::string::npos) {
+        return headers;
+    }
+    start += kPrefix.size();
+    size_t end = headers.find_first_not_of("0123456789", start);
+    return headers.substr(0, start) + std::to_string(seconds) + headers.substr(end);
+}
+}
+
 WebServer::WebServer(const Config& config) 
     : port_(config.get<int>("port", 8080)), 
       running_(false), 
       config_(config),
-      sslContext_(nullptr) {
+      sslContext_(nullptr),
+      exclusiveListener_(config.get<std::string>("server.listener_mode", "reuseport") == "exclusive"),
+      cpuSteering_(config.get<bool>("server.reuseport_cpu_steering", false)),
+      useIoUring_(false),
+      nextConnectionId_(1),
+      timerTick_(std::max(1, config.get<int>("server.timer_tick_ms", 100))),
+      listenBacklog_(config.get<int>("server.listen_backlog", 4096)),
+      deferAcceptSeconds_(std::max(0, config.get<int>("server.tcp_defer_accept", 0))),
+      fastOpenQueue_(std::max(0, config.get<int>("server.tcp_fastopen", 0))),
+      tcpNoDelay_(config.get<bool>("server.tcp_nodelay", true)),
+      tcpCork_(config.get<bool>("server.tcp_cork", true)),
+      socketSendBuffer_(std::max(0, config.get<int>("server.socket_send_buffer", 0))),
+      socketReceiveBuffer_(std::max(0, config.get<int>("server.socket_receive_buffer", 0))),
+      zeroCopyThreshold_(static_cast<size_t>(std::max(0, config.get<int>("server.zerocopy_threshold", 0)))),
+      acceptBatch_(static_cast<size_t>(std::max(1, config.get<int>("server.accept_batch", 64)))),
+      fairnessMaxRequests_(static_cast<size_t>(std::max(0, config.get<int>("server.fairness_max_requests", 32)))),
+      fairnessMaxBytes_(static_cast<size_t>(std::max(0, config.get<int>("server.fairness_max_bytes", 256 * 1024)))),
+      outputHighWatermark_(static_cast<size_t>(std::max(1, config.get<int>("server.output_high_watermark", 256 * 1024)))),
+      outputLowWatermark_(std::min(outputHighWatermark_,
+          static_cast<size_t>(std::max(0, config.get<int>("server.output_low_watermark", 64 * 1024))))),
+      listenOverflowBase_(0),
+      listenDropBase_(0) {
     connectionManager_ = std::make_unique<ConnectionManager>(config_);
+    listeners_ = ListenerSpec::fromConfig(config_, port_);
     router_ = std::make_unique<Router>();
+
+    requestLimits_.maxHeaderBytes = static_cast<size_t>(std::max(1, config_.get<int>("server.max_header_size", 64 * 1024)));
+    requestLimits_.maxRequestLineBytes = static_cast<size_t>(std::max(1, config_.get<int>("server.max_request_line_size", 8 * 1024)));
+    requestLimits_.maxHeaders = static_cast<size_t>(std::max(1, config_.get<int>("server.max_header_count", 100)));
+    requestLimits_.maxBodySize = static_cast<size_t>(std::max(0, config_.get<int>("server.max_body_size", 8 * 1024 * 1024)));
+    requestLimits_.pauseAfterHeaders = true;
+    bodyMemoryLimit_ = static_cast<size_t>(std::max(0, config_.get<int>("server.body_memory_limit", 1024 * 1024)));
+    maxUploadSize_ = static_cast<size_t>(std::max(0, config_.get<int>("server.max_upload_size", 1024 * 1024 * 1024)));
+    uploadTempDir_ = config_.get<std::string>("server.upload_temp_dir", "/tmp");
+
+    // 各阶段的超时以秒配置，换算成时间轮的tick数
+    idleTimeoutTicks_ = secondsToTicks(config_.get<int>("server.timeout", 60));
+    // 保活超时和每个连接的最大请求数由ConnectionManager按连接占用率给出
+    keepAliveTimeoutSeconds_ = config_.get<int>("server.keep_alive_timeout", 5);
+    handshakeTimeoutTicks_ = secondsToTicks(config_.get<int>("server.handshake_timeout", 10));
+    headerTimeoutTicks_ = secondsToTicks(config_.get<int>("server.header_timeout", 10));
+    // body_timeout取代了覆盖整个请求的request_timeout，旧配置仍然有效
+    bodyTimeoutTicks_ = secondsToTicks(config_.get<int>("server.body_timeout", config_.get<int>("server.request_timeout", 30)));
+    drainTimeoutTicks_ = secondsToTicks(config_.get<int>("server.drain_timeout", 30));
+    minBodyRate_ = static_cast<uint64_t>(std::max(0, config_.get<int>("server.min_body_rate", 500)));
+    minSendRate_ = static_cast<uint64_t>(std::max(0, config_.get<int>("server.min_send_rate", 500)));
+
+    // Reactor数量默认等于CPU核数
+    int reactorCount = config_.get<int>("server.reactor_count", 0);
+    if (reactorCount <= 0) {
+        reactorCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (size_t i = 0; i < static_cast<size_t>(reactorCount); ++i) {
+        auto reactor = std::make_unique<Reactor>();
+        reactor->index = i;
+        reactor->loop = std::make_unique<EventLoop>();
+
+        // 每个Reactor一个周期性timerfd驱动自己的时间轮，超时处理不跨线程
+        reactor->timerEpoch = std::chrono::steady_clock::now();
+        reactor->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (reactor->timerFd == -1) {
+            throw std::runtime_error("Failed to create timerfd: " + std::string(strerror(errno)));
+        }
+        struct itimerspec interval{};
+        auto tickNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(timerTick_).count();
+        interval.it_interval.tv_sec = static_cast<time_t>(tickNanos / 1000000000);
+        interval.it_interval.tv_nsec = static_cast<long>(tickNanos % 1000000000);
+        interval.it_value = interval.it_interval;
+        timerfd_settime(reactor->timerFd, 0, &interval, nullptr);
+        Reactor* reactorPtr = reactor.get();
+        reactor->loop->addFd(reactor->timerFd, EPOLLIN,
+            [this, reactorPtr](uint32_t) { handleTimerTick(*reactorPtr); });
+
+        reactors_.push_back(std::move(reactor));
+    }
+
+    // 静态文件的变化通知注册到0号Reactor，因此在Reactor创建之后添加
+    std::string staticRoot = config_.get<std::string>("server.static_root", "");
+    if (!staticRoot.empty()) {
+        addStaticRoute(config_.get<std::string>("server.static_url_prefix", "/static"), staticRoot);
+    }
+
+    // I/O后端在启动前确定，运行期间不再变化
+    if (config_.get<std::string>("server.io_backend", "epoll") == "io_uring") {
+        if (config_.get<bool>("https_enabled", false)) {
+            LOG_WARNING("io_uring backend does not support HTTPS, falling back to epoll");
+        } else {
+            useIoUring_ = setupIoUring();
+            if (!useIoUring_) {
+                LOG_WARNING("io_uring backend unavailable, falling back to epoll");
+            }
+        }
+    }
 }
 
 WebServer::~WebServer() {
     stop();
+    for (auto& reactor : reactors_) {
+        if (reactor->ringEventFd != -1) {
+            close(reactor->ringEventFd);
+            reactor->ringEventFd = -1;
+        }
+        if (reactor->timerFd != -1) {
+            close(reactor->timerFd);
+            reactor->timerFd = -1;
+        }
+    }
+    cleanupSSL();
 }
 
 bool WebServer::start() {
@@ -86,218 +355,1722 @@ bool WebServer::start() {
         LOG_INFO("HTTPS enabled with SSL/TLS");
     }
 
-    int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (serverSocket == -1) {
-        LOG_ERROR("Failed to create socket");
+    if (!openListeners()) {
         return false;
     }
 
+    for (auto& reactor : reactors_) {
+        Reactor* reactorPtr = reactor.get();
+        for (size_t listener = 0; listener < reactor->listenFds.size(); ++listener) {
+            if (reactor->ring) {
+                // io_uring后端由多发accept接受连接，监听套接字不注册到epoll
+                armAccept(*reactor, listener);
+                continue;
+            }
+            // 共享的套接字以EPOLLEXCLUSIVE水平触发监听，避免惊群
+            uint32_t listenEvents = isSharedListener(listener) ? (EPOLLIN | EPOLLEXCLUSIVE) : (EPOLLIN | EPOLLET);
+            if (!reactor->loop->addFd(reactor->listenFds[listener], listenEvents,
+                    [this, reactorPtr, listener](uint32_t) { handleAccept(*reactorPtr, listener); })) {
+                closeListeners();
+                return false;
+            }
+        }
+    }
+
+    // 工作线程池只执行offload路由，事件循环本身不会阻塞在处理函数上
+    int workerThreads = config_.get<int>("server.thread_pool_size", 4);
+    if (workerThreads > 0) {
+        workerPool_ = std::make_unique<ThreadPool>(static_cast<size_t>(workerThreads));
+    }
+
+    // 溢出计数是整个网络命名空间的累计值，以启动时的值为基准
+    readListenCounters(listenOverflowBase_, listenDropBase_);
+
+    std::string addresses;
+    for (const auto& spec : listeners_) {
+        addresses += (addresses.empty() ? "" : ", ") + spec.toString();
+    }
+    LOG_INFO("Server started on " + addresses + " with " +
+             std::to_string(reactors_.size()) + " reactor(s)" +
+             (exclusiveListener_ ? " sharing one EPOLLEXCLUSIVE listener" : " using SO_REUSEPORT listeners") +
+             (useIoUring_ ? " on the io_uring backend" : " on the epoll backend"));
+    running_ = true;
+
+    for (size_t i = 1; i < reactors_.size(); ++i) {
+        Reactor* reactorPtr = reactors_[i].get();
+        reactorPtr->thread = std::thread([this, reactorPtr]() { runReactor(*reactorPtr); });
+    }
+    runReactor(*reactors_[0]);
+
+    for (auto& reactor : reactors_) {
+        if (reactor->thread.joinable()) {
+            reactor->thread.join();
+        }
+    }
+    closeListeners();
+    connectionManager_->stopAll();
+    return true;
+}
+
+void WebServer::stop() {
+    running_ = false;
+    for (auto& reactor : reactors_) {
+        reactor->loop->quit();
+    }
+}
+
+void WebServer::addRoute(const std::string& path, Router::RequestHandler handler, bool offload) {
+    router_->addRoute(path, handler, offload);
+}
+
+void WebServer::addUploadRoute(const std::string& path, Router::UploadHandler handler, bool offload) {
+    router_->addUploadRoute(path, std::move(handler), offload);
+}
+
+void WebServer::addStreamRoute(const std::string& path, Router::StreamHandler handler) {
+    router_->addStreamRoute(path, std::move(handler));
+}
+
+void WebServer::addStaticRoute(const std::string& urlPrefix, const std::string& rootDirectory) {
+    StaticFileOptions options;
+    options.openFileCacheEntries = static_cast<size_t>(std::max(0, config_.get<int>("server.static_cache_entries", 1024)));
+    options.revalidateInterval = std::chrono::milliseconds(std::max(0, config_.get<int>("server.static_revalidate_ms", 1000)));
+    options.readaheadThreshold = static_cast<off_t>(std::max(0, config_.get<int>("server.static_readahead_threshold", 1024 * 1024)));
+    options.memoryCacheBytes = static_cast<size_t>(std::max(0, config_.get<int>("server.static_memory_cache_bytes", 32 * 1024 * 1024)));
+    options.memoryCacheMaxFileSize = static_cast<size_t>(std::max(0, config_.get<int>("server.static_memory_cache_max_file_size", 64 * 1024)));
+    options.keepAliveTimeout = config_.get<int>("server.keep_alive_timeout", 5);
+    staticHandlers_.push_back(std::make_unique<StaticFileHandler>(urlPrefix, rootDirectory, options));
+
+    StaticFileHandler* handler = staticHandlers_.back().get();
+    if (handler->fileEventFd() != -1) {
+        reactors_[0]->loop->addFd(handler->fileEventFd(), EPOLLIN,
+            [handler](uint32_t) { handler->processFileEvents(); });
+    }
+}
+
+ContentCache::Stats WebServer::getStaticCacheStats() const {
+    ContentCache::Stats stats;
+    for (const auto& handler : staticHandlers_) {
+        ContentCache::Stats handlerStats = handler->getContentCacheStats();
+        stats.hits += handlerStats.hits;
+        stats.misses += handlerStats.misses;
+        stats.evictions += handlerStats.evictions;
+        stats.invalidations += handlerStats.invalidations;
+    }
+    return stats;
+}
+
+WebServer::ListenStats WebServer::getListenStats() const {
+    ListenStats stats;
+    for (const auto& reactor : reactors_) {
+        stats.accepted += reactor->accepted.load(std::memory_order_relaxed);
+    }
+    // 监听套接字的tcpi_unacked为当前全连接队列长度，tcpi_sacked为队列上限（Unix域套接字不支持TCP_INFO）
+    for (int listenFd : listenSockets_) {
+        struct tcp_info info{};
+        socklen_t length = sizeof(info);
+        if (getsockopt(listenFd, IPPROTO_TCP, TCP_INFO, &info, &length) == 0) {
+            stats.acceptQueueLength += info.tcpi_unacked;
+            stats.acceptQueueLimit += info.tcpi_sacked;
+        }
+    }
+
+    uint64_t overflows = 0;
+    uint64_t drops = 0;
+    readListenCounters(overflows, drops);
+    stats.listenOverflows = overflows > listenOverflowBase_ ? overflows - listenOverflowBase_ : 0;
+    stats.listenDrops = drops > listenDropBase_ ? drops - listenDropBase_ : 0;
+    return stats;
+}
+
+WebServer::IoStats WebServer::getIoStats() const {
+    IoStats stats;
+    for (const auto& reactor : reactors_) {
+        stats.requests += reactor->requests.load(std::memory_order_relaxed);
+        stats.readPauses += reactor->readPauses.load(std::memory_order_relaxed);
+        stats.zeroCopySends += reactor->zeroCopySends.load(std::memory_order_relaxed);
+        stats.zeroCopyCompletions += reactor->zeroCopyCompletions.load(std::memory_order_relaxed);
+        stats.zeroCopyCopied += reactor->zeroCopyCopied.load(std::memory_order_relaxed);
+        stats.fairnessYields += reactor->fairnessYields.load(std::memory_order_relaxed);
+        stats.syscalls += reactor->syscalls.load(std::memory_order_relaxed) + reactor->loop->pollCount();
+        if (reactor->ring) {
+            stats.syscalls += reactor->ring->syscallCount();
+        }
+    }
+    return stats;
+}
+
+ConnectionManager::KeepAliveLimits WebServer::getKeepAliveLimits() const {
+    return connectionManager_->keepAliveLimits();
+}
+
+WebServer::IdleStats WebServer::getIdleStats() const {
+    IdleStats stats;
+    for (const auto& reactor : reactors_) {
+        stats.connections += reactor->parkedConnections.load(std::memory_order_relaxed);
+        stats.bytes += reactor->parkedBytes.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+int WebServer::createListenSocket(const ListenerSpec& spec, bool reusePort) {
+    int family = spec.family();
+    int serverSocket = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (serverSocket == -1) {
+        LOG_ERROR("Failed to create socket for " + spec.toString() + ": " + std::string(strerror(errno)));
+        return -1;
+    }
+
     // 设置socket选项
     int opt = 1;
-    if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1) {
+    if (family != AF_UNIX &&
+        (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1 ||
+         (reusePort && setsockopt(serverSocket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1))) {
         LOG_ERROR("Failed to set socket options");
         close(serverSocket);
-        return false;
+        return -1;
+    }
+    // 显式设置IPV6_V6ONLY，不依赖net.ipv6.bindv6only的系统默认值
+    int v6Only = spec.ipv6Only ? 1 : 0;
+    if (family == AF_INET6 &&
+        setsockopt(serverSocket, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only)) == -1) {
+        LOG_ERROR("Failed to set IPV6_V6ONLY: " + std::string(strerror(errno)));
+        close(serverSocket);
+        return -1;
     }
 
     // 绑定地址和端口
-    struct sockaddr_in serverAddr;
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_addr.s_addr = INADDR_ANY;
-    serverAddr.sin_port = htons(static_cast<uint16_t>(port_));
-    if (bind(serverSocket, reinterpret_cast<struct sockaddr*>(&serverAddr), sizeof(serverAddr)) == -1) {
-        LOG_ERROR("Failed to bind socket");
+    struct sockaddr_storage serverAddr;
+    socklen_t serverAddrLen = 0;
+    spec.toSockaddr(serverAddr, serverAddrLen);
+    if (family == AF_UNIX && !spec.abstractNamespace) {
+        // 删除上次运行遗留的套接字文件，同名的普通文件保留并让bind报错
+        struct stat st;
+        if (lstat(spec.path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+            unlink(spec.path.c_str());
+        }
+    }
+    if (bind(serverSocket, reinterpret_cast<struct sockaddr*>(&serverAddr), serverAddrLen) == -1) {
+        LOG_ERROR("Failed to bind " + spec.toString() + ": " + std::string(strerror(errno)));
         close(serverSocket);
-        return false;
+        return -1;
+    }
+
+    // 以下两个选项只影响性能，设置失败时继续运行
+    // TCP_DEFER_ACCEPT：连接收到首个数据包后才进入accept队列，减少空连接的唤醒
+    if (family != AF_UNIX && deferAcceptSeconds_ > 0 &&
+        setsockopt(serverSocket, IPPROTO_TCP, TCP_DEFER_ACCEPT, &deferAcceptSeconds_, sizeof(deferAcceptSeconds_)) == -1) {
+        LOG_WARNING("Failed to set TCP_DEFER_ACCEPT: " + std::string(strerror(errno)));
+    }
+    // TCP_FASTOPEN：允许回访客户端在SYN中携带请求数据
+    if (family != AF_UNIX && fastOpenQueue_ > 0 &&
+        setsockopt(serverSocket, IPPROTO_TCP, TCP_FASTOPEN, &fastOpenQueue_, sizeof(fastOpenQueue_)) == -1) {
+        LOG_WARNING("Failed to set TCP_FASTOPEN: " + std::string(strerror(errno)));
+    }
+    // 以下选项由accept得到的套接字继承，每个连接不必再单独设置。
+    // TCP_NODELAY：关闭Nagle算法，保活连接上的小响应不会等待上一个报文的（延迟）ACK；
+    // 一个响应分多次写出时由flushOutput用TCP_CORK合并报文
+    if (family != AF_UNIX && tcpNoDelay_ &&
+        setsockopt(serverSocket, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) == -1) {
+        LOG_WARNING("Failed to set TCP_NODELAY: " + std::string(strerror(errno)));
+    }
+    // 收发缓冲区大小，0表示使用内核的自动调整；接收缓冲区须在listen之前设置才能决定窗口扩大因子
+    if (family != AF_UNIX && socketSendBuffer_ > 0 &&
+        setsockopt(serverSocket, SOL_SOCKET, SO_SNDBUF, &socketSendBuffer_, sizeof(socketSendBuffer_)) == -1) {
+        LOG_WARNING("Failed to set SO_SNDBUF: " + std::string(strerror(errno)));
+    }
+    if (family != AF_UNIX && socketReceiveBuffer_ > 0 &&
+        setsockopt(serverSocket, SOL_SOCKET, SO_RCVBUF, &socketReceiveBuffer_, sizeof(socketReceiveBuffer_)) == -1) {
+        LOG_WARNING("Failed to set SO_RCVBUF: " + std::string(strerror(errno)));
     }
 
-    // 监听连接
-    if (listen(serverSocket, 10) == -1) {
+    // 监听连接，队列长度会被内核截断到net.core.somaxconn
+    if (listen(serverSocket, listenBacklog_ > 0 ? listenBacklog_ : SOMAXCONN) == -1) {
         LOG_ERROR("Failed to listen on socket");
         close(serverSocket);
-        return false;
+        return -1;
     }
 
-    LOG_INFO("Server started on port " + std::to_string(port_));
-    running_ = true;
+    return serverSocket;
+}
 
-    // 接受连接
-    while (running_) {
-        struct sockaddr_in clientAddr;
-        socklen_t clientAddrLen = sizeof(clientAddr);
-        int clientSocket = accept(serverSocket, reinterpret_cast<struct sockaddr*>(&clientAddr), &clientAddrLen);
-        
-        if (clientSocket == -1) {
-            if (running_) {
-                LOG_ERROR("Failed to accept connection");
+bool WebServer::isSharedListener(size_t listener) const {
+    return exclusiveListener_ || listeners_[listener].type == ListenerSpec::Type::UNIX;
+}
+
+bool WebServer::openListeners() {
+    // 每个Reactor一个SO_REUSEPORT监听套接字，由内核在它们之间分发新连接；
+    // 共享的监听地址只创建一个套接字，各Reactor都在同一个套接字上accept
+    for (size_t listener = 0; listener < listeners_.size(); ++listener) {
+        const ListenerSpec& spec = listeners_[listener];
+        bool shared = isSharedListener(listener);
+        int sharedFd = -1;
+        for (auto& reactor : reactors_) {
+            int fd = sharedFd;
+            if (fd == -1) {
+                fd = createListenSocket(spec, !shared);
+                if (fd == -1) {
+                    closeListeners();
+                    return false;
+                }
+                listenSockets_.push_back(fd);
+                if (shared) {
+                    sharedFd = fd;
+                }
             }
-            continue;
+            reactor->listenFds.push_back(fd);
         }
 
-        // 获取客户端IP地址
-        char clientIP[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &(clientAddr.sin_addr), clientIP, INET_ADDRSTRLEN);
-        
-        // 处理连接
-        connectionManager_->addConnection(clientSocket, std::string(clientIP), [this, clientSocket]() {
-            this->handleConnection(clientSocket);
-        });
+        if (cpuSteering_ && !shared && reactors_.size() > 1) {
+            if (!attachCpuSteeringProgram(reactors_[0]->listenFds[listener], reactors_.size())) {
+                LOG_WARNING("Failed to attach reuseport CPU steering program, falling back to kernel hashing");
+            }
+        }
     }
-
-    close(serverSocket);
     return true;
 }
 
-void WebServer::stop() {
-    running_ = false;
-    connectionManager_->stopAll();
-    cleanupSSL();
+void WebServer::closeListeners() {
+    // 只删除本服务器成功绑定过的套接字文件
+    size_t opened = reactors_.empty() ? 0 : reactors_[0]->listenFds.size();
+    for (size_t listener = 0; listener < opened; ++listener) {
+        const ListenerSpec& spec = listeners_[listener];
+        if (spec.type == ListenerSpec::Type::UNIX && !spec.abstractNamespace) {
+            unlink(spec.path.c_str());
+        }
+    }
+    for (int fd : listenSockets_) {
+        close(fd);
+    }
+    listenSockets_.clear();
+    for (auto& reactor : reactors_) {
+        reactor->listenFds.clear();
+    }
 }
 
-void WebServer::addRoute(const std::string& path, Router::RequestHandler handler) {
-    router_->addRoute(path, handler);
+bool WebServer::attachCpuSteeringProgram(int listenFd, size_t groupSize) {
+    // 经典BPF：返回 当前CPU编号 % 组大小，作为SO_REUSEPORT组内的套接字下标。
+    // 组内套接字按创建顺序编号，与Reactor编号一致，配合线程绑核后
+    // 连接会被处理其网卡中断的CPU上的Reactor接受
+    struct sock_filter code[] = {
+        {static_cast<uint16_t>(BPF_LD | BPF_W | BPF_ABS), 0, 0,
+            static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+        {static_cast<uint16_t>(BPF_ALU | BPF_MOD | BPF_K), 0, 0, static_cast<uint32_t>(groupSize)},
+        {static_cast<uint16_t>(BPF_RET | BPF_A), 0, 0, 0},
+    };
+    struct sock_fprog program;
+    program.len = static_cast<unsigned short>(sizeof(code) / sizeof(code[0]));
+    program.filter = code;
+
+    if (setsockopt(listenFd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == -1) {
+        LOG_ERROR("Failed to attach reuseport BPF program: " + std::string(strerror(errno)));
+        return false;
+    }
+    return true;
 }
 
-void WebServer::handleConnection(int clientSocket) {
-    SSL* ssl = nullptr;
-    if (sslContext_) {
-        ssl = SSL_new(sslContext_);
-        SSL_set_fd(ssl, clientSocket);
-        
-        if (SSL_accept(ssl) <= 0) {
-            LOG_ERROR("SSL handshake failed");
-            ERR_print_errors_fp(stderr);
-            SSL_free(ssl);
-            close(clientSocket);
-            return;
-        }
+bool WebServer::setupIoUring() {
+    auto entries = static_cast<unsigned>(std::max(8, config_.get<int>("server.io_uring_entries", 256)));
+    auto bufferCount = static_cast<unsigned>(std::max(1, config_.get<int>("server.io_uring_buffer_count", 512)));
+    auto bufferSize = static_cast<size_t>(std::max(1024, config_.get<int>("server.io_uring_buffer_size", 8192)));
+
+    // 固定文件表按进程的描述符上限分配，连接的下标在其生命周期内不变
+    struct rlimit limit;
+    unsigned fileCount = kMaxRingFiles;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < kMaxRingFiles) {
+        fileCount = static_cast<unsigned>(limit.rlim_cur);
     }
 
-    // 初始化连接状态
-    bool keepAlive = false;
-    int maxRequests = config_.get<int>("server.max_requests_per_connection", 100);
-    int requestCount = 0;
-    
-    // 更新连接活动时间
-    connectionManager_->updateActivity(clientSocket);
+    bool ok = true;
+    for (auto& reactor : reactors_) {
+        try {
+            reactor->ring = std::make_unique<IoUring>(entries);
+        } catch (const std::exception& e) {
+            LOG_WARNING(e.what());
+            ok = false;
+            break;
+        }
 
-    // 处理连接上的多个请求
-    while (requestCount < maxRequests) {
-        // 设置非阻塞模式以支持超时
-        struct timeval tv;
-        tv.tv_sec = config_.get<int>("server.timeout", 60);
-        tv.tv_usec = 0;
-        
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(clientSocket, &readfds);
-        
-        // 等待数据可读或超时
-        int selectResult = select(clientSocket + 1, &readfds, NULL, NULL, &tv);
-        if (selectResult <= 0) {
-            // 超时或错误
+        if (!reactor->ring->registerFiles(fileCount)) {
+            LOG_WARNING("Failed to register io_uring file table: " + std::string(strerror(errno)));
+            ok = false;
             break;
         }
-        
-        // 读取请求
-        std::vector<char> buffer(4096);
-        const auto readSize = static_cast<int>(std::min(buffer.size() - 1, static_cast<size_t>(INT_MAX)));
-        ssize_t bytesRead = ssl ? SSL_read(ssl, buffer.data(), readSize)
-                                : recv(clientSocket, buffer.data(), static_cast<size_t>(readSize), 0);
-        if (bytesRead <= 0) {
+        if (!reactor->ring->registerBufferRing(kRingBufferGroup, bufferCount, bufferSize)) {
+            LOG_WARNING("Failed to register io_uring buffer ring (buffer count must be a power of two)");
+            ok = false;
             break;
         }
-        buffer[static_cast<size_t>(bytesRead)] = '\0';
-        std::string request(buffer.data());
-        
-        // 更新连接活动时间
-        connectionManager_->updateActivity(clientSocket);
-        requestCount++;
-        
-        // 使用HttpParser解析请求
-        std::string path;
-        std::map<std::string, std::string> headers;
-        std::string body;
-        HttpRequest requestObj = HttpParser::parseRequestToObject(request);
-        path = requestObj.getPath();
-        headers = requestObj.getHeaders();
-        body = requestObj.getBody();
-        LOG_INFO("Received request for path: " + path);
-        
-        // 检查Connection头，确定是否保持连接
-        keepAlive = false;
-        if (headers.count("Connection") > 0) {
-            keepAlive = (headers["Connection"] == "keep-alive");
+
+        reactor->ringEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (reactor->ringEventFd == -1 || !reactor->ring->registerEventFd(reactor->ringEventFd)) {
+            LOG_WARNING("Failed to register io_uring eventfd: " + std::string(strerror(errno)));
+            ok = false;
+            break;
         }
-        
-        // 设置连接的保活状态
-        connectionManager_->setKeepAlive(clientSocket, keepAlive);
-        
-        // 处理请求
-        bool found;
-        std::string content;
-        std::tie(found, content) = router_->handleRequest(path, headers, body);
-        
-        // 使用HttpParser构建响应
-        std::string response;
-        std::map<std::string, std::string> responseHeaders;
-        
-        // 添加Connection头
-        responseHeaders["Connection"] = keepAlive ? "keep-alive" : "close";
-        
-        // 如果是保活连接，添加Keep-Alive头
-        if (keepAlive) {
-            int timeout = config_.get<int>("server.keep_alive_timeout", 5);
-            int max = maxRequests - requestCount;
-            responseHeaders["Keep-Alive"] = "timeout=" + std::to_string(timeout) + 
-                                          ", max=" + std::to_string(max);
+
+        Reactor* reactorPtr = reactor.get();
+        if (!reactor->loop->addFd(reactor->ringEventFd, EPOLLIN, [this, reactorPtr](uint32_t) {
+                uint64_t value = 0;
+                ssize_t bytesRead = read(reactorPtr->ringEventFd, &value, sizeof(value));
+                (void)bytesRead;
+                reactorPtr->syscalls.fetch_add(1, std::memory_order_relaxed);
+                handleRingCompletions(*reactorPtr);
+            })) {
+            ok = false;
+            break;
         }
-        
-        if (found) {
-            // 检查是否需要分块传输
-            bool useChunked = headers.count("Transfer-Encoding") > 0 && 
-                             headers["Transfer-Encoding"] == "chunked";
-            
-            HttpResponse httpResponse(HttpStatus::OK, content, "text/html");
-            // 添加自定义头部
-            for (const auto& header : responseHeaders) {
-                httpResponse.setHeader(header.first, header.second);
-            }
-            
-            response = useChunked ? 
-                HttpParser::buildChunkedResponse(httpResponse) :
-                HttpParser::buildResponse(httpResponse);
-        } else {
-            HttpResponse httpResponse(HttpStatus::NOT_FOUND, 
-                "<html><body><h1>404 Not Found</h1></body></html>", "text/html");
-            // 添加自定义头部
-            for (const auto& header : responseHeaders) {
-                httpResponse.setHeader(header.first, header.second);
+        // 本轮事件处理中准备好的请求在进入下一次epoll_wait前一次性提交
+        reactor->loop->setPostIterationCallback([reactorPtr]() { reactorPtr->ring->submit(); });
+
+        reactor->ringSlots.assign(fileCount, nullptr);
+        reactor->ringSlotGenerations.assign(fileCount, 0);
+        reactor->freeRingSlots.clear();
+        for (unsigned slot = fileCount; slot > 0; --slot) {
+            reactor->freeRingSlots.push_back(slot - 1);
+        }
+    }
+
+    if (!ok) {
+        for (auto& reactor : reactors_) {
+            if (reactor->ringEventFd != -1) {
+                reactor->loop->removeFd(reactor->ringEventFd);
+                close(reactor->ringEventFd);
+                reactor->ringEventFd = -1;
             }
-            
-            response = HttpParser::buildResponse(httpResponse);
+            reactor->loop->setPostIterationCallback(nullptr);
+            reactor->ring.reset();
+            reactor->ringSlots.clear();
+            reactor->ringSlotGenerations.clear();
+            reactor->freeRingSlots.clear();
         }
-        
-        // 发送响应
-        if (ssl) {
-            const auto writeSize = static_cast<int>(std::min(response.size(), static_cast<size_t>(INT_MAX)));
-            SSL_write(ssl, response.c_str(), writeSize);
+    }
+    return ok;
+}
+
+void WebServer::armAccept(Reactor& reactor, size_t listener) {
+    io_uring_sqe* sqe = reactor.ring->getSqe();
+    if (!sqe) {
+        LOG_ERROR("io_uring submission queue full, cannot arm accept");
+        return;
+    }
+    // 不设置SOCK_NONBLOCK：套接字只通过io_uring访问，由内核决定何时就绪
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = reactor.listenFds[listener];
+    sqe->ioprio = static_cast<uint16_t>(IORING_ACCEPT_MULTISHOT);
+    sqe->accept_flags = SOCK_CLOEXEC;
+    // accept请求的user_data在下标字段中记录监听地址下标，终止时据此重新提交
+    sqe->user_data = encodeUserData(RingOp::ACCEPT, static_cast<uint32_t>(listener), 0);
+    ++reactor.armedAccepts;
+}
+
+void WebServer::armRecv(Connection& conn) {
+    Reactor& reactor = *conn.reactor;
+    io_uring_sqe* sqe = reactor.ring->getSqe();
+    if (!sqe) {
+        LOG_ERROR("io_uring submission queue full, closing connection from " + conn.clientAddress.toString());
+        closeConnection(conn);
+        return;
+    }
+    // 多发recv在数据到达时才从提供缓冲区环中取缓冲区，空闲连接不占用读缓冲
+    auto slot = static_cast<uint32_t>(conn.ringSlot);
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn.ringSlot;
+    sqe->flags = static_cast<uint8_t>(IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT);
+    sqe->ioprio = static_cast<uint16_t>(IORING_RECV_MULTISHOT);
+    sqe->buf_group = kRingBufferGroup;
+    sqe->user_data = encodeUserData(RingOp::RECV, slot, reactor.ringSlotGenerations[slot]);
+    conn.recvArmed = true;
+    conn.pendingOps++;
+}
+
+bool WebServer::submitSend(Connection& conn) {
+    if (conn.sendInFlight) {
+        // 新数据留在输出队列中，当前sendmsg完成后再发送
+        return true;
+    }
+    if (conn.output.empty()) {
+        return true;
+    }
+    Reactor& reactor = *conn.reactor;
+    std::unique_ptr<RingSend> send = acquireRingSend(reactor);
+    bool more = false;
+    size_t count = conn.output.gather(send->iov, kMaxSendSegments, more);
+    if (count == 0) {
+        // io_uring后端没有sendfile，文件内容分段读入后再提交
+        if (!fillFromFile(conn)) {
+            releaseRingSend(reactor, std::move(send));
+            return false;
+        }
+        count = conn.output.gather(send->iov, kMaxSendSegments, more);
+    }
+    io_uring_sqe* sqe = count > 0 ? reactor.ring->getSqe() : nullptr;
+    if (!sqe) {
+        releaseRingSend(reactor, std::move(send));
+        return count == 0;
+    }
+    // 段在完成之前不会出队，iov引用的数据一直有效
+    auto slot = static_cast<uint32_t>(conn.ringSlot);
+    send->message = {};
+    send->message.msg_iov = send->iov;
+    send->message.msg_iovlen = count;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = conn.ringSlot;
+    sqe->flags = static_cast<uint8_t>(IOSQE_FIXED_FILE);
+    sqe->addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&send->message));
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL | (more ? MSG_MORE : 0);
+    sqe->user_data = encodeUserData(RingOp::SEND, slot, reactor.ringSlotGenerations[slot]);
+    conn.ringSend = std::move(send);
+    conn.sendInFlight = true;
+    conn.pendingOps++;
+    return true;
+}
+
+void WebServer::handleRingCompletions(Reactor& reactor) {
+    reactor.ring->forEachCompletion([this, &reactor](const io_uring_cqe& cqe) {
+        auto op = static_cast<RingOp>(cqe.user_data >> 56);
+        auto slot = static_cast<uint32_t>((cqe.user_data >> 32) & 0xFFFFFFu);
+        auto generation = static_cast<uint32_t>(cqe.user_data);
+
+        if (op == RingOp::ACCEPT) {
+            if (cqe.res >= 0) {
+                handleRingAccept(reactor, cqe.res);
+            } else if (cqe.res != -ECANCELED && running_) {
+                LOG_ERROR("Failed to accept connection: " + std::string(strerror(-cqe.res)));
+            }
+            // 多发请求在出错或被取消时终止，运行期间需要重新提交
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                --reactor.armedAccepts;
+                if (running_ && cqe.res != -ECANCELED && slot < reactor.listenFds.size()) {
+                    armAccept(reactor, slot);
+                }
+            }
+            return;
+        }
+        if (op != RingOp::RECV && op != RingOp::SEND && op != RingOp::CLOSE_SLOT) {
+            return;
+        }
+
+        // 下标代数不一致说明完成项属于已经释放的旧连接
+        if (slot >= reactor.ringSlots.size() || reactor.ringSlotGenerations[slot] != generation ||
+            !reactor.ringSlots[slot]) {
+            return;
+        }
+        Connection& conn = *reactor.ringSlots[slot];
+        if (op == RingOp::RECV) {
+            handleRingRecv(conn, cqe.res, cqe.flags);
+        } else if (op == RingOp::SEND) {
+            handleRingSend(conn, cqe.res);
         } else {
-            send(clientSocket, response.c_str(), static_cast<size_t>(response.size()), 0);
+            conn.pendingOps--;
         }
-        
-        // 如果不保持连接，退出循环
-        if (!keepAlive) {
+        refreshConnectionTimer(conn);
+
+        if (conn.state == ConnectionState::CLOSED && conn.pendingOps == 0) {
+            releaseRingConnection(conn);
+        }
+    });
+}
+
+void WebServer::handleRingAccept(Reactor& reactor, int clientSocket) {
+    reactor.accepted.fetch_add(1, std::memory_order_relaxed);
+
+    // 获取客户端地址（二进制形式，不做字符串格式化）
+    struct sockaddr_storage clientAddr{};
+    socklen_t clientAddrLen = sizeof(clientAddr);
+    reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+    getpeername(clientSocket, reinterpret_cast<struct sockaddr*>(&clientAddr), &clientAddrLen);
+    IpAddress clientAddress = IpAddress::fromSockaddr(reinterpret_cast<struct sockaddr*>(&clientAddr));
+
+    // 被访问控制列表拒绝或超出连接数限制时ConnectionManager会直接关闭套接字
+    if (!connectionManager_->addConnection(clientSocket, clientAddress)) {
+        return;
+    }
+
+    if (reactor.freeRingSlots.empty()) {
+        LOG_ERROR("No free io_uring file slot for connection from " + clientAddress.toString());
+        connectionManager_->closeConnection(clientSocket);
+        return;
+    }
+    uint32_t slot = reactor.freeRingSlots.back();
+    if (!reactor.ring->updateFile(slot, clientSocket)) {
+        LOG_ERROR("Failed to register connection in io_uring file table: " + std::string(strerror(errno)));
+        connectionManager_->closeConnection(clientSocket);
+        return;
+    }
+    reactor.freeRingSlots.pop_back();
+
+    auto conn = std::make_unique<Connection>();
+    conn->fd = clientSocket;
+    conn->reactor = &reactor;
+    conn->id = nextConnectionId_++;
+    conn->clientAddress = clientAddress;
+    conn->parser = HttpRequestParser(requestLimits_);
+    conn->ringSlot = static_cast<int>(slot);
+
+    Connection* connPtr = conn.get();
+    reactor.ringSlots[slot] = connPtr;
+    reactor.connections[clientSocket] = std::move(conn);
+    armRecv(*connPtr);
+    refreshConnectionTimer(*connPtr);
+
+    // 更新连接活动时间
+    connectionManager_->updateActivity(clientSocket);
+}
+
+void WebServer::handleRingRecv(Connection& conn, int result, uint32_t flags) {
+    Reactor& reactor = *conn.reactor;
+    if (!(flags & IORING_CQE_F_MORE)) {
+        conn.recvArmed = false;
+        conn.pendingOps--;
+    }
+
+    if (result > 0) {
+        // 数据复制后立即归还缓冲区，缓冲区只在数据到达到被处理之间被占用
+        auto bufferId = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (conn.state != ConnectionState::CLOSED) {
+            unparkConnection(conn);
+            conn.phaseBytes += static_cast<uint64_t>(result);
+            conn.inputBuffer.append(reactor.ring->buffer(bufferId), static_cast<size_t>(result));
+        }
+        reactor.ring->recycleBuffer(bufferId);
+    } else if (result == 0) {
+        conn.peerClosed = true;
+    } else if (result != -ENOBUFS && !(result == -ECANCELED && conn.readPaused)) {
+        // -ECANCELED来自关闭连接或暂停读取时的取消请求，其余为读取错误
+        closeConnection(conn);
+        return;
+    }
+
+    if (conn.state == ConnectionState::CLOSED) {
+        return;
+    }
+    // 缓冲区耗尽（-ENOBUFS）或内核终止了多发请求时重新提交，暂停读取期间不提交
+    if (!conn.recvArmed && !conn.peerClosed && !conn.readPaused) {
+        armRecv(conn);
+    }
+    if (conn.state == ConnectionState::READING) {
+        processRequests(conn);
+    }
+}
+
+void WebServer::handleRingSend(Connection& conn, int result) {
+    conn.sendInFlight = false;
+    conn.pendingOps--;
+    releaseRingSend(*conn.reactor, std::move(conn.ringSend));
+    if (conn.state == ConnectionState::CLOSED) {
+        return;
+    }
+    if (result < 0) {
+        closeConnection(conn);
+        return;
+    }
+
+    conn.output.consume(static_cast<size_t>(result));
+    conn.phaseBytes += static_cast<uint64_t>(result);
+    // 继续发送剩余部分或send期间追加的数据
+    if (!submitSend(conn)) {
+        closeConnection(conn);
+        return;
+    }
+    if (conn.state == ConnectionState::WRITING) {
+        resumeAfterWrite(conn);
+    }
+}
+
+void WebServer::releaseRingConnection(Connection& conn) {
+    Reactor& reactor = *conn.reactor;
+    auto slot = static_cast<uint32_t>(conn.ringSlot);
+    reactor.ringSlots[slot] = nullptr;
+    reactor.ringSlotGenerations[slot]++;
+    reactor.freeRingSlots.push_back(slot);
+
+    auto it = reactor.drainingConnections.find(&conn);
+    if (it != reactor.drainingConnections.end()) {
+        retireConnection(reactor, std::move(it->second));
+        reactor.drainingConnections.erase(it);
+    }
+}
+
+void WebServer::drainRing(Reactor& reactor) {
+    // 取消所有未完成的请求（包括多发accept），等待其完成项后连接才能安全释放
+    io_uring_sqe* sqe = reactor.ring->getSqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+    sqe->user_data = encodeUserData(RingOp::CANCEL, 0, 0);
+
+    for (int round = 0; round < kMaxRingDrainRounds &&
+         (reactor.armedAccepts > 0 || !reactor.drainingConnections.empty()); ++round) {
+        if (reactor.ring->submitAndWait() < 0) {
             break;
         }
+        handleRingCompletions(reactor);
+    }
+}
+
+uint64_t WebServer::currentTick(const Reactor& reactor) const {
+    auto elapsed = std::chrono::steady_clock::now() - reactor.timerEpoch;
+    return static_cast<uint64_t>(elapsed / timerTick_) + 1;
+}
+
+void WebServer::handleTimerTick(Reactor& reactor) {
+    uint64_t expirations = 0;
+    ssize_t bytesRead = read(reactor.timerFd, &expirations, sizeof(expirations));
+    (void)bytesRead;
+    reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+
+    // 只有真正到期的连接会被访问
+    reactor.timers.advance(currentTick(reactor), [this, &reactor](TimerNode& node) {
+        Connection& conn = *static_cast<Connection*>(node.owner);
+        if (conn.state == ConnectionState::CLOSED) {
+            // 已关闭的连接等待零拷贝完成通知超时
+            releaseLingeringConnection(conn, true);
+            return;
+        }
+        // 保活连接到达检查点时按当前的保活超时重新计算，尚未超时就继续等待
+        if (conn.timerPhase == TimerPhase::KEEP_ALIVE) {
+            uint64_t deadline = keepAliveDeadline(conn, node.expiry);
+            if (deadline > node.expiry) {
+                reactor.timers.schedule(conn.timer, deadline);
+                return;
+            }
+        }
+        LOG_DEBUG("Closing timed out connection from " + conn.clientAddress.toString() + ": " +
+                  timerPhaseName(conn.timerPhase));
+        closeConnection(conn);
+    });
+}
+
+void WebServer::refreshConnectionTimer(Connection& conn) {
+    if (conn.state == ConnectionState::CLOSED) {
+        return;
+    }
+
+    Reactor& reactor = *conn.reactor;
+    uint64_t now = currentTick(reactor);
+    TimerPhase phase = timerPhase(conn);
+    if (phase != conn.timerPhase) {
+        conn.timerPhase = phase;
+        conn.phaseStartTick = now;
+        conn.phaseBytes = 0;
+    }
+
+    // 无活动超时之外，握手、请求头、请求体和发送响应还有从阶段开始计算的总时限，
+    // 零星的活动无法让慢速客户端无限期占住连接
+    uint64_t deadline = now + idleTimeoutTicks_;
+    switch (phase) {
+        case TimerPhase::HANDSHAKE:
+            deadline = std::min(deadline, conn.phaseStartTick + handshakeTimeoutTicks_);
+            break;
+        case TimerPhase::KEEP_ALIVE:
+            deadline = keepAliveDeadline(conn, now);
+            parkConnection(conn);
+            break;
+        case TimerPhase::HEADERS:
+            deadline = std::min(deadline, conn.phaseStartTick + headerTimeoutTicks_);
+            break;
+        case TimerPhase::BODY:
+            deadline = std::min(deadline, conn.phaseStartTick + bodyTimeoutTicks_ +
+                                          rateAllowanceTicks(conn.phaseBytes, minBodyRate_));
+            break;
+        case TimerPhase::DRAIN:
+            deadline = std::min(deadline, conn.phaseStartTick + drainTimeoutTicks_ +
+                                          rateAllowanceTicks(conn.phaseBytes, minSendRate_));
+            break;
+        default:
+            break;
+    }
+    conn.timer.owner = &conn;
+    reactor.timers.schedule(conn.timer, deadline);
+}
+
+TimerPhase WebServer::timerPhase(const Connection& conn) {
+    if (conn.state == ConnectionState::HANDSHAKE) {
+        return TimerPhase::HANDSHAKE;
+    }
+    if (conn.state == ConnectionState::PROCESSING) {
+        return TimerPhase::PROCESSING;
+    }
+    if (hasPendingOutput(conn)) {
+        return TimerPhase::DRAIN;
+    }
+    if (conn.parser.headersComplete()) {
+        return TimerPhase::BODY;
+    }
+    if (!conn.inputBuffer.empty()) {
+        return TimerPhase::HEADERS;
+    }
+    return conn.requestCount > 0 ? TimerPhase::KEEP_ALIVE : TimerPhase::IDLE;
+}
+
+uint64_t WebServer::rateAllowanceTicks(uint64_t bytes, uint64_t minRate) const {
+    // 每按最低速率传输一秒的数据，阶段时限延长一秒；平均速率低于最低速率的连接终将超时
+    if (minRate == 0) {
+        return 0;
+    }
+    auto allowance = std::chrono::milliseconds(bytes * 1000 / minRate) / timerTick_;
+    return static_cast<uint64_t>(allowance);
+}
+
+uint64_t WebServer::secondsToTicks(int seconds) const {
+    auto ticks = std::chrono::milliseconds(std::max(1, seconds) * 1000) / timerTick_;
+    return static_cast<uint64_t>(std::max<int64_t>(1, ticks));
+}
+
+uint64_t WebServer::keepAliveDeadline(const Connection& conn, uint64_t now) const {
+    ConnectionManager::KeepAliveLimits limits = connectionManager_->keepAliveLimits();
+    uint64_t deadline = conn.phaseStartTick + secondsToTicks(limits.timeoutSeconds);
+    if (limits.adaptive) {
+        deadline = std::min(deadline, now + secondsToTicks(1));
+    }
+    return deadline;
+}
+
+void WebServer::parkConnection(Connection& conn) {
+    if (conn.parkedBytes > 0) {
+        return;
+    }
+    // 空闲连接不持有输入缓冲区：容量适中的放回Reactor，下一个有数据到达的连接直接复用，不必重新分配
+    Reactor& reactor = *conn.reactor;
+    if (heapBytes(conn.inputBuffer) > 0) {
+        if (reactor.spareBuffers.size() < kMaxSpareBuffers && conn.inputBuffer.capacity() <= kMaxSpareBufferCapacity) {
+            conn.inputBuffer.clear();
+            reactor.spareBuffers.push_back(std::move(conn.inputBuffer));
+        }
+        std::string().swap(conn.inputBuffer);
+    }
+    conn.parser.releaseMemory();
+    conn.output.releaseMemory();
+    if (conn.zeroCopyPending.empty()) {
+        std::vector<ZeroCopySend>().swap(conn.zeroCopyPending);
+    }
+
+    conn.parkedBytes = connectionMemory(conn);
+    reactor.parkedConnections.fetch_add(1, std::memory_order_relaxed);
+    reactor.parkedBytes.fetch_add(conn.parkedBytes, std::memory_order_relaxed);
+}
+
+void WebServer::unparkConnection(Connection& conn) {
+    if (conn.parkedBytes == 0) {
+        return;
+    }
+    Reactor& reactor = *conn.reactor;
+    reactor.parkedConnections.fetch_sub(1, std::memory_order_relaxed);
+    reactor.parkedBytes.fetch_sub(conn.parkedBytes, std::memory_order_relaxed);
+    conn.parkedBytes = 0;
+    if (conn.state != ConnectionState::CLOSED && !reactor.spareBuffers.empty()) {
+        conn.inputBuffer = std::move(reactor.spareBuffers.back());
+        reactor.spareBuffers.pop_back();
+    }
+}
+
+size_t WebServer::connectionMemory(const Connection& conn) {
+    // TLS会话的读写记录缓冲区在空闲时由OpenSSL释放（SSL_MODE_RELEASE_BUFFERS），不计入
+    return sizeof(Connection) + heapBytes(conn.inputBuffer) + conn.parser.memoryUsage() + conn.output.memoryUsage() +
+           conn.zeroCopyPending.capacity() * sizeof(ZeroCopySend);
+}
+
+bool WebServer::hasPendingOutput(const Connection& conn) {
+    return !conn.output.empty() || conn.sendInFlight;
+}
+
+void WebServer::runReactor(Reactor& reactor) {
+    if (cpuSteering_) {
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(reactor.index % cores, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            LOG_WARNING("Failed to pin reactor " + std::to_string(reactor.index) + " to a CPU");
+        }
+    }
+
+    if (reactor.ring) {
+        // 提交启动时准备好的accept请求
+        reactor.ring->submit();
+    }
+
+    reactor.loop->loop();
+
+    // 事件循环退出后在本线程中释放所有连接
+    while (!reactor.connections.empty()) {
+        closeConnection(*reactor.connections.begin()->second);
+    }
+    if (reactor.ring) {
+        drainRing(reactor);
+    } else {
+        for (int listenFd : reactor.listenFds) {
+            reactor.loop->removeFd(listenFd);
+        }
+        // 退出时不再等待零拷贝完成通知
+        while (!reactor.drainingConnections.empty()) {
+            releaseLingeringConnection(*reactor.drainingConnections.begin()->first, true);
+        }
+    }
+}
+
+void WebServer::handleAccept(Reactor& reactor, size_t listener) {
+    // 边缘触发下必须accept到EAGAIN，否则会丢失通知；
+    // 一轮达到批量上限时把剩余的留到本轮事件处理之后，让已有连接的事件先得到处理
+    for (size_t batch = 0;; ++batch) {
+        if (batch == acceptBatch_) {
+            if (!isSharedListener(listener)) {
+                Reactor* reactorPtr = &reactor;
+                reactor.loop->queueInLoop([this, reactorPtr, listener]() { handleAccept(*reactorPtr, listener); });
+            }
+            return;
+        }
+
+        struct sockaddr_storage clientAddr;
+        socklen_t clientAddrLen = sizeof(clientAddr);
+        reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+        int clientSocket = accept4(reactor.listenFds[listener], reinterpret_cast<struct sockaddr*>(&clientAddr),
+                                   &clientAddrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (clientSocket == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && running_) {
+                LOG_ERROR("Failed to accept connection: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+
+        reactor.accepted.fetch_add(1, std::memory_order_relaxed);
+
+        // 获取客户端地址（二进制形式，不做字符串格式化）
+        IpAddress clientAddress = IpAddress::fromSockaddr(reinterpret_cast<struct sockaddr*>(&clientAddr));
+
+        // 被访问控制列表拒绝或超出连接数限制时ConnectionManager会直接关闭套接字
+        if (!connectionManager_->addConnection(clientSocket, clientAddress)) {
+            continue;
+        }
+
+        auto conn = std::make_unique<Connection>();
+        conn->fd = clientSocket;
+        conn->reactor = &reactor;
+        conn->id = nextConnectionId_++;
+        conn->clientAddress = clientAddress;
+        conn->parser = HttpRequestParser(requestLimits_);
+        conn->tcp = listeners_[listener].type != ListenerSpec::Type::UNIX;
+
+        if (sslContext_) {
+            conn->ssl = SSL_new(sslContext_);
+            SSL_set_fd(conn->ssl, clientSocket);
+            SSL_set_accept_state(conn->ssl);
+            conn->state = ConnectionState::HANDSHAKE;
+        }
+
+        Connection* connPtr = conn.get();
+        reactor.connections[clientSocket] = std::move(conn);
+        if (!reactor.loop->addFd(clientSocket, kConnectionEvents,
+                [this, connPtr](uint32_t events) {
+                    handleConnection(*connPtr, events);
+                    refreshConnectionTimer(*connPtr);
+                })) {
+            closeConnection(*connPtr);
+            continue;
+        }
+        refreshConnectionTimer(*connPtr);
+
+        // 更新连接活动时间
+        connectionManager_->updateActivity(clientSocket);
+    }
+}
+
+void WebServer::handleConnection(Connection& conn, uint32_t events) {
+    // 零拷贝发送的完成通知经错误队列送达，同样以EPOLLERR报告
+    if ((events & EPOLLERR) && (conn.zeroCopyPending.empty() || !reapZeroCopyCompletions(conn))) {
+        closeConnection(conn);
+        return;
+    }
+
+    if (conn.state == ConnectionState::HANDSHAKE) {
+        if (!doHandshake(conn)) {
+            closeConnection(conn);
+            return;
+        }
+        if (conn.state == ConnectionState::HANDSHAKE) {
+            return;
+        }
+    }
+
+    // 可读事件：要读空，否则边缘触发会丢失通知；暂停读取时数据留在内核中，恢复时再主动读取
+    if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) && !conn.readPaused) {
+        if (!readFromConnection(conn)) {
+            closeConnection(conn);
+            return;
+        }
+    }
+
+    // 可写事件：继续发送未写完的响应，READING状态下也可能有低于高水位的积压
+    if (hasPendingOutput(conn) && !flushOutput(conn)) {
+        closeConnection(conn);
+        return;
+    }
+
+    if (conn.state == ConnectionState::WRITING) {
+        resumeAfterWrite(conn);
+    } else if (conn.state == ConnectionState::READING) {
+        processRequests(conn);
+    }
+}
+
+bool WebServer::doHandshake(Connection& conn) {
+    int result = SSL_accept(conn.ssl);
+    if (result == 1) {
+        conn.state = ConnectionState::READING;
+        return true;
+    }
+
+    int error = SSL_get_error(conn.ssl, result);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+        return true;
+    }
+
+    LOG_ERROR("SSL handshake failed");
+    ERR_print_errors_fp(stderr);
+    return false;
+}
+
+bool WebServer::readFromConnection(Connection& conn) {
+    char buffer[kReadChunkSize];
+    while (!conn.peerClosed) {
+        ssize_t bytesRead;
+        if (conn.ssl) {
+            bytesRead = SSL_read(conn.ssl, buffer, static_cast<int>(sizeof(buffer)));
+            if (bytesRead <= 0) {
+                int error = SSL_get_error(conn.ssl, static_cast<int>(bytesRead));
+                if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+                    return true;
+                }
+                if (error == SSL_ERROR_ZERO_RETURN) {
+                    conn.peerClosed = true;
+                    return true;
+                }
+                return false;
+            }
+        } else {
+            conn.reactor->syscalls.fetch_add(1, std::memory_order_relaxed);
+            bytesRead = recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (bytesRead == 0) {
+                conn.peerClosed = true;
+                return true;
+            }
+            if (bytesRead < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+        }
+        unparkConnection(conn);
+        conn.phaseBytes += static_cast<uint64_t>(bytesRead);
+        conn.inputBuffer.append(buffer, static_cast<size_t>(bytesRead));
+        if (conn.inputBuffer.size() >= kBodyPumpThreshold && conn.state == ConnectionState::READING) {
+            // 边缘触发要一直读到EAGAIN，大请求体边读边交出，缓冲区不随上传大小增长
+            parseRequest(conn);
+        }
+    }
+    return true;
+}
+
+void WebServer::processRequests(Connection& conn) {
+    if (conn.yielded) {
+        // 已让出本轮，由排队的续处理继续，避免一个连接在同一轮中被处理两次
+        return;
+    }
+    // 同一批读入的流水线请求按顺序处理（每轮不超过处理预算），响应积累在输出队列中，最后聚集成尽量少的sendmsg
+    conn.batchingOutput = true;
+    dispatchRequests(conn);
+    conn.batchingOutput = false;
+
+    if (conn.state == ConnectionState::READING && hasPendingOutput(conn)) {
+        finishResponse(conn);
+    } else if (conn.state == ConnectionState::PROCESSING && !conn.output.empty() && !flushOutput(conn)) {
+        // 交给工作线程之前的响应不必等它完成
+        closeConnection(conn);
+    }
+}
+
+void WebServer::dispatchRequests(Connection& conn) {
+    size_t requests = 0;
+    size_t bytes = 0;
+    while (conn.state == ConnectionState::READING) {
+        // 一次读入大量流水线请求的客户端不能独占事件循环：用完本轮预算后让出，同一Reactor上的其他连接先得到处理
+        if (!conn.inputBuffer.empty() && ((fairnessMaxRequests_ > 0 && requests >= fairnessMaxRequests_) ||
+                                          (fairnessMaxBytes_ > 0 && bytes >= fairnessMaxBytes_))) {
+            yieldConnection(conn);
+            return;
+        }
+
+        // 解析器记住上次的位置，只扫描新读入的字节
+        HttpRequestParser::Status status = parseRequest(conn);
+        if (status == HttpRequestParser::Status::INCOMPLETE) {
+            if (conn.peerClosed) {
+                // 对端已关闭且没有完整请求，连接不再有用
+                closeConnection(conn);
+            }
+            return;
+        }
+        if (status == HttpRequestParser::Status::ERROR) {
+            sendErrorResponse(conn, conn.parser.errorStatus());
+            return;
+        }
+
+        // 路由和处理函数使用拥有所有权的字符串，复制之后即可从缓冲区移除该请求
+        const RequestView& request = conn.parser.request();
+        bool wantsKeepAlive = request.keepAlive();
+        std::string method(request.method);
+        std::string path(request.path);
+        HttpHeaders headers = toHttpHeaders(request);
+        std::map<std::string, std::string> routeHeaders = toHeaderMap(request);
+        std::string body(request.body);
+        bool streamed = conn.parser.hasBodyHandler() && !conn.spooledBody;
+        std::shared_ptr<SpooledBody> spooledBody = std::move(conn.spooledBody);
+        std::unique_ptr<BodyConsumer> bodyConsumer = std::move(conn.bodyConsumer);
+        // request引用解析器内部的状态，reset()之后长度会被清零，先取出
+        size_t length = request.length;
+        conn.inputBuffer.erase(0, length);
+        conn.parser.reset();
+        conn.timerPhase = TimerPhase::NONE;
+        requests++;
+        bytes += length;
+        
+        // 更新连接活动时间
+        connectionManager_->updateActivity(conn.fd);
+        conn.requestCount++;
+        conn.reactor->requests.fetch_add(1, std::memory_order_relaxed);
+        LOG_INFO("Received request for path: " + path);
+        
+        // HTTP/1.1默认保持连接，HTTP/1.0需要Connection: keep-alive
+        conn.keepAlive = wantsKeepAlive;
+        if (conn.requestCount >= connectionManager_->keepAliveLimits().maxRequests) {
+            conn.keepAlive = false;
+        }
+        
+        // 设置连接的保活状态
+        connectionManager_->setKeepAlive(conn.fd, conn.keepAlive);
+
+        // 静态文件在事件循环中直接处理：命中缓存时不涉及磁盘I/O，文件内容由sendfile发送
+        auto staticHandler = std::find_if(staticHandlers_.begin(), staticHandlers_.end(),
+            [&path](const std::unique_ptr<StaticFileHandler>& handler) { return handler->matches(path); });
+        if (staticHandler != staticHandlers_.end()) {
+            sendStaticResponse(conn, (*staticHandler)->handle(method, path, headers));
+            if (conn.state != ConnectionState::READING) {
+                break;
+            }
+            continue;
+        }
+
+        if (streamed) {
+            // 流式路由：请求体已经全部交给BodyConsumer，只剩取出响应内容
+            if (!bodyConsumer) {
+                sendErrorResponse(conn, HttpStatus::INTERNAL_SERVER_ERROR);
+                return;
+            }
+            sendResponse(conn, headers, true, bodyConsumer->finish());
+            if (conn.state == ConnectionState::CLOSED) {
+                return;
+            }
+            continue;
+        }
+
+        if (workerPool_ && router_->isOffloaded(path)) {
+            // 处理函数交给工作线程，完成后回到事件循环继续推进状态机
+            conn.state = ConnectionState::PROCESSING;
+            Reactor* reactor = conn.reactor;
+            int socket = conn.fd;
+            uint64_t id = conn.id;
+            workerPool_->enqueue([this, reactor, socket, id, path, headers, routeHeaders, body, spooledBody]() {
+                auto result = spooledBody ? router_->handleUpload(path, routeHeaders, *spooledBody)
+                                          : router_->handleRequest(path, routeHeaders, body);
+                reactor->loop->queueInLoop([this, reactor, socket, id, headers, result = std::move(result)]() mutable {
+                    Connection* target = findConnection(*reactor, socket, id);
+                    if (!target) {
+                        return;
+                    }
+                    target->state = ConnectionState::READING;
+                    sendResponse(*target, headers, result.first, std::move(result.second));
+                    if (target->state == ConnectionState::READING) {
+                        processRequests(*target);
+                    }
+                    refreshConnectionTimer(*target);
+                });
+            });
+            return;
+        }
+        
+        // 处理请求
+        bool found;
+        std::string content;
+        std::tie(found, content) = spooledBody ? router_->handleUpload(path, routeHeaders, *spooledBody)
+                                               : router_->handleRequest(path, routeHeaders, body);
+        spooledBody.reset();
+        sendResponse(conn, headers, found, std::move(content));
+        if (conn.state == ConnectionState::CLOSED) {
+            return;
+        }
+    }
+}
+
+void WebServer::yieldConnection(Connection& conn) {
+    conn.yielded = true;
+    conn.reactor->fairnessYields.fetch_add(1, std::memory_order_relaxed);
+    // 续处理排在本轮事件之后执行；续处理中再次让出时排到下一轮，期间新到达的事件先得到处理
+    Reactor* reactor = conn.reactor;
+    int socket = conn.fd;
+    uint64_t id = conn.id;
+    reactor->loop->queueInLoop([this, reactor, socket, id]() {
+        Connection* target = findConnection(*reactor, socket, id);
+        if (!target) {
+            return;
+        }
+        target->yielded = false;
+        if (target->state == ConnectionState::READING) {
+            processRequests(*target);
+        }
+        refreshConnectionTimer(*target);
+    });
+}
+
+HttpRequestParser::Status WebServer::parseRequest(Connection& conn) {
+    while (true) {
+        HttpRequestParser::Status status = conn.parser.parse(conn.inputBuffer);
+        if (status == HttpRequestParser::Status::HEADERS_COMPLETE) {
+            beginRequestBody(conn);
+            continue;
+        }
+        if (status == HttpRequestParser::Status::INCOMPLETE) {
+            conn.parser.discardDeliveredBody(conn.inputBuffer);
+        }
+        return status;
+    }
+}
+
+void WebServer::beginRequestBody(Connection& conn) {
+    const RequestView& request = conn.parser.request();
+    std::string path(request.path);
+    Router::BodyMode mode = router_->bodyMode(path);
+    if (mode == Router::BodyMode::BUFFERED) {
+        return;
+    }
+
+    // 请求体不在内存中累积，适用更大的上限
+    conn.parser.setMaxBodySize(maxUploadSize_);
+    if (mode == Router::BodyMode::SPOOLED) {
+        conn.spooledBody = std::make_shared<SpooledBody>(bodyMemoryLimit_, uploadTempDir_);
+        SpooledBody* body = conn.spooledBody.get();
+        conn.parser.setBodyHandler([body](std::string_view data) { return body->append(data); });
+        return;
+    }
+
+    // 处理函数拒绝时仍然设置接收者，让请求体的第一段数据或请求完成时返回500
+    conn.bodyConsumer = router_->openStream(path, toHeaderMap(request));
+    BodyConsumer* consumer = conn.bodyConsumer.get();
+    conn.parser.setBodyHandler([consumer](std::string_view data) { return consumer && consumer->consume(data); });
+}
+
+void WebServer::sendErrorResponse(Connection& conn, HttpStatus status) {
+    std::string statusLine = std::to_string(static_cast<int>(status)) + " " +
+                             HttpStatusHandler::getInstance().getStatusMessage(status);
+    LOG_WARNING("Rejecting request from " + conn.clientAddress.toString() + ": " + statusLine);
+    conn.spooledBody.reset();
+    conn.bodyConsumer.reset();
+    conn.keepAlive = false;
+    conn.output.append(HttpParser::buildResponse(status, "<html><body><h1>" + statusLine + "</h1></body></html>"));
+    finishResponse(conn);
+}
+
+void WebServer::addConnectionHeaders(const Connection& conn, HttpResponse& response) const {
+    // 添加Connection头
+    response.setHeader("Connection", conn.keepAlive ? "keep-alive" : "close");
+
+    // 如果是保活连接，添加Keep-Alive头
+    if (conn.keepAlive) {
+        // 通告当前生效的值，连接压力下两者都会收缩；判断保活之后限制可能又变小，剩余次数至少为1
+        ConnectionManager::KeepAliveLimits limits = connectionManager_->keepAliveLimits();
+        int max = std::max(1, limits.maxRequests - conn.requestCount);
+        response.setHeader("Keep-Alive", "timeout=" + std::to_string(limits.timeoutSeconds) +
+                                         ", max=" + std::to_string(max));
+    }
+}
+
+void WebServer::sendResponse(Connection& conn, const HttpHeaders& headers, bool found, std::string content) {
+    if (found) {
+        // 检查是否需要分块传输
+        bool useChunked = headers.get(HttpHeader::TRANSFER_ENCODING) == "chunked";
+        
+        HttpResponse httpResponse(HttpStatus::OK, std::move(content), "text/html");
+        addConnectionHeaders(conn, httpResponse);
+
+        // 响应头和处理函数返回的内容作为独立的段入队，发送时聚集写出，内容不复制
+        conn.output.append(httpResponse.buildHead(useChunked));
+        if (useChunked) {
+            std::ostringstream chunkSize;
+            chunkSize << std::hex << httpResponse.getContent().size() << "\r\n";
+            conn.output.append(chunkSize.str());
+            conn.output.append(httpResponse.takeContent());
+            conn.output.append(std::string("\r\n0\r\n\r\n"));  // 结束块
+        } else {
+            conn.output.append(httpResponse.takeContent());
+        }
+    } else {
+        HttpResponse httpResponse(HttpStatus::NOT_FOUND, 
+            "<html><body><h1>404 Not Found</h1></body></html>", "text/html");
+        addConnectionHeaders(conn, httpResponse);
+        
+        conn.output.append(HttpParser::buildResponse(httpResponse));
     }
     
+    finishResponse(conn);
+}
+
+void WebServer::sendStaticResponse(Connection& conn, StaticFileHandler::Result result) {
+    if (result.cached) {
+        // 缓存命中：响应头和内容都是现成的，直接引用缓存项中的两个缓冲区
+        const std::string& headers = result.cached->headers[conn.keepAlive ? 1 : 0];
+        const std::string& body = result.cached->body;
+        int keepAliveTimeout = connectionManager_->keepAliveLimits().timeoutSeconds;
+        if (conn.keepAlive && keepAliveTimeout != keepAliveTimeoutSeconds_) {
+            // 连接压力下保活超时已收缩，预先生成的响应头中的值需要替换
+            conn.output.append(withKeepAliveTimeout(headers, keepAliveTimeout));
+        } else {
+            conn.output.append(result.cached, headers.data(), headers.size());
+        }
+        conn.output.append(std::move(result.cached), body.data(), body.size());
+        finishResponse(conn);
+        return;
+    }
+
+    HttpResponse httpResponse(result.status, std::move(result.body), result.headers["Content-Type"]);
+    for (const auto& header : result.headers) {
+        httpResponse.setHeader(header.first, header.second);
+    }
+    addConnectionHeaders(conn, httpResponse);
+
+    // 文件内容作为文件段排在响应头之后，由sendfile发送
+    conn.output.append(HttpParser::buildResponse(httpResponse));
+    if (result.file && result.file->size > 0) {
+        auto size = static_cast<size_t>(result.file->size);
+        conn.output.appendFile(std::move(result.file), 0, size);
+    }
+    finishResponse(conn);
+}
+
+void WebServer::finishResponse(Connection& conn) {
+    conn.closeAfterWrite = !conn.keepAlive;
+    if (conn.batchingOutput && !conn.closeAfterWrite && conn.output.size() <= outputHighWatermark_) {
+        // 同一批中后面的请求还会产生响应，等这一批处理完再一起发送
+        return;
+    }
+
+    // 发送响应，未写完的部分留在输出队列等待可写事件
+    if (!flushOutput(conn)) {
+        closeConnection(conn);
+        return;
+    }
+    if (!hasPendingOutput(conn)) {
+        if (conn.closeAfterWrite) {
+            // 如果不保持连接，发送完毕后关闭
+            closeConnection(conn);
+        }
+        return;
+    }
+    if (conn.closeAfterWrite) {
+        conn.state = ConnectionState::WRITING;
+    } else if (conn.output.size() > outputHighWatermark_) {
+        // 客户端接收得比响应产生得慢：停止读取和处理后续请求，直到积压回落到低水位
+        conn.state = ConnectionState::WRITING;
+        pauseReading(conn);
+    }
+}
+
+void WebServer::resumeAfterWrite(Connection& conn) {
+    bool pending = hasPendingOutput(conn);
+    if (conn.closeAfterWrite) {
+        if (!pending) {
+            closeConnection(conn);
+        }
+        return;
+    }
+    if (pending && conn.output.size() > outputLowWatermark_) {
+        return;
+    }
+
+    conn.state = ConnectionState::READING;
+    if (conn.readPaused) {
+        conn.readPaused = false;
+        if (conn.ringSlot >= 0) {
+            if (!conn.recvArmed && !conn.peerClosed) {
+                armRecv(conn);
+            }
+        } else if (!readFromConnection(conn)) {
+            // 暂停期间到达的数据没有新的边缘触发，需要主动读取
+            closeConnection(conn);
+        }
+    }
+    if (conn.state == ConnectionState::READING) {
+        processRequests(conn);
+    }
+}
+
+void WebServer::pauseReading(Connection& conn) {
+    conn.readPaused = true;
+    conn.reactor->readPauses.fetch_add(1, std::memory_order_relaxed);
+    // epoll后端只需不再读取，数据留在套接字接收缓冲区中，由TCP窗口限制客户端；
+    // io_uring后端的多发recv会一直投递数据，需要取消
+    if (conn.ringSlot >= 0 && conn.recvArmed) {
+        Reactor& reactor = *conn.reactor;
+        if (io_uring_sqe* sqe = reactor.ring->getSqe()) {
+            auto slot = static_cast<uint32_t>(conn.ringSlot);
+            uint32_t generation = reactor.ringSlotGenerations[slot];
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = encodeUserData(RingOp::RECV, slot, generation);
+            sqe->user_data = encodeUserData(RingOp::CANCEL, slot, generation);
+        }
+    }
+}
+
+bool WebServer::fillFromFile(Connection& conn) {
+    int fd = -1;
+    off_t offset = 0;
+    size_t remaining = 0;
+    if (!conn.output.frontFile(fd, offset, remaining)) {
+        return true;
+    }
+    std::string chunk(std::min(remaining, kFileChunkSize), '\0');
+    conn.reactor->syscalls.fetch_add(1, std::memory_order_relaxed);
+    ssize_t bytesRead = pread(fd, &chunk[0], chunk.size(), offset);
+    if (bytesRead <= 0) {
+        // 文件在发送过程中被截断，已发出的Content-Length无法兑现，只能关闭连接
+        return false;
+    }
+    chunk.resize(static_cast<size_t>(bytesRead));
+    // 读入的部分从文件段中移除，作为内存段放回队首
+    conn.output.consume(chunk.size());
+    conn.output.prepend(std::move(chunk));
+    return true;
+}
+
+bool WebServer::flushOutput(Connection& conn) {
+    if (conn.ringSlot >= 0) {
+        return submitSend(conn);
+    }
+
+    bool result = writeOutput(conn);
+    // 每次flush只在结束时解除一次TCP_CORK，积攒的不满一个报文的尾部立即发出
+    if (conn.corked) {
+        setCork(conn, false);
+    }
+    return result;
+}
+
+void WebServer::setCork(Connection& conn, bool enabled) {
+    int value = enabled ? 1 : 0;
+    conn.reactor->syscalls.fetch_add(1, std::memory_order_relaxed);
+    if (setsockopt(conn.fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value)) == 0) {
+        conn.corked = enabled;
+    }
+}
+
+bool WebServer::useZeroCopy(Connection& conn, size_t bytes) const {
+    // 页面锁定和完成通知有固定开销，只有大块发送才值得；TLS在用户态加密，无法零拷贝
+    if (zeroCopyThreshold_ == 0 || bytes < zeroCopyThreshold_ || !conn.tcp || conn.ssl || conn.zeroCopyDisabled) {
+        return false;
+    }
+    if (!conn.zeroCopyEnabled) {
+        int opt = 1;
+        conn.reactor->syscalls.fetch_add(1, std::memory_order_relaxed);
+        if (setsockopt(conn.fd, SOL_SOCKET, SO_ZEROCOPY, &opt, sizeof(opt)) == -1) {
+            conn.zeroCopyDisabled = true;
+            return false;
+        }
+        conn.zeroCopyEnabled = true;
+    }
+    return true;
+}
+
+bool WebServer::reapZeroCopyCompletions(Connection& conn) {
+    Reactor& reactor = *conn.reactor;
+    while (true) {
+        char control[128];
+        struct msghdr message{};
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+        if (recvmsg(conn.fd, &message, MSG_ERRQUEUE) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;
+        }
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+                !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+                continue;
+            }
+            struct sock_extended_err error;
+            std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+            if (error.ee_origin != SO_EE_ORIGIN_ZEROCOPY || error.ee_errno != 0) {
+                return false;
+            }
+            // 通知覆盖[ee_info, ee_data]区间内的发送，序号是32位回绕计数
+            auto completed = conn.zeroCopyPending.begin();
+            while (completed != conn.zeroCopyPending.end() && static_cast<int32_t>(error.ee_data - completed->id) >= 0) {
+                ++completed;
+            }
+            reactor.zeroCopyCompletions.fetch_add(static_cast<uint64_t>(completed - conn.zeroCopyPending.begin()),
+                                                  std::memory_order_relaxed);
+            conn.zeroCopyPending.erase(conn.zeroCopyPending.begin(), completed);
+            if (error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                // 内核仍然复制了数据（如回环接口），零拷贝只剩额外开销，此连接之后改用普通发送
+                conn.zeroCopyDisabled = true;
+                reactor.zeroCopyCopied.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 错误队列读空后检查套接字本身是否出错
+    int socketError = 0;
+    socklen_t length = sizeof(socketError);
+    return getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &socketError, &length) == 0 && socketError == 0;
+}
+
+bool WebServer::writeOutput(Connection& conn) {
+    while (!conn.output.empty()) {
+        struct iovec iov[kMaxSendSegments];
+        bool more = false;
+        size_t count = conn.output.gather(iov, kMaxSendSegments, more);
+
+        // 需要多次写入、且MSG_MORE无法提示后续数据时先塞住套接字：TLS逐段写入，
+        // 或文件段之后还有数据（流水线的下一个响应），sendfile会立即推出文件的尾部报文。
+        // 单个响应的“响应头 + 文件”由sendmsg的MSG_MORE合并，不必多两次setsockopt
+        if (tcpCork_ && conn.tcp && !conn.corked &&
+            (conn.ssl ? count > 1 || more : more && conn.output.segmentCount() > count + 1)) {
+            setCork(conn, true);
+        }
+
+        if (count > 0 && conn.ssl) {
+            // TLS在用户态加密，逐段写入；重试时段的地址不变
+            const auto writeSize = static_cast<int>(std::min(iov[0].iov_len, static_cast<size_t>(INT_MAX)));
+            int written = SSL_write(conn.ssl, iov[0].iov_base, writeSize);
+            if (written <= 0) {
+                int error = SSL_get_error(conn.ssl, written);
+                return error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ;
+            }
+            conn.output.consume(static_cast<size_t>(written));
+            conn.phaseBytes += static_cast<uint64_t>(written);
+            continue;
+        }
+
+        if (count > 0) {
+            // 响应头、内容等内存段聚集成一次sendmsg
+            struct msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = count;
+            size_t bytes = 0;
+            for (size_t i = 0; i < count; ++i) {
+                bytes += iov[i].iov_len;
+            }
+            bool zeroCopy = useZeroCopy(conn, bytes);
+            // 后面还有数据（如文件内容）时用MSG_MORE让它们合并到同一个报文
+            int flags = MSG_NOSIGNAL | (more ? MSG_MORE : 0) | (zeroCopy ? MSG_ZEROCOPY : 0);
+            conn.reactor->syscalls.fetch_add(1, std::memory_order_relaxed);
+            ssize_t written = sendmsg(conn.fd, &message, flags);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (zeroCopy && errno == ENOBUFS) {
+                    // 锁定页面的配额（optmem）用尽，改为普通发送
+                    conn.zeroCopyDisabled = true;
+                    continue;
+                }
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            if (zeroCopy) {
+                // 内核直接引用这些内存段的页面，收到完成通知前继续持有它们
+                ZeroCopySend send;
+                send.id = conn.zeroCopyNext++;
+                conn.output.collectOwners(static_cast<size_t>(written), send.owners);
+                conn.zeroCopyPending.push_back(std::move(send));
+                conn.reactor->zeroCopySends.fetch_add(1, std::memory_order_relaxed);
+            }
+            conn.output.consume(static_cast<size_t>(written));
+            conn.phaseBytes += static_cast<uint64_t>(written);
+            continue;
+        }
+
+        if (conn.ssl) {
+            // TLS需要在用户态加密，文件内容只能先读入内存
+            if (!fillFromFile(conn)) {
+                return false;
+            }
+            continue;
+        }
+
+        // 文件内容由内核直接从页缓存发送到套接字
+        int fd = -1;
+        off_t offset = 0;
+        size_t remaining = 0;
+        conn.output.frontFile(fd, offset, remaining);
+        conn.reactor->syscalls.fetch_add(1, std::memory_order_relaxed);
+        ssize_t sent = sendfile(conn.fd, fd, &offset, std::min(remaining, kMaxSendfileChunk));
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (sent == 0) {
+            // 文件在发送过程中被截断
+            return false;
+        }
+        conn.output.consume(static_cast<size_t>(sent));
+        conn.phaseBytes += static_cast<uint64_t>(sent);
+    }
+    return true;
+}
+
+void WebServer::closeConnection(Connection& conn) {
+    if (conn.state == ConnectionState::CLOSED) {
+        return;
+    }
+    conn.state = ConnectionState::CLOSED;
+    unparkConnection(conn);
+
+    int socket = conn.fd;
+    Reactor& reactor = *conn.reactor;
+    reactor.timers.cancel(conn.timer);
+    if (conn.ringSlot >= 0) {
+        // io_uring连接：取消未完成的请求并异步关闭，所有请求完成后才释放下标和连接
+        connectionManager_->closeConnection(socket, false);
+        IoUring& ring = *reactor.ring;
+        auto slot = static_cast<uint32_t>(conn.ringSlot);
+        uint32_t generation = reactor.ringSlotGenerations[slot];
+        for (RingOp op : {RingOp::RECV, RingOp::SEND}) {
+            if ((op == RingOp::RECV && !conn.recvArmed) || (op == RingOp::SEND && !conn.sendInFlight)) {
+                continue;
+            }
+            if (io_uring_sqe* sqe = ring.getSqe()) {
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->addr = encodeUserData(op, slot, generation);
+                sqe->user_data = encodeUserData(RingOp::CANCEL, slot, generation);
+            }
+        }
+        if (io_uring_sqe* sqe = ring.getSqe()) {
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->file_index = slot + 1;
+            sqe->user_data = encodeUserData(RingOp::CLOSE_SLOT, slot, generation);
+            conn.pendingOps++;
+        } else {
+            ring.updateFile(slot, -1);
+        }
+        if (io_uring_sqe* sqe = ring.getSqe()) {
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = socket;
+            sqe->user_data = encodeUserData(RingOp::CLOSE_FD, slot, generation);
+        } else {
+            close(socket);
+        }
+
+        auto it = reactor.connections.find(socket);
+        if (it != reactor.connections.end()) {
+            reactor.drainingConnections[it->second.get()] = std::move(it->second);
+            reactor.connections.erase(it);
+        }
+        if (conn.pendingOps == 0) {
+            releaseRingConnection(conn);
+        }
+        return;
+    }
+
+    reactor.loop->removeFd(socket);
+
     // 关闭连接
-    if (ssl) {
-        SSL_shutdown(ssl);
-        SSL_free(ssl);
+    if (conn.ssl) {
+        SSL_shutdown(conn.ssl);
+        SSL_free(conn.ssl);
+        conn.ssl = nullptr;
+    }
+
+    if (!conn.zeroCopyPending.empty()) {
+        reapZeroCopyCompletions(conn);
+    }
+    if (!conn.zeroCopyPending.empty()) {
+        lingerForZeroCopy(conn);
+        return;
+    }
+
+    // 由ConnectionManager关闭套接字并更新统计
+    reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+    connectionManager_->closeConnection(socket);
+
+    // 调用栈上层可能仍持有conn的引用，推迟到本轮事件处理结束后再释放
+    auto it = reactor.connections.find(socket);
+    if (it != reactor.connections.end()) {
+        retireConnection(reactor, std::move(it->second));
+        reactor.connections.erase(it);
+    }
+}
+
+void WebServer::lingerForZeroCopy(Connection& conn) {
+    Reactor& reactor = *conn.reactor;
+    int socket = conn.fd;
+    // 内核仍引用零拷贝发送的页面，关闭套接字后就收不到完成通知，无从得知何时可以释放缓冲区。
+    // 连接不再计入连接数，只关闭写方向：内核发完剩余数据后发送FIN，客户端照常看到连接结束
+    connectionManager_->closeConnection(socket, false);
+    reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+    shutdown(socket, SHUT_WR);
+
+    Connection* connPtr = &conn;
+    reactor.loop->addFd(socket, EPOLLET, [this, connPtr](uint32_t) {
+        if (!reapZeroCopyCompletions(*connPtr) || connPtr->zeroCopyPending.empty()) {
+            releaseLingeringConnection(*connPtr, false);
+        }
+    });
+    reactor.timers.schedule(conn.timer, currentTick(reactor) + drainTimeoutTicks_);
+
+    auto it = reactor.connections.find(socket);
+    if (it != reactor.connections.end()) {
+        reactor.drainingConnections[it->second.get()] = std::move(it->second);
+        reactor.connections.erase(it);
+    }
+}
+
+void WebServer::releaseLingeringConnection(Connection& conn, bool abort) {
+    Reactor& reactor = *conn.reactor;
+    reactor.timers.cancel(conn.timer);
+    reactor.loop->removeFd(conn.fd);
+    if (abort) {
+        struct linger option{1, 0};
+        setsockopt(conn.fd, SOL_SOCKET, SO_LINGER, &option, sizeof(option));
+    }
+    reactor.syscalls.fetch_add(1, std::memory_order_relaxed);
+    close(conn.fd);
+
+    auto it = reactor.drainingConnections.find(&conn);
+    if (it != reactor.drainingConnections.end()) {
+        retireConnection(reactor, std::move(it->second));
+        reactor.drainingConnections.erase(it);
+    }
+}
+
+Connection* WebServer::findConnection(Reactor& reactor, int socket, uint64_t id) {
+    auto it = reactor.connections.find(socket);
+    if (it == reactor.connections.end() || it->second->id != id) {
+        return nullptr;
     }
-    close(clientSocket);
+    return it->second.get();
 }
 
-} // namespace webserver
\ No newline at end of file
+} // namespace webserver
@@ -0,0 +1,229 @@
+#include "http/HttpHeaders.hpp"
+
+namespace webserver {
+
+namespace {
+
+// 下标与HttpHeader枚举值一一对应
+constexpr std::string_view kHeaderNames[] = {
+    "",
+    "Accept",
+    "Accept-Charset",
+    "Accept-Encoding",
+    "Accept-Language",
+    "Allow",
+    "Authorization",
+    "Cache-Control",
+    "Connection",
+    "Content-Encoding",
+    "Content-Language",
+    "Content-Length",
+    "Content-Type",
+    "Cookie",
+    "Date",
+    "ETag",
+    "Expect",
+    "Host",
+    "If-Match",
+    "If-Modified-Since",
+    "If-None-Match",
+    "If-Unmodified-Since",
+    "Keep-Alive",
+    "Last-Modified",
+    "Location",
+    "Range",
+    "Referer",
+    "Server",
+    "Set-Cookie",
+    "TE",
+    "Transfer-Encoding",
+    "Upgrade",
+    "User-Agent",
+    "Vary"
+};
+constexpr size_t kHeaderCount = sizeof(kHeaderNames) / sizeof(kHeaderNames[0]);
+static_assert(kHeaderCount == static_cast<size_t>(HttpHeader::COUNT), "kHeaderNames must match HttpHeader");
+
+constexpr char toLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// 完美哈希：只取长度、首字符、中间字符和末字符，不区分大小写
+constexpr unsigned kHashBits = 7;
+constexpr size_t kHashSize = size_t{1} << kHashBits;
+
+constexpr uint32_t hashName(std::string_view name, uint32_t seed) {
+    uint32_t hash = static_cast<uint32_t>(name.size()) * seed;
+    hash = (hash ^ static_cast<unsigned char>(toLower(name[0]))) * seed;
+    hash = (hash ^ static_cast<unsigned char>(toLower(name[name.size() / 2]))) * seed;
+    hash = (hash ^ static_cast<unsigned char>(toLower(name[name.size() - 1]))) * seed;
+    return hash >> (32 - kHashBits);
+}
+
+constexpr bool isCollisionFree(uint32_t seed) {
+    bool used[kHashSize] = {};
+    for (size_t i = 1; i < kHeaderCount; ++i) {
+        uint32_t slot = hashName(kHeaderNames[i], seed);
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+// 编译期搜索一个让所有常用头部落在不同槽位的种子
+constexpr uint32_t findSeed() {
+    for (uint32_t seed = 0x9e3779b1u; seed < 0x9e3779b1u + 2000000u; seed += 2) {
+        if (isCollisionFree(seed)) {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+constexpr uint32_t kHashSeed = findSeed();
+static_assert(kHashSeed != 0, "no collision-free seed for the header hash");
+
+struct HashTable {
+    HttpHeader slots[kHashSize];
+};
+
+constexpr HashTable makeHashTable() {
+    HashTable table{};
+    for (size_t i = 1; i < kHeaderCount; ++i) {
+        table.slots[hashName(kHeaderNames[i], kHashSeed)] = static_cast<HttpHeader>(i);
+    }
+    return table;
+}
+
+constexpr HashTable kHashTable = makeHashTable();
+
+const std::string kEmpty;
+
+} // namespace
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toLower(a[i]) != toLower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+HttpHeader lookupHttpHeader(std::string_view name) {
+    if (name.empty()) {
+        return HttpHeader::UNKNOWN;
+    }
+    HttpHeader candidate = kHashTable.slots[hashName(name, kHashSeed)];
+    if (candidate != HttpHeader::UNKNOWN && equalsIgnoreCase(kHeaderNames[static_cast<size_t>(candidate)], name)) {
+        return candidate;
+    }
+    return HttpHeader::UNKNOWN;
+}
+
+std::string_view httpHeaderName(HttpHeader header) {
+    size_t index = static_cast<size_t>(header);
+    return index < kHeaderCount ? kHeaderNames[index] : std::string_view();
+}
+
+void HttpHeaders::add(std::string name, std::string value) {
+    HttpHeader id = lookupHttpHeader(name);
+    if (id != HttpHeader::UNKNOWN && index_[static_cast<size_t>(id)] == 0) {
+        index_[static_cast<size_t>(id)] = static_cast<uint32_t>(entries_.size() + 1);
+    }
+    entries_.push_back({std::move(name), std::move(value), id});
+}
+
+void HttpHeaders::set(std::string_view name, std::string value) {
+    HttpHeader id = lookupHttpHeader(name);
+    size_t first = position(name, id);
+    if (first == entries_.size()) {
+        add(std::string(name), std::move(value));
+        return;
+    }
+    entries_[first].value = std::move(value);
+
+    // 删除后面的同名头部，通常不存在
+    bool removed = false;
+    for (size_t i = entries_.size() - 1; i > first; --i) {
+        if (entries_[i].id == id && (id != HttpHeader::UNKNOWN || equalsIgnoreCase(entries_[i].name, name))) {
+            entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(i));
+            removed = true;
+        }
+    }
+    if (removed) {
+        reindex();
+    }
+}
+
+size_t HttpHeaders::position(std::string_view name, HttpHeader id) const {
+    if (id != HttpHeader::UNKNOWN) {
+        uint32_t index = index_[static_cast<size_t>(id)];
+        return index == 0 ? entries_.size() : index - 1;
+    }
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].id == HttpHeader::UNKNOWN && equalsIgnoreCase(entries_[i].name, name)) {
+            return i;
+        }
+    }
+    return entries_.size();
+}
+
+const std::string* HttpHeaders::find(std::string_view name) const {
+    size_t index = position(name, lookupHttpHeader(name));
+    return index < entries_.size() ? &entries_[index].value : nullptr;
+}
+
+const std::string* HttpHeaders::find(HttpHeader header) const {
+    if (header == HttpHeader::UNKNOWN || header >= HttpHeader::COUNT) {
+        return nullptr;
+    }
+    uint32_t index = index_[static_cast<size_t>(header)];
+    return index == 0 ? nullptr : &entries_[index - 1].value;
+}
+
+const std::string& HttpHeaders::get(std::string_view name) const {
+    const std::string* value = find(name);
+    return value ? *value : kEmpty;
+}
+
+const std::string& HttpHeaders::get(HttpHeader header) const {
+    const std::string* value = find(header);
+    return value ? *value : kEmpty;
+}
+
+size_t HttpHeaders::erase(std::string_view name) {
+    HttpHeader id = lookupHttpHeader(name);
+    size_t before = entries_.size();
+    for (size_t i = entries_.size(); i-- > 0;) {
+        if (entries_[i].id == id && (id != HttpHeader::UNKNOWN || equalsIgnoreCase(entries_[i].name, name))) {
+            entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+    if (entries_.size() != before) {
+        reindex();
+    }
+    return before - entries_.size();
+}
+
+void HttpHeaders::clear() {
+    entries_.clear();
+    index_.fill(0);
+}
+
+void HttpHeaders::reindex() {
+    index_.fill(0);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        size_t id = static_cast<size_t>(entries_[i].id);
+        if (entries_[i].id != HttpHeader::UNKNOWN && index_[id] == 0) {
+            index_[id] = static_cast<uint32_t>(i + 1);
+        }
+    }
+}
+
+} // namespace webserver
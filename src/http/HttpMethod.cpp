@@ -0,0 +1,49 @@
+#include "http/HttpMethod.hpp"
+
+namespace webserver {
+
+HttpMethod parseHttpMethod(std::string_view name) {
+    // 先按长度分组，每组最多比较三次
+    switch (name.size()) {
+        case 3:
+            if (name == "GET") return HttpMethod::GET;
+            if (name == "PUT") return HttpMethod::PUT;
+            break;
+        case 4:
+            if (name == "POST") return HttpMethod::POST;
+            if (name == "HEAD") return HttpMethod::HEAD;
+            break;
+        case 5:
+            if (name == "PATCH") return HttpMethod::PATCH;
+            if (name == "TRACE") return HttpMethod::TRACE;
+            break;
+        case 6:
+            if (name == "DELETE") return HttpMethod::DELETE;
+            break;
+        case 7:
+            if (name == "OPTIONS") return HttpMethod::OPTIONS;
+            if (name == "CONNECT") return HttpMethod::CONNECT;
+            break;
+        default:
+            break;
+    }
+    return HttpMethod::UNKNOWN;
+}
+
+std::string_view httpMethodName(HttpMethod method) {
+    switch (method) {
+        case HttpMethod::GET: return "GET";
+        case HttpMethod::HEAD: return "HEAD";
+        case HttpMethod::POST: return "POST";
+        case HttpMethod::PUT: return "PUT";
+        case HttpMethod::DELETE: return "DELETE";
+        case HttpMethod::OPTIONS: return "OPTIONS";
+        case HttpMethod::PATCH: return "PATCH";
+        case HttpMethod::TRACE: return "TRACE";
+        case HttpMethod::CONNECT: return "CONNECT";
+        case HttpMethod::UNKNOWN: break;
+    }
+    return {};
+}
+
+} // namespace webserver
@@ -10,21 +10,37 @@ HttpRequest::HttpRequest(const std::string& method,
                          const std::map<std::string, std::string>& headers,
                          const std::string& body,
                          const std::map<std::string, std::string>& queryParams)
-    : method_(method), path_(path), headers_(headers), 
-      body_(body), queryParams_(queryParams) {
+    : method_(method), path_(path), body_(body), queryParams_(queryParams) {
     // 确保方法名大写
     std::transform(method_.begin(), method_.end(), method_.begin(), ::toupper);
+    methodType_ = parseHttpMethod(method_);
+    setHeaders(headers);
+}
+
+HttpRequest::HttpRequest(const std::string& method,
+                         const std::string& path,
+                         HttpHeaders headers,
+                         const std::string& body,
+                         const std::map<std::string, std::string>& queryParams)
+    : method_(method), path_(path), headers_(std::move(headers)),
+      body_(body), queryParams_(queryParams) {
+    std::transform(method_.begin(), method_.end(), method_.begin(), ::toupper);
+    methodType_ = parseHttpMethod(method_);
 }
 
 const std::string& HttpRequest::getMethod() const {
     return method_;
 }
 
+HttpMethod HttpRequest::getMethodType() const {
+    return methodType_;
+}
+
 const std::string& HttpRequest::getPath() const {
     return path_;
 }
 
-const std::map<std::string, std::string>& HttpRequest::getHeaders() const {
+const HttpHeaders& HttpRequest::getHeaders() const {
     return headers_;
 }
 
@@ -36,9 +52,12 @@ const std::map<std::string, std::string>& HttpRequest::getQueryParams() const {
     return queryParams_;
 }
 
-std::string HttpRequest::getHeader(const std::string& name) const {
-    auto it = headers_.find(name);
-    return it != headers_.end() ? it->second : "";
+const std::string& HttpRequest::getHeader(std::string_view name) const {
+    return headers_.get(name);
+}
+
+const std::string& HttpRequest::getHeader(HttpHeader header) const {
+    return headers_.get(header);
 }
 
 std::string HttpRequest::getQueryParam(const std::string& name) const {
@@ -47,7 +66,7 @@ std::string HttpRequest::getQueryParam(const std::string& name) const {
 }
 
 bool HttpRequest::checkIfModifiedSince(time_t lastModified) const {
-    std::string ifModifiedSince = getHeader("If-Modified-Since");
+    std::string ifModifiedSince = getHeader(HttpHeader::IF_MODIFIED_SINCE);
     if (ifModifiedSince.empty()) return false;
     
     time_t headerTime = DateTimeUtils::parseHttpDate(ifModifiedSince);
@@ -57,7 +76,7 @@ bool HttpRequest::checkIfModifiedSince(time_t lastModified) const {
 }
 
 bool HttpRequest::checkIfUnmodifiedSince(time_t lastModified) const {
-    std::string ifUnmodifiedSince = getHeader("If-Unmodified-Since");
+    std::string ifUnmodifiedSince = getHeader(HttpHeader::IF_UNMODIFIED_SINCE);
     if (ifUnmodifiedSince.empty()) return false;
     
     time_t headerTime = DateTimeUtils::parseHttpDate(ifUnmodifiedSince);
@@ -67,7 +86,7 @@ bool HttpRequest::checkIfUnmodifiedSince(time_t lastModified) const {
 }
 
 bool HttpRequest::checkIfNoneMatch(const std::string& etag) const {
-    std::string ifNoneMatch = getHeader("If-None-Match");
+    std::string ifNoneMatch = getHeader(HttpHeader::IF_NONE_MATCH);
     if (ifNoneMatch.empty()) return false;
     
     // 处理通配符*
@@ -92,7 +111,7 @@ bool HttpRequest::checkIfNoneMatch(const std::string& etag) const {
 }
 
 bool HttpRequest::checkIfMatch(const std::string& etag) const {
-    std::string ifMatch = getHeader("If-Match");
+    std::string ifMatch = getHeader(HttpHeader::IF_MATCH);
     if (ifMatch.empty()) return false;
     
     // 处理通配符*
@@ -117,7 +136,15 @@ bool HttpRequest::checkIfMatch(const std::string& etag) const {
 }
 
 void HttpRequest::setHeaders(const std::map<std::string, std::string>& headers) {
-    headers_ = headers;
+    headers_.clear();
+    headers_.reserve(headers.size());
+    for (const auto& header : headers) {
+        headers_.add(header.first, header.second);
+    }
+}
+
+void HttpRequest::setHeaders(HttpHeaders headers) {
+    headers_ = std::move(headers);
 }
 
 void HttpRequest::setBody(const std::string& body) {
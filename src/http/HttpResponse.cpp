@@ -6,53 +6,78 @@
 namespace webserver {
 
 HttpResponse::HttpResponse(HttpStatus statusCode,
-                           const std::string& content,
+                           std::string content,
                            const std::string& contentType)
-    : statusCode_(statusCode), content_(content) {
-    setHeader("Content-Type", contentType);
-    setHeader("Content-Length", std::to_string(content.size()));
+    : statusCode_(statusCode), content_(std::move(content)) {
+    headers_.reserve(8);
+    headers_.add("Content-Type", contentType);
+    headers_.add("Content-Length", std::to_string(content_.size()));
 }
 
-void HttpResponse::setHeader(const std::string& name, const std::string& value) {
-    headers_[name] = value;
+void HttpResponse::setHeader(std::string_view name, std::string value) {
+    headers_.set(name, std::move(value));
 }
 
-std::string HttpResponse::getHeader(const std::string& name) const {
-    auto it = headers_.find(name);
-    return it != headers_.end() ? it->second : "";
+const std::string& HttpResponse::getHeader(std::string_view name) const {
+    return headers_.get(name);
+}
+
+const std::string& HttpResponse::getHeader(HttpHeader header) const {
+    return headers_.get(header);
 }
 
 std::string HttpResponse::build() const {
-    std::ostringstream response;
-    response << "HTTP/1.1 " << static_cast<int>(statusCode_) 
-                           << " " << HttpStatusHandler::getInstance().getStatusMessage(statusCode_) << "\r\n";
+    std::string response = buildHead();
+    response += content_;
+    return response;
+}
 
+std::string HttpResponse::buildHead(bool chunked) const {
+    std::string statusMessage = HttpStatusHandler::getInstance().getStatusMessage(statusCode_);
+    size_t length = 32 + statusMessage.size();
     for (const auto& header : headers_) {
-        response << header.first << ": " << header.second << "\r\n";
+        length += header.name.size() + header.value.size() + 4;
     }
-    response << "\r\n" << content_;
-
-    return response.str();
-}
-
-std::string HttpResponse::buildChunked() const {
-    std::ostringstream response;
-    response << "HTTP/1.1 " << static_cast<int>(statusCode_) 
-                           << " " << HttpStatusHandler::getInstance().getStatusMessage(statusCode_) << "\r\n";
 
+    // 先算出总长度一次分配，避免经过ostringstream再复制一遍
+    std::string head;
+    head.reserve(length);
+    head += "HTTP/1.1 ";
+    head += std::to_string(static_cast<int>(statusCode_));
+    head += ' ';
+    head += statusMessage;
+    head += "\r\n";
     for (const auto& header : headers_) {
-        if (header.first != "Content-Length") {  // 分块传输不需要Content-Length
-            response << header.first << ": " << header.second << "\r\n";
+        if (chunked && header.id == HttpHeader::CONTENT_LENGTH) {  // 分块传输不需要Content-Length
+            continue;
         }
+        head += header.name;
+        head += ": ";
+        head += header.value;
+        head += "\r\n";
+    }
+    if (chunked) {
+        head += "Transfer-Encoding: chunked\r\n";
     }
-    response << "Transfer-Encoding: chunked\r\n\r\n";
+    head += "\r\n";
+    return head;
+}
 
-    // 添加分块数据
-    std::stringstream chunk;
-    chunk << std::hex << content_.size() << "\r\n" << content_ << "\r\n";
-    response << chunk.str() << "0\r\n\r\n";  // 结束块
+std::string HttpResponse::takeContent() {
+    std::string content = std::move(content_);
+    content_.clear();
+    return content;
+}
 
-    return response.str();
+std::string HttpResponse::buildChunked() const {
+    std::ostringstream chunk;
+    chunk << std::hex << content_.size() << "\r\n";
+
+    std::string response = buildHead(true);
+    response += chunk.str();
+    response += content_;
+    response += "\r\n0\r\n\r\n";  // 结束块
+    return response;
 }
 
 HttpStatus HttpResponse::getStatusCode() const {
@@ -63,7 +88,7 @@ const std::string& HttpResponse::getContent() const {
     return content_;
 }
 
-const std::map<std::string, std::string>& HttpResponse::getHeaders() const {
+const HttpHeaders& HttpResponse::getHeaders() const {
     return headers_;
 }
 
@@ -1,126 +1,314 @@
 #include "http/HttpServer.hpp"
 #include "http/PipelinedConnectionHandler.hpp"
-#include <sys/socket.h>
+#include "Logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <exception>
 #include <netinet/in.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <thread>
+#include <netinet/tcp.h>
 #include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace webserver {
+
+namespace {
+constexpr uint64_t kListenerId = 0;
+constexpr uint64_t kWakeId = 1;
+constexpr size_t kQueueCapacity = 256;
+constexpr int kMaxEvents = 128;
+
+void signalEventFd(int fd) {
+    uint64_t one = 1;
+    while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+}
+}
 
-HttpServer::HttpServer(int port) : port(port), running(false) {}
+HttpServer::HttpServer(int port, Handler handler, size_t processors, int backlog)
+    : port_(port), handler_(std::move(handler)), processorCount_(processors > 0 ? processors : 1), backlog_(backlog) {}
 
 HttpServer::~HttpServer() {
     stop();
 }
 
 void HttpServer::start() {
-    if (running) return;
-    
-    // 创建socket
-    serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (serverSocket < 0) {
+    if (running_) return;
+
+    serverSocket_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (serverSocket_ < 0) {
         throw std::runtime_error("Failed to create socket");
     }
-    
-    // 设置socket选项
+
     int opt = 1;
-    setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    
-    // 绑定端口
+    setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    // 由接受的连接继承：一批响应合并为一次send后立即发出，不等待上一个报文的延迟ACK
+    setsockopt(serverSocket_, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
     sockaddr_in serverAddr{};
     serverAddr.sin_family = AF_INET;
     serverAddr.sin_addr.s_addr = INADDR_ANY;
-    serverAddr.sin_port = htons(port);
-    
-    if (bind(serverSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+    serverAddr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (bind(serverSocket_, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) < 0) {
+        cleanup();
         throw std::runtime_error("Failed to bind port");
     }
-    
-    // 开始监听
-    if (listen(serverSocket, 10) < 0) {
+    if (listen(serverSocket_, backlog_) < 0) {
+        cleanup();
         throw std::runtime_error("Failed to listen on socket");
     }
-    
-    running = true;
-    serverThread = std::thread(&HttpServer::run, this);
+    socklen_t addrLen = sizeof(serverAddr);
+    if (getsockname(serverSocket_, reinterpret_cast<sockaddr*>(&serverAddr), &addrLen) == 0) {
+        port_ = ntohs(serverAddr.sin_port);
+    }
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+        cleanup();
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kListenerId;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, serverSocket_, &event);
+    event.data.u64 = kWakeId;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+
+    running_ = true;
+    for (size_t i = 0; i < processorCount_; ++i) {
+        auto processor = std::make_unique<Processor>(kQueueCapacity);
+        // 处理线程阻塞读取eventfd，没有请求时不占用CPU
+        processor->wakeFd = eventfd(0, EFD_CLOEXEC);
+        if (processor->wakeFd < 0) {
+            running_ = false;
+            cleanup();
+            throw std::runtime_error("Failed to create eventfd");
+        }
+        Processor* raw = processor.get();
+        processor->thread = std::thread(&HttpServer::process, this, std::ref(*raw));
+        processors_.push_back(std::move(processor));
+    }
+    serverThread_ = std::thread(&HttpServer::run, this);
 }
 
 void HttpServer::stop() {
-    if (!running) return;
-    
-    running = false;
-    close(serverSocket);
-    
-    if (serverThread.joinable()) {
-        serverThread.join();
+    if (!running_.exchange(false)) return;
+
+    signalEventFd(wakeFd_);
+    if (serverThread_.joinable()) {
+        serverThread_.join();
+    }
+    cleanup();
+}
+
+void HttpServer::cleanup() {
+    for (auto& processor : processors_) {
+        if (processor->thread.joinable()) {
+            signalEventFd(processor->wakeFd);
+            processor->thread.join();
+        }
+        if (processor->wakeFd >= 0) {
+            close(processor->wakeFd);
+        }
+    }
+    processors_.clear();
+    connections_.clear();
+    blocked_.clear();
+    connectionCount_ = 0;
+    for (int* fd : {&serverSocket_, &epollFd_, &wakeFd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
     }
 }
 
 void HttpServer::run() {
-    while (running) {
-        sockaddr_in clientAddr{};
-        socklen_t clientLen = sizeof(clientAddr);
-        
-        int clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &clientLen);
+    epoll_event events[kMaxEvents];
+    while (running_) {
+        int count = epoll_wait(epollFd_, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("epoll_wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+
+        for (int i = 0; i < count && running_; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == kListenerId) {
+                acceptConnections();
+                continue;
+            }
+            if (id == kWakeId) {
+                uint64_t value;
+                while (read(wakeFd_, &value, sizeof(value)) < 0 && errno == EINTR) {
+                }
+                collectResults();
+                continue;
+            }
+
+            auto it = connections_.find(id);
+            if (it == connections_.end()) {
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                it->second->onReadable();
+            }
+            if (events[i].events & EPOLLOUT) {
+                it->second->onWritable();
+            }
+            closeIfFinished(id);
+        }
+
+        // 本轮派发的请求只通知一次处理线程，批量请求只需一次eventfd写入
+        for (auto& processor : processors_) {
+            if (processor->needsWake) {
+                processor->needsWake = false;
+                signalEventFd(processor->wakeFd);
+            }
+        }
+    }
+}
+
+void HttpServer::acceptConnections() {
+    while (true) {
+        int clientSocket = accept4(serverSocket_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (clientSocket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
             if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                // 严重错误，停止服务器
-                running = false;
-                break;
+                LOG_ERROR("Failed to accept connection: " + std::string(strerror(errno)));
             }
+            return;
+        }
+
+        uint64_t id = nextConnectionId_++;
+        auto handler = std::make_unique<PipelinedConnectionHandler>(
+            clientSocket,
+            [this, id](uint64_t sequence, std::unique_ptr<HttpRequest>& request, bool keepAlive) {
+                if (dispatch(id, sequence, request, keepAlive)) {
+                    return true;
+                }
+                blocked_.push_back(id);
+                return false;
+            },
+            limits_);
+
+        // 边缘触发：加入时已有的数据也会产生一次事件
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.u64 = id;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, clientSocket, &event) < 0) {
+            LOG_ERROR("Failed to add connection to epoll: " + std::string(strerror(errno)));
+            continue;
+        }
+        connections_.emplace(id, std::move(handler));
+        connectionCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool HttpServer::dispatch(uint64_t connection, uint64_t sequence, std::unique_ptr<HttpRequest>& request,
+                          bool keepAlive) {
+    // 每个处理线程在途的请求不超过队列容量，因此响应队列永远不会满
+    for (size_t tried = 0; tried < processors_.size(); ++tried) {
+        Processor& processor = *processors_[nextProcessor_];
+        nextProcessor_ = (nextProcessor_ + 1) % processors_.size();
+        if (processor.inFlight >= processor.jobs.capacity()) {
             continue;
         }
-        
-        // 处理连接
-        std::thread(&HttpServer::handleConnection, this, clientSocket).detach();
+        Job job{connection, sequence, std::move(request), keepAlive};
+        if (!processor.jobs.tryPush(job)) {
+            request = std::move(job.request);
+            continue;
+        }
+        processor.inFlight++;
+        processor.needsWake = true;
+        return true;
     }
+    return false;
 }
 
-void HttpServer::handleConnection(int clientSocket) {
-    // 设置socket为非阻塞
-    int flags = fcntl(clientSocket, F_GETFL, 0);
-    fcntl(clientSocket, F_SETFL, flags | O_NONBLOCK);
-    
-    // 检查客户端是否支持管道化 (HTTP/1.1默认支持)
-    bool pipeliningSupported = true;
-    
-    if (pipeliningSupported) {
-        // 使用管道化处理器
-        PipelinedConnectionHandler handler(clientSocket);
-        handler.start();
-        
-        // 等待处理完成或超时
-        std::this_thread::sleep_for(std::chrono::seconds(30));
-        handler.stop();
-    } else {
-        // 传统单请求处理
-        char buffer[8192];
-        HttpParser parser;
-        HttpProcessor processor;
-        
-        while (true) {
-            ssize_t bytesRead = recv(clientSocket, buffer, sizeof(buffer), 0);
-            
-            if (bytesRead <= 0) {
-                if (bytesRead == 0) {
-                    // 客户端关闭连接
-                    break;
-                } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                    // 读取错误
-                    break;
+void HttpServer::process(Processor& processor) {
+    while (true) {
+        uint64_t value;
+        if (read(processor.wakeFd, &value, sizeof(value)) < 0 && errno == EINTR) {
+            continue;
+        }
+        if (!running_) {
+            return;
+        }
+
+        Job job;
+        while (processor.jobs.tryPop(job)) {
+            Result result{job.connection, job.sequence, {}};
+            try {
+                HttpResponse response = handler_(*job.request);
+                // 是否保持连接由连接按令牌列表和协议版本判断，不保持时告知客户端
+                if (!job.keepAlive) {
+                    response.setHeader("Connection", "close");
                 }
-                continue;
+                result.response = response.build();
+            } catch (const std::exception& e) {
+                LOG_ERROR("Request handler failed: " + std::string(e.what()));
+                HttpResponse response(HttpStatus::INTERNAL_SERVER_ERROR, "", "text/plain");
+                if (!job.keepAlive) {
+                    response.setHeader("Connection", "close");
+                }
+                result.response = response.build();
             }
-            
-            // 解析并处理请求
-            std::vector<HttpRequest> requests = parser.parse(buffer, bytesRead);
-            for (auto& request : requests) {
-                HttpResponse response = processor.process(request);
-                std::string responseStr = response.toString();
-                send(clientSocket, responseStr.c_str(), responseStr.size(), 0);
+            job.request.reset();
+            processor.results.tryPush(result);
+            // 每个响应完成后立即通知，前面的请求不必等待同一批中后面较慢的请求
+            signalEventFd(wakeFd_);
+        }
+    }
+}
+
+void HttpServer::collectResults() {
+    std::vector<uint64_t> touched;
+    for (auto& processor : processors_) {
+        Result result;
+        while (processor->results.tryPop(result)) {
+            processor->inFlight--;
+            auto it = connections_.find(result.connection);
+            if (it == connections_.end()) {
+                // 连接已经关闭，丢弃迟到的响应
+                continue;
             }
+            it->second->onResponse(result.sequence, std::move(result.response));
+            touched.push_back(result.connection);
         }
-        
-        close(clientSocket);
     }
-}
\ No newline at end of file
+
+    // 处理线程有了空位，继续派发被暂停的连接
+    std::vector<uint64_t> blocked;
+    blocked.swap(blocked_);
+    for (uint64_t id : blocked) {
+        auto it = connections_.find(id);
+        if (it != connections_.end()) {
+            it->second->resume();
+            touched.push_back(id);
+        }
+    }
+
+    for (uint64_t id : touched) {
+        closeIfFinished(id);
+    }
+}
+
+void HttpServer::closeIfFinished(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end() || !it->second->finished()) {
+        return;
+    }
+    // 关闭套接字时内核自动把它从epoll中移除
+    connections_.erase(it);
+    connectionCount_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace webserver
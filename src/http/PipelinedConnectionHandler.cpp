@@ -1,118 +1,189 @@
 #include "http/PipelinedConnectionHandler.hpp"
-#include "http/HttpParser.hpp"
-#include "http/HttpProcessor.hpp"
-#include <unistd.h>
+#include "http/HttpResponse.hpp"
+#include "Logger.hpp"
+#include <cerrno>
+#include <cstring>
 #include <sys/socket.h>
-#include <stdexcept>
+#include <unistd.h>
+#include <utility>
 
-PipelinedConnectionHandler::PipelinedConnectionHandler(int socket) 
-    : clientSocket(socket), running(false) {}
+namespace webserver {
 
-PipelinedConnectionHandler::~PipelinedConnectionHandler() {
-    stop();
-}
+namespace {
+constexpr size_t kReadChunkSize = 16384;
+constexpr size_t kMaxBlockedInput = 1024 * 1024;  // 暂停派发时最多缓存的未处理数据
+constexpr size_t kMaxOutputBacklog = 1024 * 1024; // 客户端不读取时最多积压的响应数据
 
-void PipelinedConnectionHandler::start() {
-    if (running) return;
-    
-    running = true;
-    requestThread = std::thread(&PipelinedConnectionHandler::requestProcessingThread, this);
-    responseThread = std::thread(&PipelinedConnectionHandler::responseProcessingThread, this);
+// 请求非法时返回的响应，发送后关闭连接
+std::string buildErrorResponse(HttpStatus status) {
+    HttpResponse response(status, "", "text/plain");
+    response.setHeader("Connection", "close");
+    return response.build();
+}
 }
 
-void PipelinedConnectionHandler::stop() {
-    if (!running) return;
-    
-    running = false;
-    
-    // 通知所有等待的线程
-    requestCV.notify_all();
-    responseCV.notify_all();
-    
-    // 等待线程结束
-    if (requestThread.joinable()) requestThread.join();
-    if (responseThread.joinable()) responseThread.join();
-    
-    close(clientSocket);
+PipelinedConnectionHandler::PipelinedConnectionHandler(int socket, Dispatcher dispatcher,
+                                                       const HttpRequestParser::Limits& limits)
+    : socket_(socket), dispatcher_(std::move(dispatcher)), parser_(limits) {}
+
+PipelinedConnectionHandler::~PipelinedConnectionHandler() {
+    close(socket_);
 }
 
-void PipelinedConnectionHandler::requestProcessingThread() {
-    HttpParser parser;
-    char buffer[8192];
-    
-    while (running) {
-        ssize_t bytesRead = recv(clientSocket, buffer, sizeof(buffer), 0);
-        
-        if (bytesRead <= 0) {
-            if (bytesRead == 0) {
-                // 客户端关闭连接
-                running = false;
-                break;
-            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                // 读取错误
-                running = false;
-                break;
-            }
+void PipelinedConnectionHandler::onReadable() {
+    // 边缘触发：必须读到EAGAIN，否则剩余数据不会再产生事件；
+    // 暂停派发时缓存的数据达到上限就停止读取，让TCP窗口对客户端形成背压，由resume()继续读取；
+    // 客户端不读取响应时同样停止读取，由resumeIfDrained()在积压回落后继续
+    while (!peerClosed_ && !failed_ && !(blocked_ && input_.size() >= kMaxBlockedInput)) {
+        if (outputBacklog() >= kMaxOutputBacklog) {
+            outputPaused_ = true;
+            break;
+        }
+        size_t oldSize = input_.size();
+        input_.resize(oldSize + kReadChunkSize);
+        ssize_t bytesRead = recv(socket_, &input_[oldSize], kReadChunkSize, 0);
+        input_.resize(oldSize + (bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0));
+        if (bytesRead > 0) {
             continue;
         }
-        
-        // 解析请求
-        std::vector<HttpRequest> requests = parser.parse(buffer, bytesRead);
-        
-        // 将请求加入队列
-        {
-            std::lock_guard<std::mutex> lock(requestMutex);
-            for (auto& req : requests) {
-                requestQueue.push(std::move(req));
-            }
-            requestCV.notify_one();
+        if (bytesRead == 0) {
+            peerClosed_ = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            failed_ = true;
         }
+        break;
+    }
+    if (!failed_) {
+        dispatchRequests();
     }
-    
-    // 通知处理结束
-    responseCV.notify_one();
 }
 
-void PipelinedConnectionHandler::responseProcessingThread() {
-    HttpProcessor processor;
-    
-    while (running || !requestQueue.empty()) {
-        HttpRequest request;
-        
-        // 获取下一个请求
-        {
-            std::unique_lock<std::mutex> lock(requestMutex);
-            requestCV.wait(lock, [this]() { 
-                return !running || !requestQueue.empty(); 
-            });
-            
-            if (!running && requestQueue.empty()) break;
-            
-            request = std::move(requestQueue.front());
-            requestQueue.pop();
+void PipelinedConnectionHandler::onWritable() {
+    flush();
+    resumeIfDrained();
+}
+
+void PipelinedConnectionHandler::resumeIfDrained() {
+    if (!outputPaused_ || failed_ || outputBacklog() >= kMaxOutputBacklog) {
+        return;
+    }
+    outputPaused_ = false;
+    // 暂停期间到达的数据没有新的边缘触发，需要主动读取
+    onReadable();
+}
+
+void PipelinedConnectionHandler::resume() {
+    dispatchRequests();
+    if (!blocked_) {
+        onReadable();
+    }
+}
+
+void PipelinedConnectionHandler::dispatchRequests() {
+    if (blocked_) {
+        // 暂停的请求是最后解析的请求，它不保持连接时closing_已经设置
+        if (!dispatcher_(nextSequence_ - 1, blocked_, !closing_)) {
+            return;
+        }
+        blocked_.reset();
+    }
+
+    while (!closing_ && !input_.empty()) {
+        if (outputBacklog() >= kMaxOutputBacklog) {
+            // 剩余请求留在输入缓冲区，积压回落后再派发
+            outputPaused_ = true;
+            break;
         }
-        
-        // 处理请求
-        HttpResponse response = processor.process(request);
-        
-        // 将响应加入队列
-        {
-            std::lock_guard<std::mutex> lock(responseMutex);
-            responseQueue.push(std::move(response));
-            responseCV.notify_one();
+        HttpRequestParser::Status status = parser_.parse(input_);
+        if (status == HttpRequestParser::Status::INCOMPLETE) {
+            break;
         }
+        if (status != HttpRequestParser::Status::COMPLETE) {
+            // 非法请求在之前所有请求的响应之后回复错误，然后关闭连接
+            closing_ = true;
+            nextSequence_++;
+            pending_.emplace_back(buildErrorResponse(parser_.errorStatus()));
+            pendingBytes_ += pending_.back()->size();
+            input_.clear();
+            flush();
+            break;
+        }
+
+        const RequestView& view = parser_.request();
+        HttpHeaders headers;
+        headers.reserve(view.headers.size());
+        for (const HeaderView& header : view.headers) {
+            headers.add(std::string(header.name), std::string(header.value));
+        }
+        bool keepAlive = view.keepAlive();
+        if (!keepAlive) {
+            // 这是客户端的最后一个请求，之后到达的数据不再处理
+            closing_ = true;
+        }
+        auto request = std::make_unique<HttpRequest>(std::string(view.method), std::string(view.path),
+                                                     std::move(headers), std::string(view.body));
+        input_.erase(0, view.length);
+        parser_.reset();
+
+        uint64_t sequence = nextSequence_++;
+        pending_.emplace_back();
+        if (!dispatcher_(sequence, request, keepAlive)) {
+            // 处理阶段已满，等有空位后由resume()继续，期间不再解析后面的请求
+            blocked_ = std::move(request);
+            break;
+        }
+    }
+    if (closing_) {
+        // 最后一个请求之后的数据不再处理
+        input_.clear();
+    }
+}
+
+void PipelinedConnectionHandler::onResponse(uint64_t sequence, std::string response) {
+    if (sequence < firstPending_ || sequence - firstPending_ >= pending_.size()) {
+        LOG_WARNING("Dropping response with unexpected sequence " + std::to_string(sequence));
+        return;
     }
-    
-    // 发送所有剩余响应
-    while (!responseQueue.empty()) {
-        HttpResponse response;
-        {
-            std::lock_guard<std::mutex> lock(responseMutex);
-            response = std::move(responseQueue.front());
-            responseQueue.pop();
+    pendingBytes_ += response.size();
+    pending_[sequence - firstPending_] = std::move(response);
+    flush();
+    resumeIfDrained();
+}
+
+void PipelinedConnectionHandler::flush() {
+    // 只有队首的响应完成后才能发送，后面先完成的响应在队列中等待，保证响应顺序与请求顺序一致
+    while (!pending_.empty() && pending_.front()) {
+        output_.append(*pending_.front());
+        pendingBytes_ -= pending_.front()->size();
+        pending_.pop_front();
+        firstPending_++;
+    }
+
+    while (outputSent_ < output_.size() && !failed_) {
+        ssize_t sent = send(socket_, output_.data() + outputSent_, output_.size() - outputSent_, MSG_NOSIGNAL);
+        if (sent > 0) {
+            outputSent_ += static_cast<size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 等待下一次可写事件
+            return;
+        } else {
+            LOG_DEBUG("Failed to send pipelined response: " + std::string(strerror(errno)));
+            failed_ = true;
         }
-        
-        std::string responseStr = response.toString();
-        send(clientSocket, responseStr.c_str(), responseStr.size(), 0);
     }
-}
\ No newline at end of file
+    output_.clear();
+    outputSent_ = 0;
+}
+
+bool PipelinedConnectionHandler::finished() const {
+    if (failed_) {
+        return true;
+    }
+    return (peerClosed_ || closing_) && !blocked_ && !outputPaused_ && pending_.empty() && output_.empty();
+}
+
+} // namespace webserver
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "ConnectionManager.hpp"
+#include "Config.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+class ConnectionManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.set<int>("server.max_connections_per_client", 8);
+        config.set<int>("server.max_connections_per_ip", 3);
+        config.set<int>("server.max_requests_per_connection", 100);
+    }
+
+    // 打开一个真实的描述符，ConnectionManager关闭连接时会关闭它
+    static int openFd() {
+        return open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+
+    static bool isOpen(int fd) {
+        return fcntl(fd, F_GETFD) != -1;
+    }
+
+    webserver::Config config;
+};
+
+TEST_F(ConnectionManagerTest, TracksConnectionsAcrossShards) {
+    webserver::ConnectionManager manager(config);
+    std::vector<int> fds;
+    for (int i = 0; i < 6; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "10.0.0." + std::to_string(i)));
+    }
+    EXPECT_EQ(manager.getConnectionCount(), 6u);
+    EXPECT_EQ(manager.getActiveConnectionCount(), 6u);
+
+    manager.closeConnection(fds[0]);
+    manager.closeConnection(fds[0]);  // 重复关闭不影响计数
+    EXPECT_FALSE(isOpen(fds[0]));
+    EXPECT_EQ(manager.getConnectionCount(), 5u);
+
+    // closeSocket为false时只注销，不关闭描述符
+    manager.closeConnection(fds[1], false);
+    EXPECT_TRUE(isOpen(fds[1]));
+    close(fds[1]);
+    EXPECT_EQ(manager.getConnectionCount(), 4u);
+
+    manager.stopAll();
+    EXPECT_EQ(manager.getConnectionCount(), 0u);
+    EXPECT_FALSE(isOpen(fds[5]));
+}
+
+TEST_F(ConnectionManagerTest, EnforcesPerIPAndTotalLimits) {
+    webserver::ConnectionManager manager(config);
+    std::vector<int> fds;
+    for (int i = 0; i < 3; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "192.168.1.1"));
+    }
+    int rejected = openFd();
+    EXPECT_FALSE(manager.addConnection(rejected, "192.168.1.1"));
+    EXPECT_FALSE(isOpen(rejected));
+
+    // 关闭一个后同一IP可以再次连接
+    manager.closeConnection(fds[0]);
+    int accepted = openFd();
+    EXPECT_TRUE(manager.addConnection(accepted, "192.168.1.1"));
+
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(manager.addConnection(openFd(), "172.16.0." + std::to_string(i)));
+    }
+    EXPECT_EQ(manager.getConnectionCount(), 8u);
+    int overLimit = openFd();
+    EXPECT_FALSE(manager.addConnection(overLimit, "172.16.1.1"));
+    EXPECT_FALSE(isOpen(overLimit));
+}
+
+TEST_F(ConnectionManagerTest, AggregatesRequestsFromConcurrentThreads) {
+    config.set<int>("server.max_connections_per_client", 64);
+    config.set<int>("server.max_connections_per_ip", 64);
+    webserver::ConnectionManager manager(config);
+
+    constexpr int kThreads = 4;
+    constexpr int kRequests = 1000;
+    std::vector<int> fds;
+    for (int i = 0; i < kThreads; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "127.0.0.1"));
+    }
+
+    std::vector<std::thread> threads;
+    for (int fd : fds) {
+        threads.emplace_back([&manager, fd]() {
+            for (int i = 0; i < kRequests; ++i) {
+                manager.updateActivity(fd);
+                manager.setKeepAlive(fd, true);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(manager.getTotalRequestCount(), static_cast<uint64_t>(kThreads * kRequests));
+    std::string stats = manager.getConnectionStats();
+    EXPECT_NE(stats.find("\"total_connections\": 4"), std::string::npos);
+    EXPECT_NE(stats.find("\"total_requests\": 4000"), std::string::npos);
+    EXPECT_NE(stats.find("\"unique_ips\": 1"), std::string::npos);
+}
+
+TEST_F(ConnectionManagerTest, KeepAliveLimitsShrinkWithOccupancy) {
+    config.set<int>("server.keep_alive_timeout", 10);
+    config.set<int>("server.keep_alive_min_timeout", 2);
+    config.set<int>("server.keep_alive_min_requests", 10);
+    config.set<int>("server.keep_alive_pressure_threshold", 50);
+    webserver::ConnectionManager manager(config);
+
+    // 占用率不超过阈值时使用配置值
+    std::vector<int> fds;
+    for (int i = 0; i < 4; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "10.0.1." + std::to_string(i)));
+    }
+    webserver::ConnectionManager::KeepAliveLimits limits = manager.keepAliveLimits();
+    EXPECT_EQ(limits.occupancyPercent, 50u);
+    EXPECT_FALSE(limits.underPressure);
+    EXPECT_EQ(limits.timeoutSeconds, 10);
+    EXPECT_EQ(limits.maxRequests, 100);
+
+    // 超过阈值后线性收缩，满载时降到下限
+    for (int i = 4; i < 6; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "10.0.1." + std::to_string(i)));
+    }
+    limits = manager.keepAliveLimits();
+    EXPECT_TRUE(limits.underPressure);
+    EXPECT_EQ(limits.timeoutSeconds, 6);
+    EXPECT_EQ(limits.maxRequests, 55);
+    for (int i = 6; i < 8; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "10.0.1." + std::to_string(i)));
+    }
+    limits = manager.keepAliveLimits();
+    EXPECT_EQ(limits.timeoutSeconds, 2);
+    EXPECT_EQ(limits.maxRequests, 10);
+    std::string stats = manager.getConnectionStats();
+    EXPECT_NE(stats.find("\"keep_alive_under_pressure\": true"), std::string::npos);
+    EXPECT_NE(stats.find("\"keep_alive_timeout\": 2"), std::string::npos);
+
+    // 连接释放后恢复
+    for (size_t i = 2; i < fds.size(); ++i) {
+        manager.closeConnection(fds[i]);
+    }
+    limits = manager.keepAliveLimits();
+    EXPECT_FALSE(limits.underPressure);
+    EXPECT_EQ(limits.timeoutSeconds, 10);
+    EXPECT_EQ(limits.maxRequests, 100);
+    manager.stopAll();
+}
+
+TEST_F(ConnectionManagerTest, EnforcesPrefixLimitsForIPv4AndIPv6) {
+    config.set<int>("server.max_connections_per_ip", 2);
+    config.set<int>("server.max_connections_per_ipv4_prefix", 3);
+    config.set<int>("server.max_connections_per_ipv6_prefix", 2);
+    webserver::ConnectionManager manager(config);
+
+    // 同一/24网段的不同地址共享网段限额
+    std::vector<int> fds;
+    for (int i = 0; i < 3; ++i) {
+        fds.push_back(openFd());
+        ASSERT_TRUE(manager.addConnection(fds.back(), "10.1.2." + std::to_string(i)));
+    }
+    int rejected = openFd();
+    EXPECT_FALSE(manager.addConnection(rejected, "10.1.2.200"));
+    EXPECT_FALSE(isOpen(rejected));
+    EXPECT_TRUE(manager.addConnection(openFd(), "10.1.3.1"));
+
+    manager.closeConnection(fds[0]);
+    EXPECT_TRUE(manager.addConnection(openFd(), "10.1.2.200"));
+
+    // IPv6按/64网段计数
+    EXPECT_TRUE(manager.addConnection(openFd(), "2001:db8:0:1::1"));
+    EXPECT_TRUE(manager.addConnection(openFd(), "2001:db8:0:1::2"));
+    EXPECT_FALSE(manager.addConnection(openFd(), "2001:db8:0:1:ffff::3"));
+    EXPECT_TRUE(manager.addConnection(openFd(), "2001:db8:0:2::1"));
+
+    // 无效地址被拒绝
+    int invalid = openFd();
+    EXPECT_FALSE(manager.addConnection(invalid, "not-an-ip"));
+    EXPECT_FALSE(isOpen(invalid));
+    EXPECT_EQ(manager.getConnectionCount(), 7u);
+}
+
+TEST_F(ConnectionManagerTest, AppliesIPAccessList) {
+    config.set<std::string>("server.ip_deny", "203.0.113.0/24, 2001:db8::/32");
+    webserver::ConnectionManager manager(config);
+
+    int denied = openFd();
+    EXPECT_FALSE(manager.addConnection(denied, webserver::IpAddress::fromV4(0xCB007105)));  // 203.0.113.5
+    EXPECT_FALSE(isOpen(denied));
+    EXPECT_FALSE(manager.addConnection(openFd(), "2001:db8::1"));
+    EXPECT_TRUE(manager.addConnection(openFd(), "203.0.114.5"));
+    EXPECT_TRUE(manager.addConnection(openFd(), "2001:db9::1"));
+    EXPECT_EQ(manager.getConnectionCount(), 2u);
+    EXPECT_NE(manager.getConnectionStats().find("\"ip_access_rules\": 2"), std::string::npos);
+
+    webserver::Config invalidConfig;
+    invalidConfig.set<std::string>("server.ip_allow", "10.0.0.0/33");
+    EXPECT_THROW(webserver::ConnectionManager invalid(invalidConfig), std::runtime_error);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "EventLoop.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+class EventLoopTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        loop = std::make_unique<webserver::EventLoop>();
+    }
+
+    void TearDown() override {
+        loop->quit();
+        if (loopThread.joinable()) {
+            loopThread.join();
+        }
+        loop.reset();
+    }
+
+    void runLoopInBackground() {
+        loopThread = std::thread([this]() { loop->loop(); });
+    }
+
+    std::unique_ptr<webserver::EventLoop> loop;
+    std::thread loopThread;
+};
+
+TEST_F(EventLoopTest, QuitFromAnotherThread) {
+    runLoopInBackground();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    loop->quit();
+    loopThread.join();
+    SUCCEED();
+}
+
+TEST_F(EventLoopTest, QueuedFunctorRunsInLoopThread) {
+    std::atomic<bool> ran{false};
+    std::atomic<bool> inLoopThread{false};
+    runLoopInBackground();
+
+    loop->queueInLoop([&]() {
+        inLoopThread = loop->isInLoopThread();
+        ran = true;
+    });
+
+    for (int i = 0; i < 100 && !ran; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(ran);
+    EXPECT_TRUE(inLoopThread);
+}
+
+TEST_F(EventLoopTest, DispatchesReadableEvents) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<int> readableCount{0};
+    ASSERT_TRUE(loop->addFd(fds[0], EPOLLIN, [&](uint32_t events) {
+        char buffer[16];
+        ssize_t bytesRead = read(fds[0], buffer, sizeof(buffer));
+        if (bytesRead > 0 && (events & EPOLLIN)) {
+            readableCount++;
+        }
+    }));
+    runLoopInBackground();
+
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    for (int i = 0; i < 100 && readableCount == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(readableCount, 1);
+
+    loop->quit();
+    loopThread.join();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_F(EventLoopTest, RemovedFdNoLongerDispatched) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<int> callCount{0};
+    ASSERT_TRUE(loop->addFd(fds[0], EPOLLIN, [&](uint32_t) {
+        callCount++;
+        // 回调中注销自身
+        loop->removeFd(fds[0]);
+    }));
+    runLoopInBackground();
+
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(callCount, 1);
+
+    loop->quit();
+    loopThread.join();
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "IpFilter.hpp"
+#include "IpAddress.hpp"
+#include <atomic>
+#include <thread>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using webserver::IpAddress;
+using webserver::IpFilter;
+
+namespace {
+IpAddress addr(const std::string& text) {
+    IpAddress address;
+    EXPECT_TRUE(IpAddress::parse(text, address)) << text;
+    return address;
+}
+} // namespace
+
+TEST(IpAddressTest, ParsesAndFormatsBothFamilies) {
+    IpAddress v4 = addr("192.168.1.10");
+    EXPECT_TRUE(v4.isV4());
+    EXPECT_EQ(v4.toString(), "192.168.1.10");
+    EXPECT_EQ(v4, IpAddress::fromV4(0xC0A8010A));
+
+    IpAddress v6 = addr("2001:db8::1");
+    EXPECT_FALSE(v6.isV4());
+    EXPECT_EQ(v6.toString(), "2001:db8::1");
+
+    IpAddress invalid;
+    EXPECT_FALSE(IpAddress::parse("256.1.1.1", invalid));
+    EXPECT_FALSE(IpAddress::parse("", invalid));
+
+    // 从套接字地址转换
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(0x7F000001);
+    EXPECT_EQ(IpAddress::fromSockaddr(reinterpret_cast<sockaddr*>(&sin)).toString(), "127.0.0.1");
+    sockaddr_in6 sin6{};
+    sin6.sin6_family = AF_INET6;
+    sin6.sin6_addr = in6addr_loopback;
+    EXPECT_EQ(IpAddress::fromSockaddr(reinterpret_cast<sockaddr*>(&sin6)).toString(), "::1");
+}
+
+TEST(IpAddressTest, ParsesCidrAndMasksHostBits) {
+    IpAddress network;
+    unsigned length = 0;
+    ASSERT_TRUE(IpAddress::parseCidr("10.1.2.3/16", network, length));
+    EXPECT_EQ(network.toString(), "10.1.0.0");
+    EXPECT_EQ(length, 96u + 16u);
+
+    ASSERT_TRUE(IpAddress::parseCidr("2001:db8:abcd::1/33", network, length));
+    EXPECT_EQ(network.toString(), "2001:db8:8000::");
+    EXPECT_EQ(length, 33u);
+
+    ASSERT_TRUE(IpAddress::parseCidr("10.0.0.1", network, length));
+    EXPECT_EQ(length, 128u);
+
+    EXPECT_FALSE(IpAddress::parseCidr("10.0.0.0/33", network, length));
+    EXPECT_FALSE(IpAddress::parseCidr("10.0.0.0/", network, length));
+    EXPECT_FALSE(IpAddress::parseCidr("::/129", network, length));
+
+    EXPECT_EQ(addr("10.1.2.3").masked(96 + 24), addr("10.1.2.0"));
+    EXPECT_EQ(addr("10.1.2.3").masked(96 + 23).toString(), "10.1.2.0");
+    EXPECT_EQ(addr("10.1.3.3").masked(96 + 23).toString(), "10.1.2.0");
+}
+
+TEST(IpFilterTest, AllowsEverythingWithoutRules) {
+    IpFilter filter;
+    EXPECT_TRUE(filter.isAllowed(addr("1.2.3.4")));
+    EXPECT_TRUE(filter.isAllowed(addr("::1")));
+    EXPECT_EQ(filter.ruleCount(), 0u);
+}
+
+TEST(IpFilterTest, LongestPrefixMatchWins) {
+    IpFilter filter;
+    ASSERT_TRUE(filter.load("10.0.0.0/8, 10.1.2.3", "10.1.0.0/16"));
+    EXPECT_EQ(filter.ruleCount(), 3u);
+
+    EXPECT_TRUE(filter.isAllowed(addr("10.2.0.1")));     // 只匹配 /8 允许
+    EXPECT_FALSE(filter.isAllowed(addr("10.1.2.4")));    // /16 拒绝比 /8 更长
+    EXPECT_TRUE(filter.isAllowed(addr("10.1.2.3")));     // /32 允许最长
+    EXPECT_FALSE(filter.isAllowed(addr("192.168.0.1"))); // 存在允许列表时默认拒绝
+    EXPECT_FALSE(filter.isAllowed(addr("2001:db8::1")));
+}
+
+TEST(IpFilterTest, DenyListAloneDefaultsToAllow) {
+    IpFilter filter;
+    ASSERT_TRUE(filter.load("", "192.0.2.0/24,2001:db8::/32"));
+    EXPECT_FALSE(filter.isAllowed(addr("192.0.2.77")));
+    EXPECT_TRUE(filter.isAllowed(addr("192.0.3.1")));
+    EXPECT_FALSE(filter.isAllowed(addr("2001:db8:1::5")));
+    EXPECT_TRUE(filter.isAllowed(addr("2001:db9::5")));
+}
+
+TEST(IpFilterTest, ShortIPv6PrefixesCoverMappedIPv4) {
+    IpFilter filter;
+    // ::/0 同时覆盖IPv4映射地址；同一前缀出现在两个列表中时以拒绝为准
+    ASSERT_TRUE(filter.load("::/0", "fe80::/10, 198.51.100.1, 198.51.100.1"));
+    EXPECT_TRUE(filter.isAllowed(addr("8.8.8.8")));
+    EXPECT_FALSE(filter.isAllowed(addr("198.51.100.1")));
+    EXPECT_FALSE(filter.isAllowed(addr("fe80::1")));
+    EXPECT_TRUE(filter.isAllowed(addr("2001:db8::1")));
+
+    ASSERT_TRUE(filter.load("0.0.0.0/0", ""));
+    EXPECT_TRUE(filter.isAllowed(addr("8.8.8.8")));
+    EXPECT_FALSE(filter.isAllowed(addr("2001:db8::1")));
+}
+
+TEST(IpFilterTest, InvalidRulesKeepPreviousSnapshot) {
+    IpFilter filter;
+    ASSERT_TRUE(filter.load("", "192.0.2.0/24"));
+    EXPECT_FALSE(filter.load("", "192.0.2.0/24, bogus"));
+    EXPECT_FALSE(filter.isAllowed(addr("192.0.2.1")));
+    EXPECT_EQ(filter.ruleCount(), 1u);
+}
+
+TEST(IpFilterTest, ReadersSeeConsistentSnapshotsDuringReload) {
+    IpFilter filter;
+    ASSERT_TRUE(filter.load("", "192.0.2.0/24"));
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::thread reader([&]() {
+        IpAddress denied = addr("192.0.2.1");
+        IpAddress other = addr("198.51.100.1");
+        while (!stop.load()) {
+            // 两个快照都拒绝192.0.2.1，任何时刻都不应放行
+            if (filter.isAllowed(denied)) {
+                inconsistent++;
+            }
+            filter.isAllowed(other);
+        }
+    });
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(filter.load("", i % 2 ? "192.0.2.0/24" : "192.0.2.0/24,198.51.100.0/24"));
+    }
+    stop = true;
+    reader.join();
+    EXPECT_EQ(inconsistent.load(), 0);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "OutputQueue.hpp"
+#include <memory>
+#include <string>
+
+using webserver::OpenFile;
+using webserver::OutputQueue;
+
+namespace {
+std::string iovString(const struct iovec& iov) {
+    return std::string(static_cast<const char*>(iov.iov_base), iov.iov_len);
+}
+} // namespace
+
+TEST(OutputQueueTest, GathersSegmentsWithoutCopying) {
+    OutputQueue queue;
+    auto body = std::make_shared<const std::string>("body");
+    queue.append(std::string("head"));
+    queue.append(body, body->data(), body->size());
+    EXPECT_EQ(queue.size(), 8u);
+
+    struct iovec iov[4];
+    bool more = true;
+    ASSERT_EQ(queue.gather(iov, 4, more), 2u);
+    EXPECT_FALSE(more);
+    EXPECT_EQ(iovString(iov[0]), "head");
+    // 引用的缓冲区直接进入iovec
+    EXPECT_EQ(iov[1].iov_base, body->data());
+
+    // 引用的缓冲区在发送完之前由队列持有
+    std::weak_ptr<const std::string> weak = body;
+    body.reset();
+    EXPECT_FALSE(weak.expired());
+    queue.consume(8);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(OutputQueueTest, ConsumeAdvancesAcrossSegments) {
+    OutputQueue queue;
+    queue.append(std::string("abc"));
+    queue.append(std::string("defg"));
+    queue.consume(4);
+    EXPECT_EQ(queue.size(), 3u);
+
+    struct iovec iov[4];
+    bool more = false;
+    ASSERT_EQ(queue.gather(iov, 4, more), 1u);
+    EXPECT_EQ(iovString(iov[0]), "efg");
+}
+
+TEST(OutputQueueTest, GatherStopsAtFileSegment) {
+    OutputQueue queue;
+    auto file = std::make_shared<OpenFile>();
+    file->fd = 42;
+    queue.append(std::string("head"));
+    queue.appendFile(file, 0, 100);
+    queue.append(std::string("next"));
+    EXPECT_EQ(queue.size(), 108u);
+
+    struct iovec iov[4];
+    bool more = false;
+    ASSERT_EQ(queue.gather(iov, 4, more), 1u);
+    EXPECT_TRUE(more);
+
+    int fd = -1;
+    off_t offset = 0;
+    size_t remaining = 0;
+    EXPECT_FALSE(queue.frontFile(fd, offset, remaining));
+    queue.consume(4);
+    EXPECT_EQ(queue.gather(iov, 4, more), 0u);
+    ASSERT_TRUE(queue.frontFile(fd, offset, remaining));
+    EXPECT_EQ(fd, 42);
+    EXPECT_EQ(remaining, 100u);
+
+    // 文件段部分发送后推进位置，读入内存的部分放回队首
+    queue.consume(30);
+    queue.prepend(std::string(10, 'x'));
+    ASSERT_EQ(queue.gather(iov, 4, more), 1u);
+    EXPECT_EQ(iov[0].iov_len, 10u);
+    queue.consume(10);
+    ASSERT_TRUE(queue.frontFile(fd, offset, remaining));
+    EXPECT_EQ(offset, 30);
+    EXPECT_EQ(remaining, 70u);
+
+    queue.consume(70);
+    ASSERT_EQ(queue.gather(iov, 4, more), 1u);
+    EXPECT_EQ(iovString(iov[0]), "next");
+    file->fd = -1;  // 避免析构时关闭并不存在的描述符
+}
+
+TEST(OutputQueueTest, GatherRespectsCapacity) {
+    OutputQueue queue;
+    for (int i = 0; i < 5; ++i) {
+        queue.append(std::string(1, static_cast<char>('a' + i)));
+    }
+    queue.append(std::string());
+    EXPECT_EQ(queue.size(), 5u);
+
+    struct iovec iov[3];
+    bool more = false;
+    EXPECT_EQ(queue.gather(iov, 3, more), 3u);
+    EXPECT_TRUE(more);
+}
+
+TEST(OutputQueueTest, ReleaseMemoryFreesSegmentStorage) {
+    OutputQueue queue;
+    EXPECT_EQ(queue.memoryUsage(), 0u);
+
+    // 发送到一半的段之前可以插入读入内存的数据，已发送的段在清空时回收
+    queue.append(std::string("first"));
+    queue.append(std::string("second"));
+    queue.consume(5);
+    queue.prepend(std::string("again"));
+    EXPECT_EQ(queue.segmentCount(), 2u);
+    struct iovec iov[4];
+    bool more = false;
+    ASSERT_EQ(queue.gather(iov, 4, more), 2u);
+    EXPECT_EQ(iovString(iov[0]), "again");
+    EXPECT_EQ(iovString(iov[1]), "second");
+
+    // 队列非空时保留存储
+    queue.releaseMemory();
+    EXPECT_GT(queue.memoryUsage(), 0u);
+
+    queue.consume(queue.size());
+    EXPECT_TRUE(queue.empty());
+    queue.releaseMemory();
+    EXPECT_EQ(queue.memoryUsage(), 0u);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "TimingWheel.hpp"
+#include <memory>
+#include <vector>
+
+using webserver::TimerNode;
+using webserver::TimingWheel;
+
+class TimingWheelTest : public ::testing::Test {
+protected:
+    // 推进到指定tick，记录每个到期节点及其触发时的tick
+    void advanceTo(uint64_t tick) {
+        wheel.advance(tick, [this](TimerNode& node) {
+            fired.push_back({&node, wheel.currentTick()});
+        });
+    }
+
+    TimingWheel wheel;
+    std::vector<std::pair<TimerNode*, uint64_t>> fired;
+};
+
+TEST_F(TimingWheelTest, FiresAtExpiryTick) {
+    TimerNode node;
+    wheel.schedule(node, 5);
+    EXPECT_TRUE(node.armed());
+    EXPECT_EQ(wheel.size(), 1u);
+
+    advanceTo(4);
+    EXPECT_TRUE(fired.empty());
+    advanceTo(5);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].first, &node);
+    EXPECT_EQ(fired[0].second, 5u);
+    EXPECT_FALSE(node.armed());
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST_F(TimingWheelTest, RescheduleMovesDeadline) {
+    TimerNode node;
+    wheel.schedule(node, 10);
+    advanceTo(8);
+    wheel.schedule(node, 20);
+    EXPECT_EQ(wheel.size(), 1u);
+
+    advanceTo(19);
+    EXPECT_TRUE(fired.empty());
+    advanceTo(20);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].second, 20u);
+}
+
+TEST_F(TimingWheelTest, CancelledTimerDoesNotFire) {
+    TimerNode node;
+    wheel.schedule(node, 3);
+    wheel.cancel(node);
+    EXPECT_FALSE(node.armed());
+    advanceTo(10);
+    EXPECT_TRUE(fired.empty());
+}
+
+TEST_F(TimingWheelTest, DestroyedNodeUnlinksItself) {
+    auto node = std::make_unique<TimerNode>();
+    wheel.schedule(*node, 3);
+    node.reset();
+    advanceTo(10);
+    EXPECT_TRUE(fired.empty());
+}
+
+TEST_F(TimingWheelTest, CascadesFromHigherLevels) {
+    // 分别落在第1、2、3层的定时器，下放后仍在准确的tick触发
+    std::vector<uint64_t> expiries = {70, 4096 + 17, 262144 + 300, 64};
+    std::vector<std::unique_ptr<TimerNode>> nodes;
+    for (uint64_t expiry : expiries) {
+        nodes.push_back(std::make_unique<TimerNode>());
+        wheel.schedule(*nodes.back(), expiry);
+    }
+
+    advanceTo(300000);
+    ASSERT_EQ(fired.size(), expiries.size());
+    for (const auto& entry : fired) {
+        EXPECT_EQ(entry.second, entry.first->expiry);
+    }
+    EXPECT_EQ(fired[0].second, 64u);
+    EXPECT_EQ(fired[3].second, 262144u + 300u);
+}
+
+TEST_F(TimingWheelTest, ExpiredDeadlineFiresOnNextTick) {
+    advanceTo(100);
+    TimerNode node;
+    wheel.schedule(node, 50);
+    advanceTo(101);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].second, 101u);
+}
+
+TEST_F(TimingWheelTest, CallbackMayRescheduleNode) {
+    TimerNode node;
+    wheel.schedule(node, 2);
+    int count = 0;
+    wheel.advance(10, [&](TimerNode& expired) {
+        if (++count < 3) {
+            wheel.schedule(expired, wheel.currentTick() + 2);
+        }
+    });
+    EXPECT_EQ(count, 3);
+    EXPECT_FALSE(node.armed());
+}
@@ -1,8 +1,21 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstddef>
+#include <cstdlib>
 #include "WebServer.hpp"
+#include "Connection.hpp"
 #include "http/HttpRequest.hpp"
 #include "http/HttpResponse.hpp"
 #include "Config.hpp"
@@ -22,9 +35,101 @@ protected:
 
     void TearDown() override {
         // 清理测试
+        if (runningServer) {
+            runningServer->stop();
+        }
+        if (serverThread.joinable()) {
+            serverThread.join();
+        }
+        runningServer.reset();
+    }
+
+    // 获取一个当前空闲的端口
+    static int findFreePort() {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        close(fd);
+        return ntohs(addr.sin_port);
+    }
+
+    // 在后台线程启动服务器
+    void startServer() {
+        port = findFreePort();
+        testConfig.set<int>("port", port);
+        runningServer = std::make_unique<webserver::WebServer>(testConfig);
+        serverThread = std::thread([this]() { runningServer->start(); });
+    }
+
+    // 连接到服务器，服务器可能尚未开始监听，需要重试
+    int connectToServer() const {
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+                timeval tv{5, 0};
+                setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+                return fd;
+            }
+            close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return -1;
+    }
+
+    static void sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            ASSERT_GT(n, 0);
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    // 读取一个完整的响应（依据Content-Length）
+    static std::string readResponse(int fd, std::string& pending) {
+        char buffer[4096];
+        while (true) {
+            size_t headerEnd = pending.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                size_t bodyLength = 0;
+                size_t pos = pending.find("Content-Length: ");
+                if (pos != std::string::npos && pos < headerEnd) {
+                    bodyLength = std::stoul(pending.substr(pos + 16));
+                }
+                size_t total = headerEnd + 4 + bodyLength;
+                if (pending.size() >= total) {
+                    std::string response = pending.substr(0, total);
+                    pending.erase(0, total);
+                    return response;
+                }
+            }
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                return "";
+            }
+            pending.append(buffer, static_cast<size_t>(n));
+        }
+    }
+
+    // 检查对端是否已关闭连接
+    static bool isClosedByPeer(int fd) {
+        char c;
+        return recv(fd, &c, 1, 0) == 0;
     }
     
     webserver::Config testConfig;
+    std::unique_ptr<webserver::WebServer> runningServer;
+    std::thread serverThread;
+    int port = 0;
 };
 
 TEST_F(WebServerTest, Initialization) {
@@ -34,6 +139,1000 @@ TEST_F(WebServerTest, Initialization) {
 }
 
 TEST_F(WebServerTest, RequestHandling) {
-    // 测试请求处理逻辑
-    // 需要mock网络请求
-}
\ No newline at end of file
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+    std::string pending;
+    std::string response = readResponse(fd, pending);
+
+    EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_NE(response.find("Welcome to C++ WebServer"), std::string::npos);
+    EXPECT_NE(response.find("Connection: close"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+}
+
+TEST_F(WebServerTest, PersistenceFollowsProtocolVersion) {
+    startServer();
+
+    // HTTP/1.1没有Connection头时保持连接
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string response = readResponse(fd, pending);
+    EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+
+    // close作为选项列表中的一项同样生效
+    sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: Upgrade, close\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("Connection: close"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+
+    // HTTP/1.0默认关闭，带keep-alive时保持
+    fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    pending.clear();
+    sendAll(fd, "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+    sendAll(fd, "GET / HTTP/1.0\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("Connection: close"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+}
+
+TEST_F(WebServerTest, IdleKeepAliveConnectionsReleaseBuffers) {
+    testConfig.set<int>("server.reactor_count", 2);
+    startServer();
+
+    // 较大的请求头让输入缓冲区和解析器都分配了容量
+    std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n";
+    for (int i = 0; i < 40; ++i) {
+        request += "X-Padding-" + std::to_string(i) + ": " + std::string(200, 'p') + "\r\n";
+    }
+    request += "\r\n";
+
+    const size_t clientCount = 20;
+    std::vector<int> clients;
+    std::vector<std::string> pending(clientCount);
+    for (size_t i = 0; i < clientCount; ++i) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        sendAll(fd, request);
+        EXPECT_NE(readResponse(fd, pending[i]).find("HTTP/1.1 200 OK"), std::string::npos);
+        clients.push_back(fd);
+    }
+
+    // 停放后每个空闲连接只剩连接上下文本身，输入缓冲区、解析器和输出队列的存储都已释放
+    webserver::WebServer::IdleStats stats;
+    for (int i = 0; i < 100; ++i) {
+        stats = runningServer->getIdleStats();
+        if (stats.connections == clientCount) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(stats.connections, clientCount);
+    const size_t idleConnectionBudget = 960;
+    EXPECT_GT(stats.bytes, 0u);
+    EXPECT_LE(stats.bytes, clientCount * idleConnectionBudget);
+
+    // 停放的连接收到新请求后照常处理
+    for (size_t i = 0; i < clientCount; ++i) {
+        sendAll(clients[i], request);
+        EXPECT_NE(readResponse(clients[i], pending[i]).find("HTTP/1.1 200 OK"), std::string::npos);
+    }
+    for (int fd : clients) {
+        close(fd);
+    }
+    for (int i = 0; i < 100 && runningServer->getIdleStats().connections > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    stats = runningServer->getIdleStats();
+    EXPECT_EQ(stats.connections, 0u);
+    EXPECT_EQ(stats.bytes, 0u);
+}
+
+TEST_F(WebServerTest, KeepAliveConnectionServesMultipleRequests) {
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    std::string pending;
+    for (int i = 0; i < 3; ++i) {
+        sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+        std::string response = readResponse(fd, pending);
+        EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+    }
+    close(fd);
+}
+
+TEST_F(WebServerTest, ConnectionHeaderIsCaseInsensitive) {
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    std::string pending;
+    sendAll(fd, "GET / HTTP/1.1\r\nhost: localhost\r\nconnection: Keep-Alive\r\n\r\n");
+    std::string response = readResponse(fd, pending);
+    EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+
+    sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+    close(fd);
+}
+
+TEST_F(WebServerTest, RequestSplitAcrossReads) {
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    sendAll(fd, "GET /missing HTTP/1.1\r\nHo");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sendAll(fd, "st: localhost\r\n\r\n");
+    std::string pending;
+    std::string response = readResponse(fd, pending);
+
+    EXPECT_NE(response.find("HTTP/1.1 404 Not Found"), std::string::npos);
+    close(fd);
+}
+
+TEST_F(WebServerTest, MalformedRequestReturnsBadRequest) {
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    sendAll(fd, "BOGUS / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string pending;
+    std::string response = readResponse(fd, pending);
+
+    EXPECT_NE(response.find("HTTP/1.1 400 Bad Request"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+}
+
+TEST_F(WebServerTest, OffloadedHandlerDoesNotBlockEventLoop) {
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    runningServer->addRoute("/slow", [](const std::map<std::string, std::string>&, const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return std::string("slow");
+    }, true);
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int slowFd = connectToServer();
+    ASSERT_NE(slowFd, -1);
+    sendAll(slowFd, "GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+    // 慢请求在工作线程中执行时，其他连接仍然可以被及时处理
+    int fastFd = connectToServer();
+    ASSERT_NE(fastFd, -1);
+    auto begin = std::chrono::steady_clock::now();
+    sendAll(fastFd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string pending;
+    std::string fastResponse = readResponse(fastFd, pending);
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_NE(fastResponse.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+
+    std::string slowPending;
+    std::string slowResponse = readResponse(slowFd, slowPending);
+    EXPECT_NE(slowResponse.find("slow"), std::string::npos);
+
+    close(fastFd);
+    close(slowFd);
+}
+
+TEST_F(WebServerTest, PipelinedRequestsShareOneWrite) {
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    testConfig.set<int>("server.reactor_count", 1);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    int counter = 0;
+    runningServer->addRoute("/count", [&counter](const std::map<std::string, std::string>&, const std::string&) {
+        return "n=" + std::to_string(counter++);
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    sendAll(fd, "GET /count HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+    ASSERT_NE(readResponse(fd, pending).find("n=0"), std::string::npos);
+
+    // 一个报文中的所有请求都被执行，响应按顺序返回，且合并成少量写操作
+    const int requestCount = 24;
+    std::string requests;
+    for (int i = 0; i < requestCount; ++i) {
+        requests += "GET /count HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    }
+    uint64_t syscallsBefore = runningServer->getIoStats().syscalls;
+    sendAll(fd, requests);
+    for (int i = 1; i <= requestCount; ++i) {
+        std::string response = readResponse(fd, pending);
+        ASSERT_NE(response.find("n=" + std::to_string(i)), std::string::npos) << i;
+    }
+    EXPECT_LT(runningServer->getIoStats().syscalls - syscallsBefore, static_cast<uint64_t>(requestCount / 2));
+    close(fd);
+}
+
+TEST_F(WebServerTest, PipelinedBatchYieldsToOtherConnections) {
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    testConfig.set<int>("server.reactor_count", 1);
+    testConfig.set<int>("server.fairness_max_requests", 8);
+    testConfig.set<int>("server.max_requests_per_connection", 1000);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    std::atomic<int> counter{0};
+    runningServer->addRoute("/work", [&counter](const std::map<std::string, std::string>&, const std::string&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return "n=" + std::to_string(counter++);
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int batch = connectToServer();
+    int interactive = connectToServer();
+    ASSERT_NE(batch, -1);
+    ASSERT_NE(interactive, -1);
+
+    // 批量客户端一次发出200个请求，逐个处理约需200毫秒
+    const int requestCount = 200;
+    std::string requests;
+    for (int i = 0; i < requestCount; ++i) {
+        requests += "GET /work HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+    sendAll(batch, requests);
+    while (counter == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 交互客户端只需等待批量连接用完当前一轮的预算，不必等整批处理完
+    sendAll(interactive, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string pending;
+    EXPECT_NE(readResponse(interactive, pending).find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_LT(counter.load(), requestCount);
+
+    // 批量连接的响应完整且按顺序
+    pending.clear();
+    for (int i = 0; i < requestCount; ++i) {
+        std::string response = readResponse(batch, pending);
+        ASSERT_NE(response.find("n=" + std::to_string(i)), std::string::npos) << i;
+    }
+    EXPECT_GE(runningServer->getIoStats().fairnessYields, static_cast<uint64_t>(requestCount / 8 - 1));
+    close(batch);
+    close(interactive);
+}
+
+TEST_F(WebServerTest, PipelinedBatchYieldsAfterByteBudget) {
+    testConfig.set<int>("server.reactor_count", 1);
+    testConfig.set<int>("server.fairness_max_requests", 0);
+    testConfig.set<int>("server.fairness_max_bytes", 256);
+    testConfig.set<int>("server.max_requests_per_connection", 1000);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    // 每个请求约40字节，每轮处理约7个后达到字节预算
+    const int requestCount = 100;
+    std::string requests;
+    for (int i = 0; i < requestCount; ++i) {
+        requests += "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+    sendAll(fd, requests);
+    std::string pending;
+    for (int i = 0; i < requestCount; ++i) {
+        ASSERT_NE(readResponse(fd, pending).find("HTTP/1.1 200 OK"), std::string::npos) << i;
+    }
+    EXPECT_GE(runningServer->getIoStats().fairnessYields, 10u);
+    close(fd);
+}
+
+TEST_F(WebServerTest, SlowReaderPausesPipelinedProcessing) {
+    testConfig.set<int>("server.output_high_watermark", 64 * 1024);
+    testConfig.set<int>("server.output_low_watermark", 16 * 1024);
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    std::string body(512 * 1024, 'b');
+    runningServer->addRoute("/big", [&body](const std::map<std::string, std::string>&, const std::string&) {
+        return body;
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    int receiveBuffer = 64 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    // 一次发出多个流水线请求但暂不读取，服务器应在输出积压后暂停而不是无限缓存
+    const int requestCount = 8;
+    std::string requests;
+    for (int i = 0; i < requestCount; ++i) {
+        requests += "GET /big HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    }
+    sendAll(fd, requests);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_GT(runningServer->getIoStats().readPauses, 0u);
+
+    // 客户端开始读取后积压排空，所有响应按顺序完整到达
+    std::string pending;
+    for (int i = 0; i < requestCount; ++i) {
+        std::string response = readResponse(fd, pending);
+        ASSERT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        size_t headerEnd = response.find("\r\n\r\n");
+        EXPECT_EQ(response.size() - headerEnd - 4, body.size());
+    }
+    close(fd);
+}
+
+TEST_F(WebServerTest, UploadRouteSpoolsLargeBodyToTempFile) {
+    testConfig.set<int>("server.max_body_size", 16 * 1024);
+    testConfig.set<int>("server.body_memory_limit", 64 * 1024);
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    std::string body(1024 * 1024 + 7, '\0');
+    for (size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<char>('a' + i % 26);
+    }
+    bool spilled = false;
+    bool intact = false;
+    runningServer->addUploadRoute("/upload", [&](const std::map<std::string, std::string>&,
+                                                 const webserver::SpooledBody& upload) {
+        spilled = !upload.inMemory() && upload.fd() >= 0;
+        intact = upload.data() == body;
+        return std::to_string(upload.size());
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    sendAll(fd, "POST /upload HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n"
+                "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n");
+    sendAll(fd, body);
+    std::string response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_NE(response.find(std::to_string(body.size())), std::string::npos);
+    EXPECT_TRUE(spilled);
+    EXPECT_TRUE(intact);
+
+    // 普通路由仍然受server.max_body_size限制
+    sendAll(fd, "POST / HTTP/1.1\r\nHost: localhost\r\nContent-Length: 32768\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 413"), std::string::npos);
+    close(fd);
+}
+
+namespace {
+// 统计收到的字节数和单次交出的最大长度
+class CountingConsumer : public webserver::BodyConsumer {
+public:
+    CountingConsumer(size_t& total, size_t& largest) : total_(total), largest_(largest) {}
+    bool consume(std::string_view data) override {
+        total_ += data.size();
+        largest_ = std::max(largest_, data.size());
+        return data.find('!') == std::string_view::npos;
+    }
+    std::string finish() override { return "received " + std::to_string(total_); }
+
+private:
+    size_t& total_;
+    size_t& largest_;
+};
+} // namespace
+
+TEST_F(WebServerTest, StreamRouteReceivesChunkedBodyIncrementally) {
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    size_t total = 0;
+    size_t largest = 0;
+    runningServer->addStreamRoute("/stream", [&](const std::map<std::string, std::string>&) {
+        total = 0;
+        return std::make_unique<CountingConsumer>(total, largest);
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    // 分块请求的响应也是分块编码，读到连接关闭为止
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    sendAll(fd, "POST /stream HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n"
+                "Connection: close\r\n\r\n");
+    std::string chunk(8192, 's');
+    const int chunkCount = 64;
+    for (int i = 0; i < chunkCount; ++i) {
+        sendAll(fd, "2000\r\n" + chunk + "\r\n");
+    }
+    sendAll(fd, "0\r\nX-Checksum: none\r\n\r\n");
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_NE(response.find("received " + std::to_string(chunk.size() * chunkCount)), std::string::npos);
+    EXPECT_LE(largest, chunk.size());
+    close(fd);
+
+    // BodyConsumer拒绝数据时返回500并关闭连接
+    fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    sendAll(fd, "POST /stream HTTP/1.1\r\nHost: localhost\r\nContent-Length: 3\r\n\r\na!b");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 500"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+}
+
+TEST_F(WebServerTest, MultipleReactorsWithReusePortListeners) {
+    testConfig.set<int>("server.reactor_count", 4);
+    testConfig.set<bool>("server.reuseport_cpu_steering", true);
+    startServer();
+
+    // 内核在4个SO_REUSEPORT套接字之间分发连接，每个连接都应得到正确响应
+    for (int i = 0; i < 16; ++i) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        std::string pending;
+        std::string response = readResponse(fd, pending);
+        EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        close(fd);
+    }
+}
+
+TEST_F(WebServerTest, MultipleReactorsSharingExclusiveListener) {
+    testConfig.set<int>("server.reactor_count", 3);
+    testConfig.set<std::string>("server.listener_mode", "exclusive");
+    startServer();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 9; ++i) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+        clients.push_back(fd);
+    }
+    for (int fd : clients) {
+        std::string pending;
+        std::string response = readResponse(fd, pending);
+        EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        close(fd);
+    }
+}
+
+TEST_F(WebServerTest, IoUringBackendServesKeepAliveAndCloseRequests) {
+    testConfig.set<int>("server.reactor_count", 2);
+    testConfig.set<std::string>("server.io_backend", "io_uring");
+    startServer();
+    if (!runningServer->isIoUringEnabled()) {
+        GTEST_SKIP() << "io_uring is not available on this kernel";
+    }
+
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    for (int i = 0; i < 3; ++i) {
+        sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+        std::string response = readResponse(fd, pending);
+        EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+    }
+
+    // 请求被拆成两次发送，并以非保活请求结束连接
+    sendAll(fd, "GET /missing HTTP/1.1\r\nHo");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sendAll(fd, "st: localhost\r\nConnection: close\r\n\r\n");
+    std::string response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 404 Not Found"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+
+    webserver::WebServer::IoStats stats = runningServer->getIoStats();
+    EXPECT_EQ(stats.requests, 4u);
+    EXPECT_GT(stats.syscalls, 0u);
+}
+
+TEST_F(WebServerTest, IdleKeepAliveConnectionClosedByTimer) {
+    testConfig.set<int>("server.keep_alive_timeout", 1);
+    testConfig.set<int>("server.timer_tick_ms", 20);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+    std::string pending;
+    std::string response = readResponse(fd, pending);
+    EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+
+    // 保活超时后由时间轮关闭连接
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(isClosedByPeer(fd));
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(800));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(3000));
+    close(fd);
+}
+
+TEST_F(WebServerTest, KeepAliveTimeoutShrinksUnderConnectionPressure) {
+    testConfig.set<int>("server.max_connections_per_client", 4);
+    testConfig.set<int>("server.keep_alive_timeout", 30);
+    testConfig.set<int>("server.keep_alive_min_timeout", 1);
+    testConfig.set<int>("server.keep_alive_pressure_threshold", 50);
+    testConfig.set<int>("server.timer_tick_ms", 20);
+    startServer();
+
+    // 占用率低时通告配置的超时
+    int first = connectToServer();
+    ASSERT_NE(first, -1);
+    std::string pending;
+    sendAll(first, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_NE(readResponse(first, pending).find("Keep-Alive: timeout=30, max="), std::string::npos);
+
+    // 连接数达到上限后通告收缩后的超时，已在等待的空闲连接也按新的超时关闭
+    std::vector<int> clients;
+    for (int i = 0; i < 3; ++i) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        clients.push_back(fd);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_TRUE(runningServer->getKeepAliveLimits().underPressure);
+    sendAll(clients[0], "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    pending.clear();
+    EXPECT_NE(readResponse(clients[0], pending).find("Keep-Alive: timeout=1, max="), std::string::npos);
+
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(isClosedByPeer(first));
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(3000));
+    close(first);
+    for (int fd : clients) {
+        close(fd);
+    }
+
+    // 连接释放后恢复配置的超时
+    for (int i = 0; i < 100 && runningServer->getKeepAliveLimits().underPressure; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_EQ(runningServer->getKeepAliveLimits().timeoutSeconds, 30);
+}
+
+TEST_F(WebServerTest, SlowRequestHeaderClosedAfterHeaderTimeout) {
+    testConfig.set<int>("server.header_timeout", 1);
+    testConfig.set<int>("server.timer_tick_ms", 20);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    // 持续发送请求头的片段也不能让连接无限期续命
+    auto begin = std::chrono::steady_clock::now();
+    sendAll(fd, "GET / HTTP/1.1\r\n");
+    bool closed = false;
+    for (int i = 0; i < 30 && !closed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        closed = send(fd, "X: y\r\n", 6, MSG_NOSIGNAL) < 0;
+    }
+    if (!closed) {
+        closed = isClosedByPeer(fd);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_TRUE(closed);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2500));
+    close(fd);
+}
+
+TEST_F(WebServerTest, SlowRequestBodyClosedBelowMinimumRate) {
+    testConfig.set<int>("server.body_timeout", 1);
+    testConfig.set<int>("server.min_body_rate", 1000);
+    testConfig.set<int>("server.timer_tick_ms", 20);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    // 请求头很快发完，请求体每200毫秒只有10字节，远低于每秒1000字节的最低速率
+    auto begin = std::chrono::steady_clock::now();
+    sendAll(fd, "POST / HTTP/1.1\r\nHost: localhost\r\nContent-Length: 100000\r\n\r\n");
+    bool closed = false;
+    for (int i = 0; i < 30 && !closed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        closed = send(fd, "0123456789", 10, MSG_NOSIGNAL) < 0;
+    }
+    if (!closed) {
+        closed = isClosedByPeer(fd);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_TRUE(closed);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(3000));
+    close(fd);
+}
+
+TEST_F(WebServerTest, ClientThatStopsReadingClosedAfterDrainTimeout) {
+    testConfig.set<int>("server.drain_timeout", 1);
+    // 内核缓冲区吸收的数据按极高的最低速率几乎换不来额外时间
+    testConfig.set<int>("server.min_send_rate", 1024 * 1024 * 1024);
+    testConfig.set<int>("server.timer_tick_ms", 20);
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    std::string body(32 * 1024 * 1024, 'd');
+    runningServer->addRoute("/huge", [&body](const std::map<std::string, std::string>&, const std::string&) {
+        return body;
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    sendAll(fd, "GET /huge HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+    // 客户端不读取响应，积压的输出超过发送时限后连接被关闭
+    std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+    size_t received = 0;
+    char buffer[65536];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        received += static_cast<size_t>(n);
+    }
+    EXPECT_LT(received, body.size());
+    close(fd);
+}
+
+TEST_F(WebServerTest, ConnectionBurstAcceptedInBatches) {
+    testConfig.set<int>("server.reactor_count", 1);
+    testConfig.set<int>("server.accept_batch", 2);
+    testConfig.set<int>("server.listen_backlog", 256);
+    testConfig.set<int>("server.tcp_defer_accept", 1);
+    testConfig.set<int>("server.tcp_fastopen", 16);
+    startServer();
+
+    // 连接全部建立后才发送请求，服务器需要分多轮把队列中的连接取完
+    std::vector<int> clients;
+    for (int i = 0; i < 40; ++i) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        clients.push_back(fd);
+    }
+    for (int fd : clients) {
+        sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    }
+    for (int fd : clients) {
+        std::string pending;
+        std::string response = readResponse(fd, pending);
+        EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        close(fd);
+    }
+
+    webserver::WebServer::ListenStats stats = runningServer->getListenStats();
+    EXPECT_EQ(stats.accepted, 40u);
+    EXPECT_EQ(stats.acceptQueueLimit, 256u);
+    EXPECT_EQ(stats.acceptQueueLength, 0u);
+}
+
+TEST_F(WebServerTest, AcceptedSocketsInheritSendPolicy) {
+    testConfig.set<int>("server.socket_send_buffer", 256 * 1024);
+    testConfig.set<int>("server.socket_receive_buffer", 128 * 1024);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    ASSERT_NE(readResponse(fd, pending).find("HTTP/1.1 200 OK"), std::string::npos);
+
+    // 服务器与测试在同一进程中：对端地址等于客户端本地地址的套接字就是服务器接受的连接
+    sockaddr_in local{};
+    socklen_t length = sizeof(local);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length);
+    int accepted = -1;
+    for (int candidate = 3; candidate < 4096 && accepted == -1; ++candidate) {
+        sockaddr_in peer{};
+        length = sizeof(peer);
+        if (candidate != fd && getpeername(candidate, reinterpret_cast<sockaddr*>(&peer), &length) == 0 &&
+            peer.sin_family == AF_INET && peer.sin_port == local.sin_port) {
+            accepted = candidate;
+        }
+    }
+    ASSERT_NE(accepted, -1);
+
+    int value = 0;
+    length = sizeof(value);
+    ASSERT_EQ(getsockopt(accepted, IPPROTO_TCP, TCP_NODELAY, &value, &length), 0);
+    EXPECT_NE(value, 0);
+    // flush结束后不会遗留TCP_CORK
+    ASSERT_EQ(getsockopt(accepted, IPPROTO_TCP, TCP_CORK, &value, &length), 0);
+    EXPECT_EQ(value, 0);
+    // 内核把设置值加倍以容纳簿记开销
+    ASSERT_EQ(getsockopt(accepted, SOL_SOCKET, SO_SNDBUF, &value, &length), 0);
+    EXPECT_GE(value, 256 * 1024);
+    ASSERT_EQ(getsockopt(accepted, SOL_SOCKET, SO_RCVBUF, &value, &length), 0);
+    EXPECT_GE(value, 128 * 1024);
+    close(fd);
+}
+
+TEST_F(WebServerTest, LargeResponseSentWithZeroCopy) {
+    testConfig.set<int>("server.zerocopy_threshold", 256 * 1024);
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    std::string body(1024 * 1024, 'z');
+    for (size_t i = 0; i < body.size(); i += 4096) {
+        body[i] = static_cast<char>('a' + (i / 4096) % 26);
+    }
+    runningServer->addRoute("/export", [&body](const std::map<std::string, std::string>&, const std::string&) {
+        return body;
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string pending;
+    for (int i = 0; i < 2; ++i) {
+        sendAll(fd, "GET /export HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        std::string response = readResponse(fd, pending);
+        size_t headerEnd = response.find("\r\n\r\n");
+        ASSERT_NE(headerEnd, std::string::npos);
+        EXPECT_TRUE(response.compare(headerEnd + 4, std::string::npos, body) == 0);
+    }
+    close(fd);
+
+    // 每次零拷贝发送最终都收到完成通知并释放缓冲区（回环接口上内核会回退为复制）
+    webserver::WebServer::IoStats stats = runningServer->getIoStats();
+    for (int i = 0; i < 100 && stats.zeroCopyCompletions < stats.zeroCopySends; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stats = runningServer->getIoStats();
+    }
+    EXPECT_GT(stats.zeroCopySends, 0u);
+    EXPECT_EQ(stats.zeroCopyCompletions, stats.zeroCopySends);
+}
+
+TEST_F(WebServerTest, ZeroCopyBuffersOutliveConnectionClose) {
+    testConfig.set<int>("server.zerocopy_threshold", 256 * 1024);
+    port = findFreePort();
+    testConfig.set<int>("port", port);
+    runningServer = std::make_unique<webserver::WebServer>(testConfig);
+    std::string body(1024 * 1024, 'z');
+    for (size_t i = 0; i < body.size(); i += 4096) {
+        body[i] = static_cast<char>('a' + (i / 4096) % 26);
+    }
+    runningServer->addRoute("/export", [&body](const std::map<std::string, std::string>&, const std::string&) {
+        return body;
+    });
+    serverThread = std::thread([this]() { runningServer->start(); });
+
+    // 接收窗口很小，服务器写完最后一个响应并关闭连接时大部分数据还在内核的发送队列中
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    int receiveBuffer = 64 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    sendAll(fd, "GET /export HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::string data;
+    char buffer[65536];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    size_t headerEnd = data.find("\r\n\r\n");
+    ASSERT_NE(headerEnd, std::string::npos);
+    EXPECT_TRUE(data.compare(headerEnd + 4, std::string::npos, body) == 0);
+
+    // 连接关闭后仍然收到完成通知，缓冲区在内核不再引用后才释放
+    webserver::WebServer::IoStats stats = runningServer->getIoStats();
+    for (int i = 0; i < 100 && stats.zeroCopyCompletions < stats.zeroCopySends; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stats = runningServer->getIoStats();
+    }
+    EXPECT_GT(stats.zeroCopySends, 0u);
+    EXPECT_EQ(stats.zeroCopyCompletions, stats.zeroCopySends);
+}
+
+namespace {
+// 通过任意地址族的套接字地址连接服务器，失败返回-1
+int connectAddress(const sockaddr* addr, socklen_t length) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int fd = socket(addr->sa_family, SOCK_STREAM, 0);
+        if (connect(fd, addr, length) == 0) {
+            timeval tv{5, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+} // namespace
+
+TEST_F(WebServerTest, ServesDualStackAndUnixDomainListeners) {
+    std::string suffix = std::to_string(getpid());
+    std::string socketPath = "/tmp/webserver_test_" + suffix + ".sock";
+    std::string abstractName = "webserver_test_" + suffix;
+    int tcpPort = findFreePort();
+    testConfig.set<int>("server.reactor_count", 2);
+    testConfig.set<nlohmann::json>("server.listeners", nlohmann::json::array({
+        {{"type", "tcp"}, {"address", "::"}, {"port", tcpPort}, {"ipv6_only", false}},
+        {{"type", "unix"}, {"path", socketPath}},
+        {{"type", "unix"}, {"path", abstractName}, {"abstract", true}},
+    }));
+    startServer();
+
+    sockaddr_in v4{};
+    v4.sin_family = AF_INET;
+    v4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    v4.sin_port = htons(static_cast<uint16_t>(tcpPort));
+    sockaddr_in6 v6{};
+    v6.sin6_family = AF_INET6;
+    v6.sin6_addr = in6addr_loopback;
+    v6.sin6_port = htons(static_cast<uint16_t>(tcpPort));
+    sockaddr_un path{};
+    path.sun_family = AF_UNIX;
+    std::memcpy(path.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    sockaddr_un abstract{};
+    abstract.sun_family = AF_UNIX;
+    std::memcpy(abstract.sun_path + 1, abstractName.data(), abstractName.size());
+    auto abstractLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + abstractName.size());
+
+    std::vector<std::pair<const sockaddr*, socklen_t>> targets = {
+        {reinterpret_cast<sockaddr*>(&v4), sizeof(v4)},
+        {reinterpret_cast<sockaddr*>(&v6), sizeof(v6)},
+        {reinterpret_cast<sockaddr*>(&path), sizeof(path)},
+        {reinterpret_cast<sockaddr*>(&abstract), abstractLength},
+    };
+    for (const auto& target : targets) {
+        // 同一地址上的多个保活连接，Unix域连接不受单IP连接数限制
+        for (int i = 0; i < 3; ++i) {
+            int fd = connectAddress(target.first, target.second);
+            ASSERT_NE(fd, -1) << "address family " << target.first->sa_family;
+            std::string pending;
+            sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+            EXPECT_NE(readResponse(fd, pending).find("HTTP/1.1 200 OK"), std::string::npos);
+            sendAll(fd, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+            EXPECT_NE(readResponse(fd, pending).find("HTTP/1.1 200 OK"), std::string::npos);
+            close(fd);
+        }
+    }
+
+    runningServer->stop();
+    serverThread.join();
+    // 停止后删除套接字文件
+    EXPECT_NE(access(socketPath.c_str(), F_OK), 0);
+}
+
+TEST_F(WebServerTest, InvalidListenerConfigurationThrows) {
+    testConfig.set<nlohmann::json>("server.listeners", nlohmann::json::array({
+        {{"type", "tcp"}, {"address", "not-an-address"}},
+    }));
+    EXPECT_THROW(webserver::WebServer server(testConfig), std::runtime_error);
+
+    testConfig.set<nlohmann::json>("server.listeners", nlohmann::json::array({
+        {{"type", "unix"}, {"path", std::string(200, 'x')}},
+    }));
+    EXPECT_THROW(webserver::WebServer server(testConfig), std::runtime_error);
+}
+
+namespace {
+
+// 创建包含一个大文件的静态目录，返回目录路径
+std::string createStaticRoot(std::string& content) {
+    char pattern[] = "/tmp/webserver_static_XXXXXX";
+    if (mkdtemp(pattern) == nullptr) {
+        return "";
+    }
+    content.resize(3 * 1024 * 1024 + 123);
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>('a' + i % 26);
+    }
+    std::ofstream file(std::string(pattern) + "/large.bin", std::ios::binary);
+    file << content;
+    return pattern;
+}
+
+} // namespace
+
+TEST_F(WebServerTest, ServesLargeStaticFileOverKeepAlive) {
+    std::string content;
+    std::string root = createStaticRoot(content);
+    ASSERT_FALSE(root.empty());
+    testConfig.set<std::string>("server.static_root", root);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    // 同一连接上连续获取两次，第二次命中打开文件缓存
+    std::string pending;
+    std::string lastModified;
+    for (int i = 0; i < 2; ++i) {
+        sendAll(fd, "GET /static/large.bin HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+        std::string response = readResponse(fd, pending);
+        ASSERT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+        EXPECT_NE(response.find("Content-Type: application/octet-stream"), std::string::npos);
+        EXPECT_NE(response.find("Connection: keep-alive"), std::string::npos);
+        size_t headerEnd = response.find("\r\n\r\n");
+        EXPECT_TRUE(response.compare(headerEnd + 4, std::string::npos, content) == 0);
+
+        size_t pos = response.find("Last-Modified: ");
+        ASSERT_NE(pos, std::string::npos);
+        lastModified = response.substr(pos + 15, response.find("\r\n", pos) - pos - 15);
+    }
+
+    // 条件请求返回304，未知文件返回404，连接仍保持
+    sendAll(fd, "GET /static/large.bin HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n"
+                "If-Modified-Since: " + lastModified + "\r\n\r\n");
+    std::string response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 304 Not Modified"), std::string::npos);
+
+    sendAll(fd, "GET /static/missing.bin HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 404 Not Found"), std::string::npos);
+    EXPECT_TRUE(isClosedByPeer(fd));
+    close(fd);
+
+    std::string command = "rm -rf " + root;
+    EXPECT_EQ(std::system(command.c_str()), 0);
+}
+
+TEST_F(WebServerTest, LowercaseConditionalHeaderReturnsNotModified) {
+    std::string content;
+    std::string root = createStaticRoot(content);
+    ASSERT_FALSE(root.empty());
+    testConfig.set<std::string>("server.static_root", root);
+    startServer();
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+
+    std::string pending;
+    sendAll(fd, "GET /static/large.bin HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string response = readResponse(fd, pending);
+    size_t pos = response.find("ETag: ");
+    ASSERT_NE(pos, std::string::npos);
+    std::string etag = response.substr(pos + 6, response.find("\r\n", pos) - pos - 6);
+
+    // 头部名称不区分大小写，客户端的小写写法同样命中条件请求
+    sendAll(fd, "GET /static/large.bin HTTP/1.1\r\nhost: localhost\r\nif-none-match: " + etag + "\r\n\r\n");
+    response = readResponse(fd, pending);
+    EXPECT_NE(response.find("HTTP/1.1 304 Not Modified"), std::string::npos);
+    close(fd);
+
+    std::string command = "rm -rf " + root;
+    EXPECT_EQ(std::system(command.c_str()), 0);
+}
+
+TEST_F(WebServerTest, IoUringBackendServesStaticFile) {
+    std::string content;
+    std::string root = createStaticRoot(content);
+    ASSERT_FALSE(root.empty());
+    testConfig.set<std::string>("server.static_root", root);
+    testConfig.set<std::string>("server.static_url_prefix", "/files");
+    testConfig.set<std::string>("server.io_backend", "io_uring");
+    startServer();
+    if (runningServer->isIoUringEnabled()) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        std::string pending;
+        for (int i = 0; i < 2; ++i) {
+            sendAll(fd, "GET /files/large.bin HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n");
+            std::string response = readResponse(fd, pending);
+            ASSERT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+            size_t headerEnd = response.find("\r\n\r\n");
+            EXPECT_TRUE(response.compare(headerEnd + 4, std::string::npos, content) == 0);
+        }
+        close(fd);
+    }
+
+    std::string command = "rm -rf " + root;
+    EXPECT_EQ(std::system(command.c_str()), 0);
+    if (!runningServer->isIoUringEnabled()) {
+        GTEST_SKIP() << "io_uring is not available on this kernel";
+    }
+}
@@ -0,0 +1,109 @@
+#include "ChunkedDecoder.hpp"
+#include "gtest/gtest.h"
+#include <string>
+
+namespace webserver {
+
+using Status = ChunkedDecoder::Status;
+using Error = ChunkedDecoder::Error;
+
+namespace {
+// 模拟连接：每次到达一段数据，未消费的字节留在缓冲区开头
+Status feed(ChunkedDecoder& decoder, std::string& pending, std::string_view input, std::string& output) {
+    pending.append(input.data(), input.size());
+    size_t offset = 0;
+    while (true) {
+        size_t consumed = 0;
+        std::string_view chunk;
+        Status status = decoder.decode(std::string_view(pending).substr(offset), consumed, chunk);
+        offset += consumed;
+        if (status == Status::DATA) {
+            output.append(chunk.data(), chunk.size());
+            continue;
+        }
+        pending.erase(0, offset);
+        return status;
+    }
+}
+
+const std::string kEncoded =
+    "5;name=value\r\nhello\r\n"
+    "6\r\n world\r\n"
+    "0\r\n"
+    "X-Checksum: abc\r\n"
+    "X-Empty:\r\n"
+    "\r\n";
+} // namespace
+
+// 测试输入在任意位置被切开时都能得到相同的结果
+TEST(ChunkedDecoderTest, HandlesArbitrarySplits) {
+    for (size_t split = 0; split <= kEncoded.size(); ++split) {
+        ChunkedDecoder decoder;
+        std::string pending;
+        std::string output;
+        Status first = feed(decoder, pending, std::string_view(kEncoded).substr(0, split), output);
+        if (split < kEncoded.size()) {
+            ASSERT_EQ(first, Status::NEED_MORE) << split;
+        }
+        ASSERT_EQ(feed(decoder, pending, std::string_view(kEncoded).substr(split), output), Status::DONE) << split;
+        EXPECT_EQ(output, "hello world") << split;
+        EXPECT_TRUE(pending.empty()) << split;
+        EXPECT_EQ(decoder.decodedSize(), 11u);
+    }
+}
+
+// 测试逐字节到达时块数据随到随交出
+TEST(ChunkedDecoderTest, DeliversDataIncrementally) {
+    ChunkedDecoder decoder;
+    std::string pending;
+    std::string output;
+    ASSERT_EQ(feed(decoder, pending, "a\r\n01234", output), Status::NEED_MORE);
+    EXPECT_EQ(output, "01234");
+    EXPECT_TRUE(pending.empty());
+    ASSERT_EQ(feed(decoder, pending, "56789\r\n0\r\n\r\n", output), Status::DONE);
+    EXPECT_EQ(output, "0123456789");
+}
+
+// 测试尾部字段被保留，读完后不再消费后面的数据
+TEST(ChunkedDecoderTest, CollectsTrailers) {
+    ChunkedDecoder decoder;
+    std::string pending;
+    std::string output;
+    ASSERT_EQ(feed(decoder, pending, kEncoded + "GET /next", output), Status::DONE);
+    EXPECT_EQ(pending, "GET /next");
+    ASSERT_EQ(decoder.trailers().size(), 2u);
+    EXPECT_EQ(decoder.trailers().get("x-checksum"), "abc");
+    EXPECT_TRUE(decoder.trailers().contains("X-Empty"));
+
+    decoder.reset();
+    EXPECT_TRUE(decoder.trailers().empty());
+    EXPECT_EQ(decoder.decodedSize(), 0u);
+}
+
+// 测试非法编码和各项限制
+TEST(ChunkedDecoderTest, RejectsMalformedInput) {
+    auto errorOf = [](const std::string& input, const ChunkedDecoder::Limits& limits) {
+        ChunkedDecoder decoder(limits);
+        std::string pending;
+        std::string output;
+        return feed(decoder, pending, input, output) == Status::ERROR ? decoder.error() : Error::NONE;
+    };
+    ChunkedDecoder::Limits limits;
+    EXPECT_EQ(errorOf("zz\r\n", limits), Error::BAD_CHUNK);
+    EXPECT_EQ(errorOf("\r\n", limits), Error::BAD_CHUNK);
+    EXPECT_EQ(errorOf("2\r\nabc\r\n", limits), Error::BAD_CHUNK);
+    EXPECT_EQ(errorOf("1" + std::string(2000, ' '), limits), Error::BAD_CHUNK);
+    EXPECT_EQ(errorOf("0\r\nno colon\r\n\r\n", limits), Error::BAD_TRAILER);
+    EXPECT_EQ(errorOf("0\r\nBad Name: x\r\n\r\n", limits), Error::BAD_TRAILER);
+
+    limits.maxBodySize = 4;
+    limits.maxTrailerBytes = 16;
+    limits.maxTrailers = 1;
+    EXPECT_EQ(errorOf("3\r\nabc\r\n2\r\n", limits), Error::BODY_TOO_LARGE);
+    EXPECT_EQ(errorOf("ffffffffffffff\r\n", limits), Error::BODY_TOO_LARGE);
+    EXPECT_EQ(errorOf("0\r\nX-Long: " + std::string(32, 'a'), limits), Error::TRAILER_TOO_LARGE);
+    EXPECT_EQ(errorOf("0\r\nA: 1\r\nB: 2\r\n\r\n", limits), Error::TRAILER_TOO_LARGE);
+    EXPECT_EQ(errorOf("4\r\nabcd\r\n0\r\nA: 1\r\n\r\n", limits), Error::NONE);
+}
+
+} // namespace webserver
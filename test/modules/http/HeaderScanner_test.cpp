@@ -0,0 +1,76 @@
+#include "HeaderScanner.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+namespace webserver {
+
+namespace {
+
+bool isTokenChar(int b) {
+    return (b >= '0' && b <= '9') || (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') ||
+           std::string("!#$%&'*+-.^_`|~").find(static_cast<char>(b)) != std::string::npos;
+}
+
+bool isTargetChar(int b) {
+    return b > 0x20 && b != 0x7f;
+}
+
+bool isFieldValueChar(int b) {
+    return b == '\t' || (b >= 0x20 && b != 0x7f);
+}
+
+std::vector<HeaderScanner::Level> supportedLevels() {
+    std::vector<HeaderScanner::Level> levels = {HeaderScanner::Level::SCALAR};
+    if (HeaderScanner::supportedLevel() >= HeaderScanner::Level::SSE42) {
+        levels.push_back(HeaderScanner::Level::SSE42);
+    }
+    if (HeaderScanner::supportedLevel() >= HeaderScanner::Level::AVX2) {
+        levels.push_back(HeaderScanner::Level::AVX2);
+    }
+    return levels;
+}
+
+} // namespace
+
+class HeaderScannerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        HeaderScanner::setLevel(HeaderScanner::supportedLevel());
+    }
+};
+
+// 测试每个字节值出现在每个位置（覆盖短输入、向量块内、块边界和重叠的尾部）时，各实现结果与定义一致
+TEST_F(HeaderScannerTest, AllLevelsMatchCharacterClasses) {
+    for (HeaderScanner::Level level : supportedLevels()) {
+        ASSERT_EQ(HeaderScanner::setLevel(level), level);
+        for (size_t length : {5u, 16u, 23u, 32u, 47u, 70u}) {
+            for (int b = 0; b < 256; ++b) {
+                for (size_t position = 0; position < length; ++position) {
+                    std::string data(length, 'a');
+                    data[position] = static_cast<char>(b);
+                    EXPECT_EQ(HeaderScanner::findTokenEnd(data.data(), data.size()),
+                              isTokenChar(b) ? length : position) << "level " << static_cast<int>(level) << " byte " << b;
+                    EXPECT_EQ(HeaderScanner::findTargetEnd(data.data(), data.size()),
+                              isTargetChar(b) ? length : position) << "level " << static_cast<int>(level) << " byte " << b;
+                    EXPECT_EQ(HeaderScanner::findFieldValueEnd(data.data(), data.size()),
+                              isFieldValueChar(b) ? length : position) << "level " << static_cast<int>(level) << " byte " << b;
+                }
+            }
+        }
+    }
+}
+
+// 测试扫描到第一个非法字节即停止，并且不越过给定长度
+TEST_F(HeaderScannerTest, StopsAtFirstDelimiterWithinBounds) {
+    std::string line = "X-Request-Id: 4bf92f3577b34da6a3ce929d0e0e4736 and more text to cross a block\r\n";
+    for (HeaderScanner::Level level : supportedLevels()) {
+        HeaderScanner::setLevel(level);
+        EXPECT_EQ(HeaderScanner::findTokenEnd(line.data(), line.size()), line.find(':'));
+        EXPECT_EQ(HeaderScanner::findFieldValueEnd(line.data(), line.size()), line.find('\r'));
+        EXPECT_EQ(HeaderScanner::findFieldValueEnd(line.data(), line.find('\r')), line.find('\r'));
+        EXPECT_EQ(HeaderScanner::findTargetEnd(line.data(), 0), 0u);
+    }
+}
+
+} // namespace webserver
@@ -0,0 +1,77 @@
+#include "http/HttpHeaders.hpp"
+#include "http/HttpMethod.hpp"
+#include "http/HttpResponse.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace webserver {
+
+// 测试所有常用头部都能按任意大小写查到，其他名称不会误判
+TEST(HttpHeadersTest, LookupWellKnownHeaders) {
+    for (size_t i = 1; i < static_cast<size_t>(HttpHeader::COUNT); ++i) {
+        auto header = static_cast<HttpHeader>(i);
+        std::string name(httpHeaderName(header));
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        EXPECT_EQ(lookupHttpHeader(name), header) << name;
+        EXPECT_EQ(lookupHttpHeader(lower), header) << lower;
+    }
+    EXPECT_EQ(lookupHttpHeader(""), HttpHeader::UNKNOWN);
+    EXPECT_EQ(lookupHttpHeader("X-Custom"), HttpHeader::UNKNOWN);
+    EXPECT_EQ(lookupHttpHeader("Content-Lengths"), HttpHeader::UNKNOWN);
+    EXPECT_EQ(lookupHttpHeader("Hosts"), HttpHeader::UNKNOWN);
+}
+
+// 测试容器按出现顺序保存，查找不区分大小写
+TEST(HttpHeadersTest, CaseInsensitiveFlatStorage) {
+    HttpHeaders headers;
+    headers.add("Host", "example.com");
+    headers.add("X-Trace", "1");
+    headers.add("connection", "keep-alive");
+    headers.add("x-trace", "2");
+
+    EXPECT_EQ(headers.size(), 4u);
+    EXPECT_EQ(headers.get(HttpHeader::CONNECTION), "keep-alive");
+    EXPECT_EQ(headers.get("CONNECTION"), "keep-alive");
+    EXPECT_EQ(headers.get("X-TRACE"), "1");
+    EXPECT_EQ(headers.find("Missing"), nullptr);
+    EXPECT_TRUE(headers.get("Missing").empty());
+    EXPECT_EQ(headers.begin()->name, "Host");
+
+    // set替换第一个同名头部并删除其余的
+    headers.set("X-Trace", "3");
+    EXPECT_EQ(headers.size(), 3u);
+    EXPECT_EQ(headers.get("x-trace"), "3");
+
+    EXPECT_EQ(headers.erase("HOST"), 1u);
+    EXPECT_FALSE(headers.contains(HttpHeader::HOST));
+    EXPECT_EQ(headers.get(HttpHeader::CONNECTION), "keep-alive");
+}
+
+// 测试响应头不区分大小写地替换
+TEST(HttpHeadersTest, ResponseSetHeaderReplacesCaseInsensitively) {
+    HttpResponse response(HttpStatus::OK, std::string("body"), "text/plain");
+    response.setHeader("content-type", "application/json");
+    EXPECT_EQ(response.getHeader(HttpHeader::CONTENT_TYPE), "application/json");
+    EXPECT_EQ(response.getHeaders().size(), 2u);
+
+    std::string head = response.buildHead(true);
+    EXPECT_EQ(head.find("Content-Length"), std::string::npos);
+}
+
+// 测试请求方法解析区分大小写
+TEST(HttpHeadersTest, ParseHttpMethod) {
+    const HttpMethod methods[] = {HttpMethod::GET, HttpMethod::HEAD, HttpMethod::POST, HttpMethod::PUT,
+                                  HttpMethod::DELETE, HttpMethod::OPTIONS, HttpMethod::PATCH,
+                                  HttpMethod::TRACE, HttpMethod::CONNECT};
+    for (HttpMethod method : methods) {
+        EXPECT_EQ(parseHttpMethod(httpMethodName(method)), method);
+    }
+    EXPECT_EQ(parseHttpMethod("get"), HttpMethod::UNKNOWN);
+    EXPECT_EQ(parseHttpMethod("INVALID"), HttpMethod::UNKNOWN);
+    EXPECT_EQ(parseHttpMethod(""), HttpMethod::UNKNOWN);
+}
+
+} // namespace webserver
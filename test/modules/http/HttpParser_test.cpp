@@ -95,6 +95,23 @@ TEST_F(HttpParserTest, BuildResponseWithCustomHeaders) {
     EXPECT_EQ(actual, expected);
 }
 
+// 测试响应头与内容分开构建，内容可以不经复制取走
+TEST_F(HttpParserTest, BuildHeadSeparatelyFromContent) {
+    HttpResponse response(HttpStatus::OK, std::string("Hello World!"), "text/plain");
+    response.setHeader("Connection", "close");
+
+    std::string head = response.buildHead();
+    EXPECT_EQ(head + response.getContent(), response.build());
+    EXPECT_EQ(head.substr(head.size() - 4), "\r\n\r\n");
+
+    std::string chunkedHead = response.buildHead(true);
+    EXPECT_EQ(chunkedHead.find("Content-Length"), std::string::npos);
+    EXPECT_NE(chunkedHead.find("Transfer-Encoding: chunked\r\n"), std::string::npos);
+
+    EXPECT_EQ(response.takeContent(), "Hello World!");
+    EXPECT_TRUE(response.getContent().empty());
+}
+
 // 测试超大头部处理
 TEST_F(HttpParserTest, ParseRequestWithLargeHeaders) {
     std::string request = 
@@ -119,6 +136,25 @@ TEST_F(HttpParserTest, ParseRequestWithLargeHeaders) {
     EXPECT_TRUE(body.empty());
 }
 
+// 测试分块编码的请求体
+TEST_F(HttpParserTest, ParseChunkedRequest) {
+    std::string request =
+        "POST /upload HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5;ext=1\r\nhello\r\n"
+        "6\r\n world\r\n"
+        "0\r\n"
+        "\r\n";
+
+    auto [method, path, headers, body] = HttpParser::parseRequest(request);
+    EXPECT_EQ(method, "POST");
+    EXPECT_EQ(body, "hello world");
+
+    EXPECT_THROW(HttpParser::parseRequest(request.substr(0, request.size() - 7)), std::invalid_argument);
+}
+
 // 测试无效HTTP方法
 TEST_F(HttpParserTest, ParseInvalidHttpMethod) {
     std::string request = 
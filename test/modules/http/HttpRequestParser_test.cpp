@@ -0,0 +1,310 @@
+#include "HttpRequestParser.hpp"
+#include "gtest/gtest.h"
+#include <string>
+
+namespace webserver {
+
+using Status = HttpRequestParser::Status;
+using Error = HttpRequestParser::Error;
+
+// 测试一次到达的完整请求
+TEST(HttpRequestParserTest, ParsesCompleteRequest) {
+    std::string data =
+        "GET /index.html?lang=en HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "X-Padded:   value with spaces  \r\n"
+        "\r\n";
+    HttpRequestParser parser;
+    ASSERT_EQ(parser.parse(data), Status::COMPLETE);
+
+    const RequestView& request = parser.request();
+    EXPECT_EQ(request.method, "GET");
+    EXPECT_EQ(request.target, "/index.html?lang=en");
+    EXPECT_EQ(request.path, "/index.html");
+    EXPECT_EQ(request.query, "lang=en");
+    EXPECT_EQ(request.versionMinor, 1);
+    ASSERT_EQ(request.headers.size(), 2u);
+    EXPECT_EQ(request.findHeader("host")->value, "example.com");
+    EXPECT_EQ(request.findHeader("X-PADDED")->value, "value with spaces");
+    EXPECT_EQ(request.findHeader("Missing"), nullptr);
+    EXPECT_TRUE(request.body.empty());
+    EXPECT_EQ(request.length, data.size());
+
+    // 请求头不复制，视图直接指向输入数据
+    EXPECT_EQ(request.method.data(), data.data());
+}
+
+// 测试持久连接的默认值：HTTP/1.1默认保持，HTTP/1.0默认关闭
+TEST(HttpRequestParserTest, DeterminesKeepAliveFromVersionAndOptions) {
+    auto keepAlive = [](const std::string& data) {
+        HttpRequestParser parser;
+        EXPECT_EQ(parser.parse(data), Status::COMPLETE);
+        return parser.request().keepAlive();
+    };
+    EXPECT_TRUE(keepAlive("GET / HTTP/1.1\r\nHost: a\r\n\r\n"));
+    EXPECT_FALSE(keepAlive("GET / HTTP/1.1\r\nHost: a\r\nConnection: Close\r\n\r\n"));
+    EXPECT_FALSE(keepAlive("GET / HTTP/1.1\r\nHost: a\r\nConnection: Upgrade ,close\r\n\r\n"));
+    EXPECT_TRUE(keepAlive("GET / HTTP/1.1\r\nHost: a\r\nConnection: closed\r\n\r\n"));
+    EXPECT_FALSE(keepAlive("GET / HTTP/1.0\r\n\r\n"));
+    EXPECT_TRUE(keepAlive("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"));
+}
+
+// 测试两个请求之间释放保留的容量
+TEST(HttpRequestParserTest, ReleasesMemoryBetweenRequests) {
+    std::string data = "GET / HTTP/1.1\r\nHost: a\r\n";
+    for (int i = 0; i < 20; ++i) {
+        data += "X-" + std::to_string(i) + ": v\r\n";
+    }
+    data += "\r\n";
+    HttpRequestParser parser;
+    ASSERT_EQ(parser.parse(data), Status::COMPLETE);
+    parser.reset();
+    EXPECT_GT(parser.memoryUsage(), 0u);
+    parser.releaseMemory();
+    EXPECT_EQ(parser.memoryUsage(), 0u);
+    EXPECT_EQ(parser.parse(data), Status::COMPLETE);
+    EXPECT_EQ(parser.request().headers.size(), 21u);
+}
+
+// 测试逐字节到达的请求，每个位置都能正确恢复
+TEST(HttpRequestParserTest, ResumesAcrossSplitReads) {
+    std::string data =
+        "POST /submit HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Content-Length: 11\r\n"
+        "\r\n"
+        "hello world";
+    size_t headerLength = data.find("\r\n\r\n") + 4;
+    HttpRequestParser parser;
+    for (size_t end = 1; end < data.size(); ++end) {
+        ASSERT_EQ(parser.parse(std::string_view(data).substr(0, end)), Status::INCOMPLETE) << end;
+        EXPECT_EQ(parser.headersComplete(), end >= headerLength) << end;
+    }
+    ASSERT_EQ(parser.parse(data), Status::COMPLETE);
+    EXPECT_EQ(parser.request().method, "POST");
+    EXPECT_EQ(parser.request().body, "hello world");
+}
+
+// 测试流水线请求：每个请求只消费自己的字节
+TEST(HttpRequestParserTest, SeparatesPipelinedRequests) {
+    std::string data =
+        "GET /a HTTP/1.1\r\nHost: h\r\n\r\n"
+        "POST /b HTTP/1.1\r\nHost: h\r\nContent-Length: 3\r\n\r\nabc"
+        "GET /c HTTP/1.0\r\n\r\n";
+    HttpRequestParser parser;
+    std::string_view remaining(data);
+    const char* expected[] = {"/a", "/b", "/c"};
+    for (const char* path : expected) {
+        ASSERT_EQ(parser.parse(remaining), Status::COMPLETE);
+        EXPECT_EQ(parser.request().path, path);
+        remaining.remove_prefix(parser.request().length);
+        parser.reset();
+    }
+    EXPECT_TRUE(remaining.empty());
+}
+
+// 测试分块编码的请求体，块扩展被跳过，尾部字段单独保存
+TEST(HttpRequestParserTest, DecodesChunkedBody) {
+    std::string data =
+        "POST /upload HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5;name=value\r\nhello\r\n"
+        "6\r\n world\r\n"
+        "0\r\n"
+        "X-Trailer: done\r\n"
+        "\r\n";
+    HttpRequestParser parser;
+    for (size_t end = 1; end < data.size(); ++end) {
+        ASSERT_EQ(parser.parse(std::string_view(data).substr(0, end)), Status::INCOMPLETE) << end;
+    }
+    ASSERT_EQ(parser.parse(data), Status::COMPLETE);
+    EXPECT_EQ(parser.request().body, "hello world");
+    EXPECT_EQ(parser.request().length, data.size());
+    ASSERT_EQ(parser.request().trailers.size(), 1u);
+    EXPECT_EQ(parser.request().trailers[0].name, "X-Trailer");
+    EXPECT_EQ(parser.request().trailers[0].value, "done");
+    EXPECT_EQ(parser.request().findHeader("X-Trailer"), nullptr);
+}
+
+// 测试设置BodyHandler后请求体随到随交出，不在解析器中缓存
+TEST(HttpRequestParserTest, StreamsBodyToHandler) {
+    std::string chunked =
+        "POST /upload HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nhello\r\n"
+        "6\r\n world\r\n"
+        "0\r\n\r\n";
+    size_t headerEnd = chunked.find("\r\n\r\n") + 4;
+
+    // 请求头解析完之后才设置，之前已经解码的数据先交出
+    HttpRequestParser parser;
+    std::string received;
+    size_t calls = 0;
+    ASSERT_EQ(parser.parse(std::string_view(chunked).substr(0, headerEnd + 6)), Status::INCOMPLETE);
+    ASSERT_TRUE(parser.headersComplete());
+    ASSERT_TRUE(parser.setBodyHandler([&](std::string_view data) {
+        received.append(data.data(), data.size());
+        ++calls;
+        return true;
+    }));
+    EXPECT_EQ(received, "hel");
+    for (size_t end = headerEnd + 7; end < chunked.size(); ++end) {
+        ASSERT_EQ(parser.parse(std::string_view(chunked).substr(0, end)), Status::INCOMPLETE) << end;
+    }
+    ASSERT_EQ(parser.parse(chunked), Status::COMPLETE);
+    EXPECT_EQ(received, "hello world");
+    EXPECT_GT(calls, 2u);
+    EXPECT_TRUE(parser.request().body.empty());
+
+    // Content-Length请求体同样逐段交出
+    std::string fixed = "PUT /f HTTP/1.1\r\nHost: h\r\nContent-Length: 10\r\n\r\n0123456789";
+    parser.reset();
+    received.clear();
+    ASSERT_EQ(parser.parse(std::string_view(fixed).substr(0, fixed.size() - 6)), Status::INCOMPLETE);
+    parser.setBodyHandler([&](std::string_view data) {
+        received.append(data.data(), data.size());
+        return true;
+    });
+    ASSERT_EQ(parser.parse(std::string_view(fixed).substr(0, fixed.size() - 3)), Status::INCOMPLETE);
+    EXPECT_EQ(received, "0123456");
+    ASSERT_EQ(parser.parse(fixed), Status::COMPLETE);
+    EXPECT_EQ(received, "0123456789");
+    EXPECT_EQ(parser.request().length, fixed.size());
+
+    // handler拒绝数据时解析失败
+    parser.reset();
+    parser.setBodyHandler([](std::string_view) { return false; });
+    ASSERT_EQ(parser.parse(fixed), Status::ERROR);
+    EXPECT_EQ(parser.error(), Error::BODY_HANDLER_FAILED);
+    EXPECT_EQ(parser.errorStatus(), HttpStatus::INTERNAL_SERVER_ERROR);
+}
+
+// 测试请求头之后暂停，调整上限并丢弃已交出的请求体后缓冲区保持很小
+TEST(HttpRequestParserTest, DiscardsDeliveredBodyFromBuffer) {
+    HttpRequestParser::Limits limits;
+    limits.maxBodySize = 16;
+    limits.pauseAfterHeaders = true;
+    HttpRequestParser parser(limits);
+
+    std::string head = "PUT /upload?x=1 HTTP/1.1\r\nHost: h\r\nContent-Length: 1000\r\n\r\n";
+    std::string buffer = head + "0123";
+    ASSERT_EQ(parser.parse(buffer), Status::HEADERS_COMPLETE);
+    EXPECT_EQ(parser.request().path, "/upload");
+    EXPECT_TRUE(parser.request().body.empty());
+    EXPECT_EQ(parser.contentLength(), 1000u);
+    EXPECT_FALSE(parser.chunked());
+
+    parser.setMaxBodySize(1000);
+    size_t received = 0;
+    parser.setBodyHandler([&](std::string_view data) {
+        received += data.size();
+        return true;
+    });
+    std::string sent = "0123";
+    while (sent.size() < 1000) {
+        ASSERT_EQ(parser.parse(buffer), Status::INCOMPLETE);
+        parser.discardDeliveredBody(buffer);
+        EXPECT_EQ(buffer, head);
+        std::string piece(std::min<size_t>(64, 1000 - sent.size()), 'x');
+        buffer += piece;
+        sent += piece;
+    }
+    size_t requestLength = buffer.size();
+    buffer += "GET";
+    ASSERT_EQ(parser.parse(buffer), Status::COMPLETE);
+    EXPECT_EQ(received, 1000u);
+    EXPECT_EQ(parser.request().length, requestLength);
+    EXPECT_EQ(parser.request().path, "/upload");
+
+    // reset()恢复Limits中的上限
+    parser.reset();
+    ASSERT_EQ(parser.parse(head), Status::HEADERS_COMPLETE);
+    ASSERT_EQ(parser.parse(head), Status::ERROR);
+    EXPECT_EQ(parser.error(), Error::BODY_TOO_LARGE);
+}
+
+// 测试请求行之前的空行被忽略
+TEST(HttpRequestParserTest, SkipsLeadingEmptyLines) {
+    HttpRequestParser parser;
+    ASSERT_EQ(parser.parse("\r\n\r\nGET / HTTP/1.0\r\n\r\n"), Status::COMPLETE);
+    EXPECT_EQ(parser.request().method, "GET");
+    EXPECT_EQ(parser.request().versionMinor, 0);
+}
+
+namespace {
+Error parseError(const std::string& data, const HttpRequestParser::Limits& limits = HttpRequestParser::Limits()) {
+    HttpRequestParser parser(limits);
+    Status status = parser.parse(data);
+    return status == Status::ERROR ? parser.error() : Error::NONE;
+}
+} // namespace
+
+// 测试各种非法请求
+TEST(HttpRequestParserTest, RejectsMalformedRequests) {
+    EXPECT_EQ(parseError("INVALID /path HTTP/1.1\r\nHost: h\r\n\r\n"), Error::BAD_METHOD);
+    EXPECT_EQ(parseError("GET /path\r\nHost: h\r\n\r\n"), Error::BAD_REQUEST_LINE);
+    EXPECT_EQ(parseError("GET /path HTTP/2.0\r\nHost: h\r\n\r\n"), Error::BAD_VERSION);
+    EXPECT_EQ(parseError("GET /path HTTP/1.1\r\n\r\n"), Error::MISSING_HOST);
+    EXPECT_EQ(parseError("GET / HTTP/1.1\r\nHost : h\r\n\r\n"), Error::BAD_HEADER);
+    EXPECT_EQ(parseError("GET / HTTP/1.1\r\nHost: h\r\n folded\r\n\r\n"), Error::BAD_HEADER);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nContent-Length: -1\r\n\r\n"), Error::BAD_CONTENT_LENGTH);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n"),
+              Error::BAD_CONTENT_LENGTH);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nContent-Length: 1\r\n"
+                         "Transfer-Encoding: chunked\r\n\r\n"), Error::BAD_CONTENT_LENGTH);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: gzip\r\n\r\n"),
+              Error::BAD_TRANSFER_ENCODING);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n"),
+              Error::BAD_CHUNK);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabc\r\n"),
+              Error::BAD_CHUNK);
+}
+
+// 测试大小限制及对应的状态码
+// 测试请求行的长度上限独立于请求头总大小
+TEST(HttpRequestParserTest, LimitsRequestLineSeparately) {
+    HttpRequestParser::Limits limits;
+    limits.maxRequestLineBytes = 64;
+    HttpRequestParser parser(limits);
+
+    // 请求行尚未结束就已经超限
+    std::string data = "GET /" + std::string(100, 'a');
+    EXPECT_EQ(parser.parse(data), Status::ERROR);
+    EXPECT_EQ(parser.error(), Error::URI_TOO_LONG);
+    EXPECT_EQ(parser.errorStatus(), HttpStatus::URI_TOO_LONG);
+
+    // 请求头不受请求行上限影响
+    parser.reset();
+    data = "GET /short HTTP/1.1\r\nHost: a\r\nX-Long: " + std::string(200, 'b') + "\r\n\r\n";
+    EXPECT_EQ(parser.parse(data), Status::COMPLETE);
+}
+
+TEST(HttpRequestParserTest, EnforcesLimits) {
+    HttpRequestParser::Limits limits;
+    limits.maxHeaderBytes = 64;
+    limits.maxHeaders = 2;
+    limits.maxBodySize = 4;
+
+    HttpRequestParser parser(limits);
+    ASSERT_EQ(parser.parse("GET /" + std::string(100, 'a')), Status::ERROR);
+    EXPECT_EQ(parser.error(), Error::URI_TOO_LONG);
+    EXPECT_EQ(parser.errorStatus(), HttpStatus::URI_TOO_LONG);
+
+    parser.reset();
+    ASSERT_EQ(parser.parse("GET / HTTP/1.1\r\nHost: h\r\nX-Long: " + std::string(100, 'a')), Status::ERROR);
+    EXPECT_EQ(parser.errorStatus(), HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE);
+
+    EXPECT_EQ(parseError("GET / HTTP/1.1\r\nHost: h\r\nA: 1\r\nB: 2\r\n\r\n", limits), Error::HEADER_TOO_LARGE);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nContent-Length: 5\r\n\r\n", limits), Error::BODY_TOO_LARGE);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\n",
+                         limits), Error::BODY_TOO_LARGE);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n"
+                         "A: 1\r\nB: 2\r\nC: 3\r\n\r\n", limits), Error::HEADER_TOO_LARGE);
+    EXPECT_EQ(parseError("POST / HTTP/1.1\r\nHost: h\r\nContent-Length: 4\r\n\r\nabcd", limits), Error::NONE);
+}
+
+} // namespace webserver
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "http/HttpServer.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace webserver;
+
+namespace {
+
+int connectTo(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        ASSERT_GT(n, 0);
+        sent += static_cast<size_t>(n);
+    }
+}
+
+// 读到服务器关闭连接为止
+std::string readUntilClose(int fd) {
+    std::string data;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    return data;
+}
+
+// 按出现顺序提取所有响应体（响应体就是请求路径，不含换行）
+std::vector<std::string> responseBodies(const std::string& data) {
+    std::vector<std::string> bodies;
+    size_t pos = 0;
+    while ((pos = data.find("\r\n\r\n", pos)) != std::string::npos) {
+        pos += 4;
+        size_t end = data.find("HTTP/1.1", pos);
+        bodies.push_back(data.substr(pos, end == std::string::npos ? std::string::npos : end - pos));
+    }
+    return bodies;
+}
+
+int threadCount() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+    return -1;
+}
+
+HttpResponse echoPath(const HttpRequest& request) {
+    // 路径中带slow的请求处理得更慢，使后面的请求先完成
+    if (request.getPath().find("slow") != std::string::npos) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    return HttpResponse(HttpStatus::OK, request.getPath(), "text/plain");
+}
+
+} // namespace
+
+TEST(HttpServerTest, PipelinedResponsesKeepRequestOrder) {
+    HttpServer server(0, echoPath, 4);
+    server.start();
+
+    int fd = connectTo(server.port());
+    ASSERT_GE(fd, 0);
+    std::string requests;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 40; ++i) {
+        std::string path = (i % 5 == 0 ? "/slow/" : "/fast/") + std::to_string(i);
+        requests += "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        expected.push_back(path);
+    }
+    sendAll(fd, requests);
+    shutdown(fd, SHUT_WR);
+
+    // 客户端关闭写方向后，服务器发完所有响应就关闭连接，不会等待固定时间
+    auto start = std::chrono::steady_clock::now();
+    std::string data = readUntilClose(fd);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    close(fd);
+
+    EXPECT_EQ(responseBodies(data), expected);
+    EXPECT_LT(elapsed, std::chrono::seconds(3));
+    server.stop();
+}
+
+TEST(HttpServerTest, ConnectionCloseEndsConnectionAfterResponse) {
+    HttpServer server(0, echoPath, 2);
+    server.start();
+
+    int fd = connectTo(server.port());
+    ASSERT_GE(fd, 0);
+    sendAll(fd, "GET /first HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                "GET /last HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+                "GET /ignored HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string data = readUntilClose(fd);
+    close(fd);
+
+    EXPECT_EQ(responseBodies(data), (std::vector<std::string>{"/first", "/last"}));
+    EXPECT_NE(data.find("Connection: close"), std::string::npos);
+    server.stop();
+}
+
+TEST(HttpServerTest, ClosingResponseAdvertisesConnectionClose) {
+    HttpServer server(0, echoPath, 2);
+    server.start();
+
+    // close出现在令牌列表中同样结束连接，响应必须告知客户端
+    int fd = connectTo(server.port());
+    ASSERT_GE(fd, 0);
+    sendAll(fd, "GET /upgrade HTTP/1.1\r\nHost: localhost\r\nConnection: Upgrade, close\r\n\r\n");
+    std::string data = readUntilClose(fd);
+    close(fd);
+    EXPECT_EQ(responseBodies(data), (std::vector<std::string>{"/upgrade"}));
+    EXPECT_NE(data.find("Connection: close"), std::string::npos);
+
+    // HTTP/1.0默认不保持连接
+    fd = connectTo(server.port());
+    ASSERT_GE(fd, 0);
+    sendAll(fd, "GET /legacy HTTP/1.0\r\nHost: localhost\r\n\r\n");
+    data = readUntilClose(fd);
+    close(fd);
+    EXPECT_EQ(responseBodies(data), (std::vector<std::string>{"/legacy"}));
+    EXPECT_NE(data.find("Connection: close"), std::string::npos);
+    server.stop();
+}
+
+TEST(HttpServerTest, MalformedRequestIsAnsweredAfterEarlierResponses) {
+    HttpServer server(0, echoPath, 2);
+    server.start();
+
+    int fd = connectTo(server.port());
+    ASSERT_GE(fd, 0);
+    sendAll(fd, "GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\nBROKEN\r\n\r\n");
+    std::string data = readUntilClose(fd);
+    close(fd);
+
+    size_t ok = data.find("HTTP/1.1 200");
+    size_t bad = data.find("HTTP/1.1 400");
+    ASSERT_NE(ok, std::string::npos);
+    ASSERT_NE(bad, std::string::npos);
+    EXPECT_LT(ok, bad);
+    server.stop();
+}
+
+TEST(HttpServerTest, ConnectionsDoNotCreateThreads) {
+    HttpServer server(0, echoPath, 2);
+    server.start();
+    int baseline = threadCount();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 32; ++i) {
+        int fd = connectTo(server.port());
+        ASSERT_GE(fd, 0);
+        sendAll(fd, "GET /fast HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        clients.push_back(fd);
+    }
+    for (int fd : clients) {
+        char buffer[512];
+        EXPECT_GT(recv(fd, buffer, sizeof(buffer), 0), 0);
+    }
+    EXPECT_EQ(server.connectionCount(), clients.size());
+    EXPECT_EQ(threadCount(), baseline);
+
+    for (int fd : clients) {
+        close(fd);
+    }
+    // 客户端关闭后连接随即释放
+    for (int i = 0; i < 100 && server.connectionCount() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(server.connectionCount(), 0u);
+    server.stop();
+}
+
+TEST(HttpServerTest, ClientThatStopsReadingIsNotBufferedWithoutLimit) {
+    std::atomic<int> handled{0};
+    const std::string body(16 * 1024, 'x');
+    HttpServer server(0, [&](const HttpRequest&) {
+        handled++;
+        return HttpResponse(HttpStatus::OK, body, "text/plain");
+    }, 2);
+    server.start();
+
+    int fd = connectTo(server.port());
+    ASSERT_GE(fd, 0);
+    const int requestCount = 4000;
+    std::string requests;
+    for (int i = 0; i < requestCount; ++i) {
+        requests += "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+    sendAll(fd, requests);
+
+    // 客户端不读取响应：套接字缓冲区填满后服务器停止处理，直到处理数不再增长
+    int previous = -1;
+    for (int i = 0; i < 50 && handled.load() != previous; ++i) {
+        previous = handled.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_LT(handled.load(), requestCount / 2);
+
+    // 客户端开始读取后服务器恢复处理，所有请求都得到响应
+    shutdown(fd, SHUT_WR);
+    std::string data = readUntilClose(fd);
+    close(fd);
+
+    int responses = 0;
+    for (size_t pos = 0; (pos = data.find("HTTP/1.1 200", pos)) != std::string::npos; pos++) {
+        responses++;
+    }
+    EXPECT_EQ(responses, requestCount);
+    EXPECT_EQ(handled.load(), requestCount);
+    server.stop();
+}
@@ -0,0 +1,55 @@
+#include "SpooledBody.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace webserver {
+
+// 测试未超过阈值时请求体留在内存中
+TEST(SpooledBodyTest, SmallBodyStaysInMemory) {
+    SpooledBody body(16);
+    ASSERT_TRUE(body.append("hello "));
+    ASSERT_TRUE(body.append("world"));
+    EXPECT_TRUE(body.inMemory());
+    EXPECT_EQ(body.fd(), -1);
+    EXPECT_EQ(body.size(), 11u);
+    EXPECT_EQ(body.data(), "hello world");
+}
+
+// 测试超过阈值后转存到匿名临时文件，通过fd和映射读取的内容一致
+TEST(SpooledBodyTest, LargeBodySpillsToAnonymousFile) {
+    SpooledBody body(8);
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        std::string piece = std::to_string(i) + ",";
+        ASSERT_TRUE(body.append(piece));
+        expected += piece;
+    }
+    ASSERT_FALSE(body.inMemory());
+    ASSERT_GE(body.fd(), 0);
+    EXPECT_EQ(body.size(), expected.size());
+
+    struct stat info{};
+    ASSERT_EQ(fstat(body.fd(), &info), 0);
+    EXPECT_EQ(static_cast<size_t>(info.st_size), expected.size());
+    EXPECT_EQ(info.st_nlink, 0u);
+
+    EXPECT_EQ(body.data(), expected);
+    // 映射之后继续追加，再次获取时重新映射
+    ASSERT_TRUE(body.append("end"));
+    EXPECT_EQ(body.data(), expected + "end");
+
+    char first[4] = {};
+    ASSERT_EQ(pread(body.fd(), first, 3, 0), 3);
+    EXPECT_EQ(std::string(first), "0,1");
+}
+
+// 测试目录不可用时报告失败
+TEST(SpooledBodyTest, ReportsTempFileFailure) {
+    SpooledBody body(0, "/nonexistent-directory");
+    EXPECT_FALSE(body.append("data"));
+    EXPECT_TRUE(body.append(""));
+}
+
+} // namespace webserver
@@ -0,0 +1,312 @@
+#include "StaticFileHandler.hpp"
+#include "OpenFileCache.hpp"
+#include "utils/DateTimeUtils.hpp"
+#include "gtest/gtest.h"
+#include <cerrno>
+#include <ctime>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace webserver {
+
+class StaticFileHandlerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char pattern[] = "/tmp/static_test_XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        root = pattern;
+        writeFile("index.html", "<html>index</html>");
+        writeFile("app.js", "console.log(1);");
+        mkdir((root + "/docs").c_str(), 0755);
+        writeFile("docs/index.html", "docs");
+    }
+
+    void TearDown() override {
+        std::string command = "rm -rf " + root;
+        ASSERT_EQ(std::system(command.c_str()), 0);
+    }
+
+    void writeFile(const std::string& name, const std::string& content) const {
+        std::ofstream file(root + "/" + name, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+
+    // 关闭内存内容缓存，结果总是通过文件描述符返回
+    static StaticFileOptions sendfileOnly() {
+        StaticFileOptions options;
+        options.memoryCacheBytes = 0;
+        return options;
+    }
+
+    std::string root;
+    HttpHeaders noHeaders;
+};
+
+// 测试GET返回文件描述符和元数据
+TEST_F(StaticFileHandlerTest, ServesRegularFile) {
+    StaticFileHandler handler("/static", root, sendfileOnly());
+    ASSERT_TRUE(handler.matches("/static/app.js"));
+
+    StaticFileHandler::Result result = handler.handle("GET", "/static/app.js", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::OK);
+    EXPECT_EQ(result.headers["Content-Type"], "application/javascript");
+    EXPECT_EQ(result.headers["Content-Length"], "15");
+    EXPECT_FALSE(result.headers["Last-Modified"].empty());
+    EXPECT_EQ(result.headers["ETag"].front(), '"');
+    EXPECT_EQ(result.cached, nullptr);
+    ASSERT_NE(result.file, nullptr);
+    EXPECT_GE(result.file->fd, 0);
+    EXPECT_EQ(result.file->size, 15);
+}
+
+// 测试前缀匹配不会误匹配相似路径
+TEST_F(StaticFileHandlerTest, PrefixMatchesOnSegmentBoundary) {
+    StaticFileHandler handler("/static/", root);
+    EXPECT_TRUE(handler.matches("/static"));
+    EXPECT_TRUE(handler.matches("/static/a/b"));
+    EXPECT_FALSE(handler.matches("/staticfoo"));
+    EXPECT_FALSE(handler.matches("/"));
+}
+
+// 测试目录回退到index.html
+TEST_F(StaticFileHandlerTest, DirectoryServesIndex) {
+    StaticFileHandler handler("/static", root, sendfileOnly());
+
+    StaticFileHandler::Result result = handler.handle("GET", "/static/", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::OK);
+    EXPECT_EQ(result.headers["Content-Length"], "18");
+
+    result = handler.handle("GET", "/static/docs", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::OK);
+    EXPECT_EQ(result.headers["Content-Length"], "4");
+}
+
+// 测试HEAD只返回响应头
+TEST_F(StaticFileHandlerTest, HeadOmitsFile) {
+    StaticFileHandler handler("/static", root);
+    StaticFileHandler::Result result = handler.handle("HEAD", "/static/app.js", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::OK);
+    EXPECT_EQ(result.headers["Content-Length"], "15");
+    EXPECT_EQ(result.file, nullptr);
+}
+
+// 测试不支持的方法、缺失文件和路径穿越
+TEST_F(StaticFileHandlerTest, RejectsInvalidRequests) {
+    StaticFileHandler handler("/static", root);
+
+    StaticFileHandler::Result result = handler.handle("POST", "/static/app.js", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::METHOD_NOT_ALLOWED);
+    EXPECT_EQ(result.headers["Allow"], "GET, HEAD");
+
+    result = handler.handle("GET", "/static/missing.txt", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::NOT_FOUND);
+    EXPECT_EQ(result.headers["Content-Length"], std::to_string(result.body.size()));
+
+    EXPECT_EQ(handler.handle("GET", "/static/../etc/passwd", noHeaders).status, HttpStatus::BAD_REQUEST);
+    EXPECT_EQ(handler.handle("GET", "/static/%2e%2e/etc/passwd", noHeaders).status, HttpStatus::BAD_REQUEST);
+    EXPECT_EQ(handler.handle("GET", "/static/app.js%00", noHeaders).status, HttpStatus::BAD_REQUEST);
+    EXPECT_EQ(handler.handle("GET", "/static/app%2", noHeaders).status, HttpStatus::BAD_REQUEST);
+}
+
+// 测试百分号编码和查询字符串
+TEST_F(StaticFileHandlerTest, DecodesPathAndIgnoresQuery) {
+    writeFile("a b.txt", "space");
+    StaticFileHandler handler("/static", root, sendfileOnly());
+
+    StaticFileHandler::Result result = handler.handle("GET", "/static/a%20b.txt?v=1", noHeaders);
+    EXPECT_EQ(result.status, HttpStatus::OK);
+    EXPECT_EQ(result.headers["Content-Type"], "text/plain");
+    EXPECT_EQ(result.headers["Content-Length"], "5");
+}
+
+// 测试If-Modified-Since条件请求
+TEST_F(StaticFileHandlerTest, ConditionalRequestReturnsNotModified) {
+    StaticFileHandler handler("/static", root, sendfileOnly());
+    StaticFileHandler::Result result = handler.handle("GET", "/static/app.js", noHeaders);
+    HttpHeaders headers;
+    headers.add("If-Modified-Since", result.headers["Last-Modified"]);
+
+    result = handler.handle("GET", "/static/app.js", headers);
+    EXPECT_EQ(result.status, HttpStatus::NOT_MODIFIED);
+    EXPECT_EQ(result.file, nullptr);
+
+    headers.set("If-Modified-Since", DateTimeUtils::formatHttpDate(1000000000));
+    result = handler.handle("GET", "/static/app.js", headers);
+    EXPECT_EQ(result.status, HttpStatus::OK);
+}
+
+// 测试If-None-Match条件请求，且优先于If-Modified-Since
+TEST_F(StaticFileHandlerTest, EntityTagRequestReturnsNotModified) {
+    StaticFileHandler handler("/static", root);
+    StaticFileHandler::Result result = handler.handle("HEAD", "/static/app.js", noHeaders);
+    std::string etag = result.headers["ETag"];
+    ASSERT_FALSE(etag.empty());
+
+    HttpHeaders headers;
+    headers.add("If-None-Match", "\"other\", W/" + etag);
+    EXPECT_EQ(handler.handle("GET", "/static/app.js", headers).status, HttpStatus::NOT_MODIFIED);
+    // 第二次命中内存缓存，条件请求同样生效
+    result = handler.handle("GET", "/static/app.js", headers);
+    EXPECT_EQ(result.status, HttpStatus::NOT_MODIFIED);
+    EXPECT_EQ(result.headers["ETag"], etag);
+
+    headers.clear();
+    headers.add("If-None-Match", "\"other\"");
+    headers.add("If-Modified-Since", DateTimeUtils::formatHttpDate(time(nullptr)));
+    result = handler.handle("GET", "/static/app.js", headers);
+    EXPECT_NE(result.cached, nullptr);
+}
+
+// 测试小文件进入内存缓存，响应头预先序列化
+TEST_F(StaticFileHandlerTest, SmallFileServedFromMemory) {
+    StaticFileHandler handler("/static", root);
+
+    StaticFileHandler::Result first = handler.handle("GET", "/static/app.js", noHeaders);
+    ASSERT_NE(first.cached, nullptr);
+    EXPECT_EQ(first.file, nullptr);
+    EXPECT_EQ(first.cached->body, "console.log(1);");
+    const std::string& keepAlive = first.cached->headers[1];
+    EXPECT_EQ(keepAlive.compare(0, 17, "HTTP/1.1 200 OK\r\n"), 0);
+    EXPECT_NE(keepAlive.find("Content-Length: 15\r\n"), std::string::npos);
+    EXPECT_NE(keepAlive.find("Content-Type: application/javascript\r\n"), std::string::npos);
+    EXPECT_NE(keepAlive.find("ETag: " + first.cached->etag + "\r\n"), std::string::npos);
+    EXPECT_NE(keepAlive.find("Connection: keep-alive\r\n"), std::string::npos);
+    EXPECT_NE(first.cached->headers[0].find("Connection: close\r\n"), std::string::npos);
+    EXPECT_EQ(keepAlive.substr(keepAlive.size() - 4), "\r\n\r\n");
+
+    StaticFileHandler::Result second = handler.handle("GET", "/static/app.js", noHeaders);
+    EXPECT_EQ(second.cached, first.cached);
+
+    // HEAD不使用内存缓存
+    EXPECT_EQ(handler.handle("HEAD", "/static/app.js", noHeaders).cached, nullptr);
+
+    ContentCache::Stats stats = handler.getContentCacheStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+// 测试超过大小上限的文件不进入内存缓存
+TEST_F(StaticFileHandlerTest, LargeFileBypassesMemory) {
+    writeFile("large.txt", std::string(2048, 'x'));
+    StaticFileOptions options;
+    options.memoryCacheMaxFileSize = 1024;
+    StaticFileHandler handler("/static", root, options);
+
+    StaticFileHandler::Result result = handler.handle("GET", "/static/large.txt", noHeaders);
+    EXPECT_EQ(result.cached, nullptr);
+    ASSERT_NE(result.file, nullptr);
+    EXPECT_EQ(result.file->size, 2048);
+}
+
+// 测试文件被修改后由inotify使缓存项失效
+TEST_F(StaticFileHandlerTest, MemoryCacheInvalidatedByFileChange) {
+    StaticFileHandler handler("/static", root);
+    ASSERT_NE(handler.fileEventFd(), -1);
+    ASSERT_NE(handler.handle("GET", "/static/app.js", noHeaders).cached, nullptr);
+
+    writeFile("app.js", "console.log(333);");
+    handler.processFileEvents();
+
+    StaticFileHandler::Result result = handler.handle("GET", "/static/app.js", noHeaders);
+    ASSERT_NE(result.cached, nullptr);
+    EXPECT_EQ(result.cached->body, "console.log(333);");
+    EXPECT_GE(handler.getContentCacheStats().invalidations, 1u);
+
+    // 删除后返回404
+    ASSERT_EQ(unlink((root + "/app.js").c_str()), 0);
+    handler.processFileEvents();
+    EXPECT_EQ(handler.handle("GET", "/static/app.js", noHeaders).status, HttpStatus::NOT_FOUND);
+}
+
+// 测试内存缓存按总字节数淘汰
+TEST_F(StaticFileHandlerTest, ContentCacheEvictsLeastRecentlyUsed) {
+    ContentCache cache(1000, 1000);
+    ASSERT_TRUE(cache.enabled());
+
+    auto makeResponse = [this](const std::string& name) {
+        auto response = std::make_shared<CachedResponse>();
+        response->path = root + "/" + name;
+        response->body = std::string(400, 'x');
+        return response;
+    };
+    uint64_t generation = 0;
+    ASSERT_TRUE(cache.watch(root + "/a", generation));
+    cache.insert(makeResponse("a"), generation);
+    cache.insert(makeResponse("b"), generation);
+    EXPECT_NE(cache.find(root + "/a"), nullptr);
+    cache.insert(makeResponse("c"), generation);
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.bytes(), 800u);
+    EXPECT_EQ(cache.find(root + "/b"), nullptr);
+    EXPECT_NE(cache.find(root + "/c"), nullptr);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+
+    // 读取期间处理过文件变化事件时不缓存
+    writeFile("d", "d");
+    cache.processEvents();
+    cache.insert(makeResponse("d"), generation);
+    EXPECT_EQ(cache.find(root + "/d"), nullptr);
+}
+
+// 测试Content-Type映射
+TEST_F(StaticFileHandlerTest, ContentTypeByExtension) {
+    EXPECT_EQ(StaticFileHandler::contentTypeFor("/a/b.HTML"), "text/html");
+    EXPECT_EQ(StaticFileHandler::contentTypeFor("/a/b.png"), "image/png");
+    EXPECT_EQ(StaticFileHandler::contentTypeFor("/a.d/b"), "application/octet-stream");
+    EXPECT_EQ(StaticFileHandler::contentTypeFor("/a/b.unknown"), "application/octet-stream");
+}
+
+// 测试打开文件缓存的命中、淘汰和统计
+TEST_F(StaticFileHandlerTest, OpenFileCacheHitsAndEvicts) {
+    OpenFileCache cache(2, std::chrono::milliseconds(60000), 0);
+    int error = 0;
+
+    auto first = cache.acquire(root + "/index.html", error);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(cache.acquire(root + "/index.html", error), first);
+    cache.acquire(root + "/app.js", error);
+    cache.acquire(root + "/docs/index.html", error);
+
+    OpenFileCache::Stats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(cache.size(), 2u);
+
+    // 被淘汰的文件仍由持有者保持打开
+    char c;
+    EXPECT_EQ(pread(first->fd, &c, 1, 0), 1);
+
+    EXPECT_EQ(cache.acquire(root + "/docs", error), nullptr);
+    EXPECT_EQ(error, EISDIR);
+    EXPECT_EQ(cache.acquire(root + "/missing", error), nullptr);
+    EXPECT_EQ(error, ENOENT);
+}
+
+// 测试文件被替换后重新校验
+TEST_F(StaticFileHandlerTest, OpenFileCacheRevalidatesChangedFile) {
+    OpenFileCache cache(4, std::chrono::milliseconds(0), 0);
+    int error = 0;
+
+    auto before = cache.acquire(root + "/app.js", error);
+    ASSERT_NE(before, nullptr);
+    EXPECT_EQ(cache.acquire(root + "/app.js", error), before);
+
+    // 通过rename替换文件，inode发生变化
+    writeFile("app.js.new", "console.log(22);");
+    ASSERT_EQ(rename((root + "/app.js.new").c_str(), (root + "/app.js").c_str()), 0);
+
+    auto after = cache.acquire(root + "/app.js", error);
+    ASSERT_NE(after, nullptr);
+    EXPECT_NE(after, before);
+    EXPECT_EQ(after->size, 16);
+    EXPECT_EQ(cache.getStats().misses, 2u);
+}
+
+} // namespace webserver
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "SpscQueue.hpp"
+#include <memory>
+#include <thread>
+
+using namespace webserver;
+
+TEST(SpscQueueTest, RoundsCapacityUpAndRejectsWhenFull) {
+    SpscQueue<int> queue(5);
+    EXPECT_EQ(queue.capacity(), 8u);
+
+    for (int i = 0; i < 8; ++i) {
+        int value = i;
+        EXPECT_TRUE(queue.tryPush(value));
+    }
+    int extra = 100;
+    EXPECT_FALSE(queue.tryPush(extra));
+    EXPECT_EQ(extra, 100);
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(SpscQueueTest, MoveOnlyElementIsKeptWhenFull) {
+    SpscQueue<std::unique_ptr<int>> queue(2);
+    auto first = std::make_unique<int>(1);
+    auto second = std::make_unique<int>(2);
+    auto third = std::make_unique<int>(3);
+    EXPECT_TRUE(queue.tryPush(first));
+    EXPECT_TRUE(queue.tryPush(second));
+    EXPECT_FALSE(queue.tryPush(third));
+    ASSERT_NE(third, nullptr);
+    EXPECT_EQ(*third, 3);
+}
+
+TEST(SpscQueueTest, TransfersInOrderBetweenThreads) {
+    constexpr int kCount = 200000;
+    SpscQueue<int> queue(64);
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < kCount; ++i) {
+            int value = i;
+            while (!queue.tryPush(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < kCount) {
+        int value;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(value, expected);
+        expected++;
+    }
+    producer.join();
+}